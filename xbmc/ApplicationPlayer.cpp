@@ -24,6 +24,7 @@
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "cores/VideoPlayer/VideoPlayer.h"
 #include "guilib/GUIComponent.h"
+#include "guilib/GUITexture.h"
 #include "guilib/GUIWindowManager.h"
 #include "cores/DataCacheCore.h"
 #include "Application.h"
@@ -831,7 +832,11 @@ void CApplicationPlayer::Render(bool clear, uint32_t alpha, bool gui)
 {
   std::shared_ptr<IPlayer> player = GetInternal();
   if (player)
+  {
+    // the video renderers draw directly, GUI quads queued so far have to go first
+    CGUITexture::FlushBatch();
     player->Render(clear, alpha, gui);
+  }
 }
 
 void CApplicationPlayer::FlushRenderer()
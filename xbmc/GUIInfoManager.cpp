@@ -151,7 +151,6 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_playerShowTime = false;
   m_playerShowInfo = false;
   m_fps = 0.0f;
-  m_refreshCounter = 0;
   ResetLibraryBools();
 }
 
@@ -2184,6 +2183,9 @@ const infomap player_process[] =
   { "videofps", PLAYER_PROCESS_VIDEOFPS },
   { "videodar", PLAYER_PROCESS_VIDEODAR },
   { "videohwdecoder", PLAYER_PROCESS_VIDEOHWDECODER },
+  { "videodecoderthreads", PLAYER_PROCESS_VIDEODECODERTHREADS },
+  { "videodecodetime", PLAYER_PROCESS_VIDEODECODETIME },
+  { "videodecoderload", PLAYER_PROCESS_VIDEODECODERLOAD },
   { "audiodecoder", PLAYER_PROCESS_AUDIODECODER },
   { "audiochannels", PLAYER_PROCESS_AUDIOCHANNELS },
   { "audiosamplerate", PLAYER_PROCESS_AUDIOSAMPLERATE },
@@ -6314,6 +6316,18 @@ std::string CGUIInfoManager::GetLabel(int info, int contextWindow, std::string *
   case PLAYER_PROCESS_VIDEOHEIGHT:
       strLabel = StringUtils::FormatNumber(CServiceBroker::GetDataCacheCore().GetVideoHeight());
       break;
+  case PLAYER_PROCESS_VIDEODECODERTHREADS:
+      if (CServiceBroker::GetDataCacheCore().GetVideoDecoderThreads() > 0)
+        strLabel = StringUtils::FormatNumber(CServiceBroker::GetDataCacheCore().GetVideoDecoderThreads());
+      break;
+  case PLAYER_PROCESS_VIDEODECODETIME:
+      if (CServiceBroker::GetDataCacheCore().GetVideoDecoderThreads() > 0)
+        strLabel = StringUtils::Format("%.2f", CServiceBroker::GetDataCacheCore().GetVideoDecodeTime());
+      break;
+  case PLAYER_PROCESS_VIDEODECODERLOAD:
+      if (CServiceBroker::GetDataCacheCore().GetVideoDecoderThreads() > 0)
+        strLabel = StringUtils::Format("%.0f", CServiceBroker::GetDataCacheCore().GetVideoDecoderLoad() * 100);
+      break;
   case PLAYER_PROCESS_AUDIODECODER:
       strLabel = CServiceBroker::GetDataCacheCore().GetAudioDecoderName();
       break;
@@ -6891,9 +6905,9 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   std::pair<INFOBOOLTYPE::iterator, bool> res;
 
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refresh));
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refresh));
 
   if (res.second)
     res.first->get()->Initialize();
@@ -10568,8 +10582,120 @@ void CGUIInfoManager::ResetCache()
   // reset any animation triggers as well
   m_containerMoves.clear();
   // mark our infobools as dirty
+  InvalidateCache(INFO::DEPENDENCY_ALL);
+}
+
+void CGUIInfoManager::ResetFrameCache()
+{
+  // reset any animation triggers as well
+  m_containerMoves.clear();
+
+  unsigned int dependencies = INFO::DEPENDENCY_VOLATILE;
+
+  CApplicationPlayer &player = g_application.GetAppPlayer();
+  unsigned int playerState = 0;
+  if (player.IsPlaying())
+  {
+    float speed = player.GetPlaySpeed();
+    playerState = 0x01 |
+                  (player.IsPlayingAudio() ? 0x02 : 0) |
+                  (player.IsPlayingVideo() ? 0x04 : 0) |
+                  (player.IsPlayingGame() ? 0x08 : 0) |
+                  (player.IsPausedPlayback() ? 0x10 : 0) |
+                  (player.CanPause() ? 0x20 : 0) |
+                  (player.CanSeek() ? 0x40 : 0) |
+                  (static_cast<unsigned int>(static_cast<int>(speed * 100) & 0xffff) << 8);
+  }
+  if (playerState != m_playerState)
+  {
+    m_playerState = playerState;
+    dependencies |= INFO::DEPENDENCY_PLAYER;
+  }
+
+  time_t minute = time(nullptr) / 60;
+  if (minute != m_lastMinute)
+  {
+    m_lastMinute = minute;
+    dependencies |= INFO::DEPENDENCY_TIME;
+  }
+
+  CSingleLock lock(m_critInfo);
+  m_lastEvaluations = m_refresh.GetEvaluations();
+  m_refresh.ResetEvaluations();
+  m_refresh.Invalidate(dependencies);
+}
+
+void CGUIInfoManager::InvalidateCache(unsigned int dependencies)
+{
   CSingleLock lock(m_critInfo);
-  ++m_refreshCounter;
+  m_refresh.Invalidate(dependencies);
+}
+
+unsigned int CGUIInfoManager::GetDependencies(int condition, bool listItemDependent) const
+{
+  // the focused item can change any time
+  if (listItemDependent)
+    return INFO::DEPENDENCY_VOLATILE;
+
+  condition = abs(condition);
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    switch (abs(m_multiInfo[condition - MULTI_INFO_START].m_info))
+    {
+      case SKIN_BOOL:
+      case SKIN_STRING:
+      case SKIN_HAS_THEME:
+        return INFO::DEPENDENCY_SKIN;
+      case LIBRARY_HAS_ROLE:
+        return INFO::DEPENDENCY_LIBRARY;
+      case SYSTEM_TIME:
+      case SYSTEM_DATE:
+        return INFO::DEPENDENCY_TIME;
+      default:
+        return INFO::DEPENDENCY_VOLATILE;
+    }
+  }
+
+  if (condition >= LIBRARY_HAS_MUSIC && condition <= LIBRARY_HAS_COMPILATIONS)
+    return INFO::DEPENDENCY_LIBRARY;
+
+  if (condition >= PLAYER_REWINDING_2x && condition <= PLAYER_FORWARDING_32x)
+    return INFO::DEPENDENCY_PLAYER;
+
+  switch (condition)
+  {
+    case 0:
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+    case SYSTEM_PLATFORM_LINUX:
+    case SYSTEM_PLATFORM_WINDOWS:
+    case SYSTEM_PLATFORM_WIN10:
+    case SYSTEM_PLATFORM_DARWIN:
+    case SYSTEM_PLATFORM_DARWIN_OSX:
+    case SYSTEM_PLATFORM_DARWIN_IOS:
+    case SYSTEM_PLATFORM_ANDROID:
+    case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+      return INFO::DEPENDENCY_NONE;
+    case PLAYER_HAS_MEDIA:
+    case PLAYER_HAS_AUDIO:
+    case PLAYER_HAS_VIDEO:
+    case PLAYER_HAS_GAME:
+    case PLAYER_PLAYING:
+    case PLAYER_PAUSED:
+    case PLAYER_REWINDING:
+    case PLAYER_FORWARDING:
+    case PLAYER_CAN_PAUSE:
+    case PLAYER_CAN_SEEK:
+      return INFO::DEPENDENCY_PLAYER;
+    default:
+      return INFO::DEPENDENCY_VOLATILE;
+  }
+}
+
+size_t CGUIInfoManager::GetInfoBoolCount()
+{
+  CSingleLock lock(m_critInfo);
+  return m_bools.size();
 }
 
 std::string CGUIInfoManager::GetPictureLabel(int info)
@@ -10737,8 +10863,9 @@ void CGUIInfoManager::SetLibraryBool(int condition, bool value)
       m_libraryHasCompilations = value ? 1 : 0;
       break;
     default:
-      break;
+      return;
   }
+  InvalidateCache(INFO::DEPENDENCY_LIBRARY);
 }
 
 void CGUIInfoManager::ResetLibraryBools()
@@ -10751,6 +10878,7 @@ void CGUIInfoManager::ResetLibraryBools()
   m_libraryHasSingles = -1;
   m_libraryHasCompilations = -1;
   m_libraryRoleCounts.clear();
+  InvalidateCache(INFO::DEPENDENCY_LIBRARY);
 }
 
 bool CGUIInfoManager::GetLibraryBool(int condition)
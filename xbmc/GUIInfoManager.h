@@ -169,7 +169,34 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
+  /*! \brief Mark all info bools dirty
+   Used when an unknown amount of state changed, e.g. a window was (re)loaded
+   */
   void ResetCache();
+
+  /*! \brief Mark info bools dirty that need refreshing every frame
+   Info bools depending on event driven state only are refreshed once that changed,
+   the player state and clock are polled here.
+   */
+  void ResetFrameCache();
+
+  /*! \brief Mark info bools with any of the given dependencies dirty
+   \param dependencies mask of INFO::InfoDependency values
+   */
+  void InvalidateCache(unsigned int dependencies);
+
+  /*! \brief Get the data a condition depends on
+   \param condition the condition id, as returned from TranslateSingleString
+   \param listItemDependent whether the condition reads the focused list item
+   \return mask of INFO::InfoDependency values
+   */
+  unsigned int GetDependencies(int condition, bool listItemDependent) const;
+
+  /*! \brief Number of info bools evaluated during the last frame
+   */
+  unsigned int GetInfoBoolEvaluations() const { return m_lastEvaluations; }
+  size_t GetInfoBoolCount();
+
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   std::string GetItemLabel(const CFileItem *item, int info, std::string *fallback = NULL);
   std::string GetItemImage(const CFileItem *item, int info, std::string *fallback = NULL);
@@ -287,7 +314,10 @@ protected:
 
   typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
-  unsigned int m_refreshCounter;
+  INFO::InfoRefresh m_refresh;
+  unsigned int m_lastEvaluations = 0;
+  unsigned int m_playerState = 0;     // info bool relevant player state, polled every frame
+  time_t m_lastMinute = 0;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   int m_libraryHasMusic;
@@ -21,7 +21,9 @@
 #include "InfoScanner.h"
 #include "URL.h"
 #include "Util.h"
+#include "filesystem/ChangeJournal.h"
 #include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 
@@ -43,3 +45,28 @@ bool CInfoScanner::IsExcluded(const std::string& strDirectory, const std::vector
   }
   return false;
 }
+
+void CInfoScanner::WatchPaths(const std::set<std::string>& paths)
+{
+  if (g_advancedSettings.m_useChangeJournal)
+    m_journalPosition = XFILE::CChangeJournal::GetInstance().Watch(paths);
+}
+
+bool CInfoScanner::IsUnchanged(const std::string& strDirectory) const
+{
+  if (!g_advancedSettings.m_useChangeJournal)
+    return false;
+  return XFILE::CChangeJournal::GetInstance().IsUnchanged(strDirectory);
+}
+
+void CInfoScanner::MarkScanned(const std::string& strDirectory)
+{
+  if (g_advancedSettings.m_useChangeJournal)
+    XFILE::CChangeJournal::GetInstance().MarkScanned(strDirectory, m_journalPosition);
+}
+
+void CInfoScanner::MarkChanged(const std::string& strDirectory)
+{
+  if (g_advancedSettings.m_useChangeJournal)
+    XFILE::CChangeJournal::GetInstance().MarkDirty(strDirectory);
+}
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <set>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -78,12 +79,48 @@ protected:
   //! \brief Protected constructor to only allow subclass instances.
   CInfoScanner() = default;
 
+  /*! \brief Throughput of a stage of a scan, logged at the end of a scan
+   */
+  struct StageStats
+  {
+    unsigned int items = 0;
+    unsigned int millis = 0;
+
+    void Add(unsigned int count, unsigned int elapsed) { items += count; millis += elapsed; }
+    float GetRate() const { return millis ? items * 1000.0f / millis : 0.0f; }
+  };
+
+  /*! \brief Start recording the changes below the given folders in the change journal
+   Only done if enabled with <usechangejournal>. Folders that can't be watched, e.g.
+   network shares, are left to hashing.
+   \param paths folders about to be scanned
+   */
+  void WatchPaths(const std::set<std::string>& paths);
+
+  /*! \brief Check if nothing below a folder changed since it was last scanned
+   \param strDirectory folder to check
+   \return true if the change journal vouches for the folder, false if it needs to be hashed
+   */
+  bool IsUnchanged(const std::string& strDirectory) const;
+
+  /*! \brief Record that a folder and everything below it was scanned
+   \param strDirectory folder that was scanned since WatchPaths() was called
+   */
+  void MarkScanned(const std::string& strDirectory);
+
+  /*! \brief Have a folder hashed again on the next scan
+   Used for folders that get (re)scanned, as adding their items may have failed.
+   \param strDirectory folder to hash on the next scan
+   */
+  void MarkChanged(const std::string& strDirectory);
+
   std::set<std::string> m_pathsToScan; //!< Set of paths to scan
   bool m_showDialog = false; //!< Whether or not to show progress bar dialog
   CGUIDialogProgressBarHandle* m_handle = nullptr; //!< Progress bar handle
   bool m_bRunning = false; //!< Whether or not scanner is running
   bool m_bCanInterrupt = false; //!< Whether or not scanner is currently interruptable
   bool m_bClean = false; //!< Whether or not to perform cleaning during scanning
+  uint64_t m_journalPosition = 0; //!< Position of the change journal when the scan started
 
 private:
   bool HasNoMedia(const std::string& strDirectory) const;
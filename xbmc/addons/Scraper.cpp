@@ -229,6 +229,12 @@ void CScraper::ClearCache()
     CDirectory::Create(strCachePath);
 
   strCachePath = URIUtils::AddFileToFolder(strCachePath, ID());
+  if (!m_cacheFolder.empty())
+  {
+    if (!CDirectory::Exists(strCachePath))
+      CDirectory::Create(strCachePath);
+    strCachePath = URIUtils::AddFileToFolder(strCachePath, m_cacheFolder);
+  }
   URIUtils::AddSlashAtEnd(strCachePath);
 
   if (CDirectory::Exists(strCachePath))
@@ -237,6 +243,10 @@ void CScraper::ClearCache()
     CDirectory::GetDirectory(strCachePath, items);
     for (int i = 0; i < items.Size(); ++i)
     {
+      // the folders of other instances are cleared by those
+      if (items[i]->m_bIsFolder)
+        continue;
+
       // wipe cache
       if (items[i]->m_dateTime + m_persistence <= CDateTime::GetCurrentDateTime())
         CFile::Delete(items[i]->GetPath());
@@ -246,6 +256,13 @@ void CScraper::ClearCache()
     CDirectory::Create(strCachePath);
 }
 
+std::string CScraper::GetCacheContext() const
+{
+  if (m_cacheFolder.empty())
+    return ID();
+  return URIUtils::AddFileToFolder(ID(), m_cacheFolder);
+}
+
 // returns a vector of strings: the first is the XML output by the function; the rest
 // is XML output by chained functions, possibly recursively
 // the CCurlFile object is passed in so that URL fetches can be canceled from other threads
@@ -345,7 +362,7 @@ std::string CScraper::InternalRun(const std::string &function,
   size_t i;
   for (i = 0; i < scrURL.m_url.size(); ++i)
   {
-    if (!CScraperUrl::Get(scrURL.m_url[i], m_parser.m_param[i], http, ID()) ||
+    if (!CScraperUrl::Get(scrURL.m_url[i], m_parser.m_param[i], http, GetCacheContext()) ||
         m_parser.m_param[i].empty())
       return "";
   }
@@ -116,6 +116,13 @@ public:
    */
   void ClearCache();
 
+  /*! \brief Cache the results of this instance in a subfolder of the scraper's cache folder
+   Instances running concurrently need their own folders so they don't read each other's
+   partially written files.
+   \param folder name of the subfolder, empty for the scraper's cache folder itself
+   */
+  void SetCacheFolder(const std::string &folder) { m_cacheFolder = folder; }
+
   CONTENT_TYPE Content() const { return m_pathContent; }
   bool RequiresSettings() const { return m_requiressettings; }
   bool Supports(const CONTENT_TYPE &content) const;
@@ -176,6 +183,7 @@ private:
                          const CScraperUrl& url,
                          XFILE::CCurlFile& http,
                          const std::vector<std::string>* extras);
+  std::string GetCacheContext() const;
 
   bool m_fLoaded;
   bool m_isPython = false;
@@ -183,6 +191,7 @@ private:
   CDateTimeSpan m_persistence;
   CONTENT_TYPE m_pathContent;
   CScraperParser m_parser;
+  std::string m_cacheFolder;
 };
 
 }
@@ -120,6 +120,11 @@ namespace addon
     /// @ingroup cpp_kodi_addon_audiodecoder
     /// @brief Produce some noise
     ///
+    /// The buffer points directly into the player's sample buffer, decode
+    /// straight into it instead of into a buffer of your own to avoid a copy.
+    /// The buffer is only valid during the call, size varies between calls
+    /// but is always a multiple of the frame size.
+    ///
     /// @param[in] buffer               Output buffer
     /// @param[in] size                 Size of output buffer
     /// @param[out] actualsize          Actual number of bytes written to output buffer
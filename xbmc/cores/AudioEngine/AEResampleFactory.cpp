@@ -20,9 +20,10 @@
 
 #include "AEResampleFactory.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleFFMPEG.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResamplePolyphase.h"
+#include "ServiceBroker.h"
+#include "settings/Settings.h"
 #if defined(TARGET_RASPBERRY_PI)
-  #include "ServiceBroker.h"
-  #include "settings/Settings.h"
   #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResamplePi.h"
 #endif
 
@@ -31,8 +32,14 @@ namespace ActiveAE
 
 IAEResample *CAEResampleFactory::Create(uint32_t flags /* = 0 */)
 {
+  if (flags & AERESAMPLEFACTORY_QUICK_RESAMPLE)
+    return new CActiveAEResampleFFMPEG();
+
+  int quality = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_AUDIOOUTPUT_PROCESSQUALITY);
+  if (quality == AE_QUALITY_REALLYHIGH)
+    return new CActiveAEResamplePolyphase();
 #if defined(TARGET_RASPBERRY_PI)
-  if (!(flags & AERESAMPLEFACTORY_QUICK_RESAMPLE) && CServiceBroker::GetSettings().GetInt(CSettings::SETTING_AUDIOOUTPUT_PROCESSQUALITY) == AE_QUALITY_GPU)
+  if (quality == AE_QUALITY_GPU)
     return new CActiveAEResamplePi();
 #endif
   return new CActiveAEResampleFFMPEG();
@@ -27,17 +27,26 @@ using namespace ActiveAE;
 #include "ActiveAEStream.h"
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Encoders/AEEncoderFFmpeg.h"
 
+#include "cores/DataCacheCore.h"
 #include "settings/Settings.h"
 #include "windowing/WinSystem.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
 #define MAX_BUFFER_TIME 0.1   // max time of a buffer in seconds
+#define STATS_INTERVAL  1000  // ms between publishing engine stats
+
+static int64_t ElapsedMicroseconds(int64_t start)
+{
+  return (CurrentHostCounter() - start) * 1000000 / CurrentHostFrequency();
+}
 
 void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 {
@@ -262,6 +271,68 @@ bool CEngineStats::HasDSP()
   return m_hasDSP;
 }
 
+void CEngineStats::AddStageTime(AEStage stage, int64_t us)
+{
+  CSingleLock lock(m_lock);
+  m_stageTimes[stage].Add(us);
+}
+
+void CEngineStats::AddStageTimes(CAELatencyHistogram (&times)[AE_STAGE_MAX])
+{
+  // idle cycles have nothing to add and don't need the lock
+  bool empty = true;
+  for (int i = 0; i < AE_STAGE_MAX && empty; i++)
+    empty = times[i].GetCount() == 0;
+  if (empty)
+    return;
+
+  CSingleLock lock(m_lock);
+  for (int i = 0; i < AE_STAGE_MAX; i++)
+  {
+    if (times[i].GetCount())
+    {
+      m_stageTimes[i].Merge(times[i]);
+      times[i] = CAELatencyHistogram();
+    }
+  }
+}
+
+void CEngineStats::AddUnderrun(bool sink)
+{
+  CSingleLock lock(m_lock);
+  if (sink)
+    m_sinkUnderruns++;
+  else
+    m_streamUnderruns++;
+}
+
+void CEngineStats::GetLatencyStats(AELatencyStats& stats)
+{
+  CSingleLock lock(m_lock);
+  for (int i = 0; i < AE_STAGE_MAX; i++)
+    stats.stages[i] = m_stageTimes[i];
+  if (m_pcmOutput)
+    stats.engineBufferedTime = (double)m_bufferedSamples / m_sinkSampleRate * 1000;
+  else
+    stats.engineBufferedTime = (double)m_bufferedSamples * m_sinkFormat.m_streamInfo.GetDuration();
+  stats.sinkDelay = m_sinkDelay.GetDelay() * 1000;
+  stats.sinkCacheTotal = m_sinkCacheTotal * 1000;
+  stats.streamUnderruns = m_streamUnderruns;
+  stats.sinkUnderruns = m_sinkUnderruns;
+
+  stats.streams.clear();
+  for (auto &str : m_streamStats)
+  {
+    AEStreamLatencyStats stream;
+    stream.id = str.m_streamId;
+    stream.bufferedTime = str.m_bufferedTime * 1000;
+    stream.syncError = str.m_syncError;
+    stream.resampleRatio = str.m_resampleRatio;
+    stream.syncState = str.m_syncState;
+    stats.streams.push_back(stream);
+  }
+}
+
 AEAudioFormat CEngineStats::GetCurrentSinkFormat()
 {
   CSingleLock lock(m_lock);
@@ -291,6 +362,7 @@ CActiveAE::CActiveAE() :
   m_aeGUISoundForce = false;
   m_stats.Reset(44100, true);
   m_streamIdGen = 0;
+  m_engineWakeups = 0;
 
   m_settingsHandler.reset(new CActiveAESettings(*this));
 }
@@ -754,16 +826,8 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
           return;
         case CActiveAEDataProtocol::STREAMSAMPLE:
           MsgStreamSample *msgData;
-          CSampleBuffer *samples;
           msgData = reinterpret_cast<MsgStreamSample*>(msg->data);
-          samples = msgData->stream->m_processingSamples.front();
-          msgData->stream->m_processingSamples.pop_front();
-          if (samples != msgData->buffer)
-            CLog::Log(LOGERROR, "CActiveAE - inconsistency in stream sample message");
-          if (msgData->buffer->pkt->nb_samples == 0)
-            msgData->buffer->Return();
-          else
-            msgData->stream->m_processingBuffers->m_inputSamples.push_back(msgData->buffer);
+          ReceiveStreamSample(msgData->stream, msgData->buffer);
           m_extTimeout = 0;
           m_state = AE_TOP_CONFIGURED_PLAY;
           return;
@@ -1032,6 +1096,10 @@ void CActiveAE::Process()
     }
     else if (!m_extDeferData)
     {
+      // samples handed over by streams, they bypass the message queues
+      if (ReceiveStreamSamples())
+        continue;
+
       // check data port
       if (m_dataPort.ReceiveOutMessage(&msg))
       {
@@ -1066,7 +1134,7 @@ void CActiveAE::Process()
     }
 
     // wait for message
-    else if (m_outMsgEvent.WaitMSec(m_extTimeout))
+    else if (WaitForWork(m_extTimeout))
     {
       m_extTimeout = timer.MillisLeft();
       continue;
@@ -1088,6 +1156,86 @@ void CActiveAE::Process()
   }
 }
 
+void CActiveAE::ReceiveStreamSample(CActiveAEStream *stream, CSampleBuffer *buffer)
+{
+  CSampleBuffer *samples = stream->m_processingSamples.front();
+  stream->m_processingSamples.pop_front();
+  if (samples != buffer)
+    CLog::Log(LOGERROR, "CActiveAE - inconsistency in stream sample message");
+  if (buffer->pkt->nb_samples == 0)
+    buffer->Return();
+  else
+    stream->m_processingBuffers->m_inputSamples.push_back(buffer);
+}
+
+bool CActiveAE::AcceptsStreamSamples()
+{
+  // same states which handle STREAMSAMPLE messages
+  if (m_extDeferData)
+    return false;
+  return m_state == AE_TOP_CONFIGURED ||
+         m_state == AE_TOP_CONFIGURED_SUSPEND ||
+         m_state == AE_TOP_CONFIGURED_IDLE ||
+         m_state == AE_TOP_CONFIGURED_PLAY;
+}
+
+bool CActiveAE::ReceiveStreamSamples()
+{
+  if (!AcceptsStreamSamples())
+    return false;
+
+  bool received = false;
+  for (auto stream : m_streams)
+  {
+    CSampleBuffer *buffer;
+    while (stream->m_readyBuffers.Pop(buffer))
+    {
+      ReceiveStreamSample(stream, buffer);
+      received = true;
+    }
+  }
+
+  if (received)
+  {
+    m_extTimeout = 0;
+    m_state = AE_TOP_CONFIGURED_PLAY;
+  }
+  return received;
+}
+
+bool CActiveAE::WaitForWork(int timeout)
+{
+  // streams only signal the event while we are waiting, check their queues
+  // once more after announcing it so that no sample gets stuck
+  m_engineWakeup.BeginWait();
+  bool ready = false;
+  if (AcceptsStreamSamples())
+  {
+    for (auto stream : m_streams)
+    {
+      if (!stream->m_readyBuffers.Empty())
+      {
+        ready = true;
+        break;
+      }
+    }
+  }
+
+  if (!ready)
+    ready = m_outMsgEvent.WaitMSec(timeout);
+  m_engineWakeup.EndWait();
+
+  if (ready)
+    m_engineWakeups++;
+  return ready;
+}
+
+void CActiveAE::WakeupEngine()
+{
+  if (m_engineWakeup.IsWaiting())
+    m_outMsgEvent.Set();
+}
+
 AEAudioFormat CActiveAE::GetInputFormat(AEAudioFormat *desiredFmt)
 {
   AEAudioFormat inputFormat;
@@ -1488,7 +1636,9 @@ void CActiveAE::DiscardStream(CActiveAEStream *stream)
         m_discardBufferPools.push_back((*it)->m_processingBuffers->GetAtempoBuffers());
       }
       delete (*it)->m_processingBuffers;
-      CLog::Log(LOGDEBUG, "CActiveAE::DiscardStream - audio stream deleted");
+      CLog::Log(LOGDEBUG, "CActiveAE::DiscardStream - audio stream deleted, "
+                          "longest AddData: %.1f ms, engine wakeups: %u",
+                          (*it)->GetMaxAddDataTime(), m_engineWakeups.exchange(0));
       m_stats.RemoveStream((*it)->m_id);
       delete (*it)->m_streamPort;
       delete (*it);
@@ -1510,11 +1660,13 @@ void CActiveAE::SFlushStream(CActiveAEStream *stream)
   }
   stream->m_processingBuffers->Flush();
   stream->m_streamPort->Purge();
+  // the stream waits for our reply, so neither queue is in use
+  stream->m_freeBuffers.Reset();
+  stream->m_readyBuffers.Reset();
   stream->m_bufferedTime = 0.0;
   stream->m_paused = false;
   stream->m_syncState = CAESyncInfo::AESyncState::SYNC_START;
   stream->m_syncError.Flush();
-  stream->ResetFreeBuffers();
 
   // flush the engine if we only have a single stream
   if (m_streams.size() == 1)
@@ -1865,13 +2017,26 @@ void CActiveAE::UnconfigureSink()
 bool CActiveAE::RunStages()
 {
   bool busy = false;
+  bool inputBusy = false;
+  int64_t inputStart = CurrentHostCounter();
+  int64_t resampleTime = 0;
 
   // serve input streams
   std::list<CActiveAEStream*>::iterator it;
   for (it = m_streams.begin(); it != m_streams.end(); ++it)
   {
     if ((*it)->m_processingBuffers && !(*it)->m_paused)
+    {
+      int64_t start = CurrentHostCounter();
       busy = (*it)->m_processingBuffers->ProcessBuffers();
+      if (busy)
+      {
+        int64_t us = ElapsedMicroseconds(start);
+        m_cycleStageTimes[AE_STAGE_RESAMPLE].Add(us);
+        resampleTime += us;
+        inputBusy = true;
+      }
+    }
 
     if ((*it)->m_streamIsBuffering &&
         (*it)->m_processingBuffers &&
@@ -1884,6 +2049,7 @@ bool CActiveAE::RunStages()
     // provide buffers to stream
     float time = m_stats.GetCacheTime((*it));
     CSampleBuffer *buffer;
+    bool handedOut = false;
     if (!(*it)->m_drain)
     {
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
@@ -1891,12 +2057,19 @@ bool CActiveAE::RunStages()
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
       while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
       {
+        if ((*it)->m_freeBuffers.Full())
+          break;
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
-        (*it)->m_streamPort->SendInMessage(CActiveAEDataProtocol::STREAMBUFFER, &buffer, sizeof(CSampleBuffer*));
-        (*it)->IncFreeBuffers();
+        (*it)->m_freeBuffers.Push(buffer);
+        handedOut = true;
         time += buftime;
       }
+      if (handedOut)
+      {
+        (*it)->WakeupProducer();
+        inputBusy = true;
+      }
     }
     else
     {
@@ -1928,6 +2101,9 @@ bool CActiveAE::RunStages()
     }
   }
 
+  if (inputBusy)
+    m_cycleStageTimes[AE_STAGE_INPUT].Add(ElapsedMicroseconds(inputStart) - resampleTime);
+
   if (m_stats.GetWaterLevel() < MAX_WATER_LEVEL &&
      (m_mode != MODE_TRANSCODE || (m_encoderBuffers && !m_encoderBuffers->m_freeSamples.empty())))
   {
@@ -1967,6 +2143,7 @@ bool CActiveAE::RunStages()
     // mix streams and sounds sounds
     if (m_mode != MODE_RAW)
     {
+      int64_t mixStart = CurrentHostCounter();
       CSampleBuffer *out = NULL;
       if (!m_sounds_playing.empty() && m_streams.empty())
       {
@@ -1993,10 +2170,21 @@ bool CActiveAE::RunStages()
           continue;
 
         if ((*it)->m_processingBuffers->m_outputSamples.empty())
+        {
           allStreamsReady = false;
+          // count each time a playing stream runs dry, not every pass
+          if (!(*it)->m_drain && !(*it)->m_streamIsBuffering && !(*it)->m_starved)
+          {
+            (*it)->m_starved = true;
+            m_stats.AddUnderrun(false);
+          }
+        }
+        else
+          (*it)->m_starved = false;
       }
 
       bool needClamp = false;
+      const CAEKernels::Table& kernels = CAEKernels::Get();
       for (it = m_streams.begin(); it != m_streams.end() && allStreamsReady; ++it)
       {
         if ((*it)->m_paused || !(*it)->m_processingBuffers)
@@ -2056,6 +2244,9 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
+            // gains per frame first, the limiter only looks at the frame
+            // it is called for, so applying them afterwards is equivalent
+            m_frameGains.resize(nb_loops);
             for(int i=0; i<nb_loops; i++)
             {
               if ((*it)->m_fadingSamples > 0)
@@ -2075,19 +2266,12 @@ bool CActiveAE::RunStages()
               float volume = (*it)->m_volume * (*it)->m_rgain;
               if(nb_loops > 1)
                 volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
+              m_frameGains[i] = volume;
+            }
 
-              for(int j=0; j<out->pkt->planes; j++)
-              {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
-              }
+            for(int j=0; j<out->pkt->planes; j++)
+            {
+              kernels.MulFrames((float*)out->pkt->data[j], m_frameGains.data(), nb_floats, nb_loops);
             }
           }
           else
@@ -2123,6 +2307,7 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
+            m_frameGains.resize(nb_loops);
             for(int i=0; i<nb_loops; i++)
             {
               if ((*it)->m_fadingSamples > 0)
@@ -2142,30 +2327,16 @@ bool CActiveAE::RunStages()
               float volume = (*it)->m_volume * (*it)->m_rgain;
               if(nb_loops > 1)
                 volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
+              m_frameGains[i] = volume;
+            }
 
-              for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
-              {
-                float *dst = (float*)out->pkt->data[j]+i*nb_floats;
-                float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
-              }
+            for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
+            {
+              float *dst = (float*)out->pkt->data[j];
+              float *src = (float*)mix->pkt->data[j];
+              kernels.MulAddFrames(dst, src, m_frameGains.data(), nb_floats, nb_loops);
+              if (!needClamp && kernels.PeakArray(dst, nb_floats * nb_loops) > 1.0f)
+                needClamp = true;
             }
             mix->Return();
           }
@@ -2179,7 +2350,7 @@ bool CActiveAE::RunStages()
         int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
         for(int i=0; i<out->pkt->planes; i++)
         {
-          CAEUtil::ClampArray((float*)out->pkt->data[i], nb_floats);
+          kernels.ClampArray((float*)out->pkt->data[i], nb_floats);
         }
       }
 
@@ -2242,9 +2413,11 @@ bool CActiveAE::RunStages()
         MixSounds(*(out->pkt));
         if (!m_sinkHasVolume || m_muted)
           Deamplify(*(out->pkt));
+        m_cycleStageTimes[AE_STAGE_MIX].Add(ElapsedMicroseconds(mixStart));
 
         if (m_mode == MODE_TRANSCODE && m_encoder)
         {
+          int64_t encodeStart = CurrentHostCounter();
           CSampleBuffer *buf = m_encoderBuffers->GetFreeBuffer();
           buf->pkt->nb_samples = m_encoder->Encode(out->pkt->data[0], out->pkt->planes*out->pkt->linesize,
                                                    buf->pkt->data[0], buf->pkt->planes*buf->pkt->linesize);
@@ -2255,6 +2428,7 @@ bool CActiveAE::RunStages()
 
           out->Return();
           out = buf;
+          m_cycleStageTimes[AE_STAGE_ENCODE].Add(ElapsedMicroseconds(encodeStart));
         }
         busy = true;
       }
@@ -2303,9 +2477,24 @@ bool CActiveAE::RunStages()
     busy = true;
   }
 
+  m_stats.AddStageTimes(m_cycleStageTimes);
+
+  if (m_statsTimer.IsTimePast())
+  {
+    PublishStats();
+    m_statsTimer.Set(STATS_INTERVAL);
+  }
+
   return busy;
 }
 
+void CActiveAE::PublishStats()
+{
+  AELatencyStats stats;
+  m_stats.GetLatencyStats(stats);
+  CServiceBroker::GetDataCacheCore().SetAudioEngineStats(stats);
+}
+
 bool CActiveAE::HasWork()
 {
   if (!m_sounds_playing.empty())
@@ -2543,12 +2732,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEKernels::Get().MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2573,13 +2757,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEKernels::Get().MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -2718,7 +2896,8 @@ bool CActiveAE::HasHDAudioChannelCount()
 
 bool CActiveAE::SupportsQualityLevel(enum AEQuality level)
 {
-  if (level == AE_QUALITY_LOW || level == AE_QUALITY_MID || level == AE_QUALITY_HIGH)
+  if (level == AE_QUALITY_LOW || level == AE_QUALITY_MID || level == AE_QUALITY_HIGH ||
+      level == AE_QUALITY_REALLYHIGH)
     return true;
 #if defined(TARGET_RASPBERRY_PI)
   if (level == AE_QUALITY_GPU)
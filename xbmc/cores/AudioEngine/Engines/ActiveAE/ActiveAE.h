@@ -19,16 +19,19 @@
  *
  */
 
+#include <atomic>
 #include <list>
 #include <string>
 #include <vector>
 
+#include "threads/SPSCQueue.h"
 #include "threads/Thread.h"
 
 #include "ActiveAESink.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Utils/AELatencyStats.h"
 
 #include "guilib/DispResource.h"
 #include <queue>
@@ -201,6 +204,11 @@ public:
   bool IsSuspended();
   bool HasDSP();
   AEAudioFormat GetCurrentSinkFormat();
+  void AddStageTime(AEStage stage, int64_t us);
+  /*! merge stage times gathered over a cycle and clear them, one lock for all stages */
+  void AddStageTimes(CAELatencyHistogram (&times)[AE_STAGE_MAX]);
+  void AddUnderrun(bool sink);
+  void GetLatencyStats(AELatencyStats& stats);
 protected:
   float m_sinkCacheTotal;
   float m_sinkLatency;
@@ -222,6 +230,9 @@ protected:
     CAESyncInfo::AESyncState m_syncState;
   };
   std::vector<StreamStats> m_streamStats;
+  CAELatencyHistogram m_stageTimes[AE_STAGE_MAX];
+  uint64_t m_streamUnderruns = 0;
+  uint64_t m_sinkUnderruns = 0;
 };
 
 class CActiveAE : public IAE, public IDispResource, private CThread
@@ -322,7 +333,13 @@ protected:
 
   bool RunStages();
   bool HasWork();
+  void ReceiveStreamSample(CActiveAEStream *stream, CSampleBuffer *buffer);
+  bool AcceptsStreamSamples();
+  bool ReceiveStreamSamples();
+  bool WaitForWork(int timeout);
+  void WakeupEngine();
   CSampleBuffer* SyncStream(CActiveAEStream *stream);
+  void PublishStats();
 
   void ResampleSounds();
   bool ResampleSound(CActiveAESound *sound);
@@ -333,6 +350,9 @@ protected:
 
   CEvent m_inMsgEvent;
   CEvent m_outMsgEvent;
+  CSPSCWakeup m_engineWakeup;
+  std::atomic_uint m_engineWakeups;
+  XbmcThreads::EndTime m_statsTimer;
   CActiveAEControlProtocol m_controlPort;
   CActiveAEDataProtocol m_dataPort;
   int m_state;
@@ -360,6 +380,7 @@ protected:
   AEAudioFormat m_inputFormat;
   AudioSettings m_settings;
   CEngineStats m_stats;
+  CAELatencyHistogram m_cycleStageTimes[AE_STAGE_MAX]; ///< engine thread only, merged into m_stats once per RunStages()
   IAEEncoder *m_encoder;
   std::string m_currDevice;
   std::unique_ptr<CActiveAESettings> m_settingsHandler;
@@ -375,6 +396,7 @@ protected:
   std::list<CActiveAEStream*> m_streams;
   std::list<CActiveAEBufferPool*> m_discardBufferPools;
   unsigned int m_streamIdGen;
+  std::vector<float> m_frameGains; // per frame volume of the stream being mixed
 
   // gui sounds
   struct SoundState
@@ -19,6 +19,7 @@
  */
 
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "ActiveAEResampleFFMPEG.h"
 #include "utils/log.h"
 
@@ -34,6 +35,7 @@ CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 {
   m_pContext = NULL;
   m_doesResample = false;
+  m_convertOnly = false;
 }
 
 CActiveAEResampleFFMPEG::~CActiveAEResampleFFMPEG()
@@ -175,9 +177,79 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
     CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Init - init resampler failed");
     return false;
   }
+
+  m_convertOnly = IsConvertOnly(remapLayout, force_resample);
   return true;
 }
 
+bool CActiveAEResampleFFMPEG::IsConvertOnly(CAEChannelInfo *remapLayout, bool force_resample)
+{
+  if (force_resample || m_doesResample || m_src_channels != m_dst_channels)
+    return false;
+
+  if (remapLayout)
+  {
+    for (int out = 0; out < m_dst_channels; out++)
+    {
+      for (int in = 0; in < AE_CH_MAX; in++)
+      {
+        if (m_rematrix[out][in] != (out == in ? 1.0 : 0.0))
+          return false;
+      }
+    }
+  }
+  else if (m_src_chan_layout != m_dst_chan_layout)
+    return false;
+
+  // the sample format is the only difference, swr_convert would do nothing
+  // but a scalar format conversion. Only handle the ones used by sinks and
+  // decoders, with the same planarity on both sides.
+  bool srcFloat = m_src_fmt == AV_SAMPLE_FMT_FLT || m_src_fmt == AV_SAMPLE_FMT_FLTP;
+  bool dstFloat = m_dst_fmt == AV_SAMPLE_FMT_FLT || m_dst_fmt == AV_SAMPLE_FMT_FLTP;
+  AVSampleFormat intFmt = srcFloat ? m_dst_fmt : m_src_fmt;
+  if (srcFloat == dstFloat ||
+      av_sample_fmt_is_planar(m_src_fmt) != av_sample_fmt_is_planar(m_dst_fmt))
+    return false;
+
+  switch (av_get_packed_sample_fmt(intFmt))
+  {
+  case AV_SAMPLE_FMT_S16:
+  case AV_SAMPLE_FMT_S32:
+    return true;
+  default:
+    return false;
+  }
+}
+
+int CActiveAEResampleFFMPEG::Convert(uint8_t **dst_buffer, uint8_t **src_buffer, int samples)
+{
+  const CAEKernels::Table& kernels = CAEKernels::Get();
+  int planes = av_sample_fmt_is_planar(m_dst_fmt) ? m_dst_channels : 1;
+  uint32_t count = samples * m_dst_channels / planes;
+
+  for (int i = 0; i < planes; i++)
+  {
+    switch (m_dst_fmt)
+    {
+    case AV_SAMPLE_FMT_S16:
+    case AV_SAMPLE_FMT_S16P:
+      kernels.FloatToS16((int16_t*)dst_buffer[i], (const float*)src_buffer[i], count);
+      break;
+    case AV_SAMPLE_FMT_S32:
+    case AV_SAMPLE_FMT_S32P:
+      kernels.FloatToS32((int32_t*)dst_buffer[i], (const float*)src_buffer[i], count);
+      break;
+    default:
+      if (m_src_fmt == AV_SAMPLE_FMT_S16 || m_src_fmt == AV_SAMPLE_FMT_S16P)
+        kernels.S16ToFloat((float*)dst_buffer[i], (const int16_t*)src_buffer[i], count);
+      else
+        kernels.S32ToFloat((float*)dst_buffer[i], (const int32_t*)src_buffer[i], count);
+      break;
+    }
+  }
+  return samples;
+}
+
 int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
 {
   int delta = 0;
@@ -198,7 +270,15 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
     }
   }
 
-  int ret = swr_convert(m_pContext, dst_buffer, dst_samples, (const uint8_t**)src_buffer, src_samples);
+  // swr would buffer what does not fit, from then on it has to do all the work
+  if (m_convertOnly && (m_doesResample || src_samples > dst_samples))
+    m_convertOnly = false;
+
+  int ret;
+  if (m_convertOnly)
+    ret = src_buffer ? Convert(dst_buffer, src_buffer, src_samples) : 0;
+  else
+    ret = swr_convert(m_pContext, dst_buffer, dst_samples, (const uint8_t**)src_buffer, src_samples);
   if (ret < 0)
   {
     CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - resample failed");
@@ -0,0 +1,404 @@
+/*
+ *      Copyright (C) 2010-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ActiveAEResamplePolyphase.h"
+#include "ActiveAEResampleFFMPEG.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+extern "C" {
+#include "libavutil/channel_layout.h"
+}
+
+#define MAX_BANK_SIZE    (4 * 1024 * 1024) // bytes of coefficients per filter bank
+#define MAX_CACHED_BANKS 8                 // unused banks kept for reconfigures
+
+using namespace ActiveAE;
+
+namespace
+{
+
+struct FilterParams
+{
+  double attenuation;   // stopband attenuation in dB
+  double passband;      // end of the passband relative to the nyquist frequency
+  unsigned int phases;  // phases before limiting the bank size
+};
+
+FilterParams GetFilterParams(AEQuality quality)
+{
+  switch (quality)
+  {
+  case AE_QUALITY_LOW:
+    return { 80.0, 0.80, 256 };
+  case AE_QUALITY_MID:
+    return { 100.0, 0.87, 512 };
+  case AE_QUALITY_HIGH:
+    return { 120.0, 0.91, 1024 };
+  default:
+    return { 140.0, 0.91, 2048 };
+  }
+}
+
+// modified bessel function of the first kind, order zero
+double BesselI0(double x)
+{
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 50 && term > sum * 1e-21; k++)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+int Gcd(int a, int b)
+{
+  while (b)
+  {
+    int t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+CCriticalSection bankSection;
+std::map<std::tuple<int, int, int>, std::shared_ptr<const CPolyphaseFilterBank>> bankCache;
+
+}
+
+CPolyphaseFilterBank::CPolyphaseFilterBank(double ratio, AEQuality quality)
+{
+  FilterParams params = GetFilterParams(quality);
+
+  // frequencies in cycles per input sample, when decimating the filter has
+  // to remove everything above the nyquist frequency of the output
+  double stop = 0.5 * std::min(1.0, ratio);
+  double pass = stop * params.passband;
+  double cutoff = (pass + stop) / 2.0;
+  double beta = 0.1102 * (params.attenuation - 8.7);
+
+  // kaiser's estimate of the filter length, rounded up to full vector lanes
+  m_taps = (unsigned int)ceil((params.attenuation - 7.95) / (14.36 * (stop - pass))) + 1;
+  m_taps = (m_taps + 7) & ~7;
+  m_phases = params.phases;
+  while (m_phases > 64 && (m_phases + 1) * m_taps * 2 * sizeof(float) > MAX_BANK_SIZE)
+    m_phases /= 2;
+  m_attenuation = params.attenuation;
+
+  m_coefs.resize((m_phases + 1) * m_taps);
+  m_deltas.resize((m_phases + 1) * m_taps);
+
+  // phase p is the filter for an output sample p / phases input samples
+  // after the center tap
+  double half = m_taps / 2.0;
+  int center = m_taps / 2 - 1;
+  double norm = BesselI0(beta);
+  std::vector<double> h(m_taps);
+  for (unsigned int p = 0; p <= m_phases; p++)
+  {
+    double frac = (double)p / m_phases;
+    double sum = 0.0;
+    for (unsigned int k = 0; k < m_taps; k++)
+    {
+      double t = (double)k - center - frac;
+      double x = t / half;
+      double window = BesselI0(beta * sqrt(std::max(0.0, 1.0 - x * x))) / norm;
+      double sinc = t == 0.0 ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+      h[k] = sinc * window;
+      sum += h[k];
+    }
+    // unity gain for every phase, otherwise the gain would be modulated
+    float *coefs = &m_coefs[p * m_taps];
+    for (unsigned int k = 0; k < m_taps; k++)
+      coefs[k] = (float)(h[k] / sum);
+  }
+
+  for (unsigned int p = 0; p < m_phases; p++)
+  {
+    for (unsigned int k = 0; k < m_taps; k++)
+      m_deltas[p * m_taps + k] = m_coefs[(p + 1) * m_taps + k] - m_coefs[p * m_taps + k];
+  }
+}
+
+std::shared_ptr<const CPolyphaseFilterBank> CPolyphaseFilterBank::Get(int src_rate, int dst_rate, AEQuality quality)
+{
+  // the filter only depends on the ratio when decimating, all other
+  // conversions share the same one
+  int num = 1;
+  int den = 1;
+  if (dst_rate < src_rate)
+  {
+    int gcd = Gcd(dst_rate, src_rate);
+    num = dst_rate / gcd;
+    den = src_rate / gcd;
+  }
+  auto key = std::make_tuple(num, den, static_cast<int>(quality));
+
+  CSingleLock lock(bankSection);
+  auto it = bankCache.find(key);
+  if (it != bankCache.end())
+    return it->second;
+
+  if (bankCache.size() >= MAX_CACHED_BANKS)
+  {
+    for (it = bankCache.begin(); it != bankCache.end();)
+    {
+      if (it->second.use_count() == 1)
+        it = bankCache.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  auto bank = std::make_shared<const CPolyphaseFilterBank>((double)num / den, quality);
+  bankCache[key] = bank;
+  CLog::Log(LOGDEBUG, "CPolyphaseFilterBank::Get - created bank for ratio %d/%d, %u taps, %u phases",
+            num, den, bank->Taps(), bank->Phases());
+  return bank;
+}
+
+CActiveAEResamplePolyphase::CActiveAEResamplePolyphase()
+{
+  m_src_rate = m_dst_rate = 0;
+  m_src_channels = m_dst_channels = 0;
+  m_src_fmt = m_dst_fmt = AV_SAMPLE_FMT_NONE;
+  m_step = 1.0;
+  m_position = 0.0;
+  m_flushed = false;
+}
+
+CActiveAEResamplePolyphase::~CActiveAEResamplePolyphase() = default;
+
+bool CActiveAEResamplePolyphase::Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, int dst_dither, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, int src_dither, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample)
+{
+  m_bypass.reset();
+  m_pre.reset();
+  m_post.reset();
+  m_src_rate = src_rate;
+  m_dst_rate = dst_rate;
+  m_src_channels = src_channels;
+  m_dst_channels = dst_channels;
+  m_src_fmt = src_fmt;
+  m_dst_fmt = dst_fmt;
+
+  if (src_rate == dst_rate && !force_resample)
+  {
+    m_bypass.reset(new CActiveAEResampleFFMPEG());
+    return m_bypass->Init(dst_chan_layout, dst_channels, dst_rate, dst_fmt, dst_bits, dst_dither,
+                          src_chan_layout, src_channels, src_rate, src_fmt, src_bits, src_dither,
+                          upmix, normalize, remapLayout, quality, force_resample);
+  }
+
+  if (dst_channels > AE_CH_MAX)
+  {
+    CLog::Log(LOGERROR, "CActiveAEResamplePolyphase::Init - too many channels: %d", dst_channels);
+    return false;
+  }
+
+  if (dst_chan_layout == 0)
+    dst_chan_layout = av_get_default_channel_layout(dst_channels);
+  if (src_chan_layout == 0)
+    src_chan_layout = av_get_default_channel_layout(src_channels);
+
+  // remix and convert to planar float at the source rate
+  if (src_fmt != AV_SAMPLE_FMT_FLTP || remapLayout ||
+      src_channels != dst_channels || src_chan_layout != dst_chan_layout)
+  {
+    m_pre.reset(new CActiveAEResampleFFMPEG());
+    if (!m_pre->Init(dst_chan_layout, dst_channels, src_rate, AV_SAMPLE_FMT_FLTP, 32, 0,
+                     src_chan_layout, src_channels, src_rate, src_fmt, src_bits, src_dither,
+                     upmix, normalize, remapLayout, quality, false))
+      return false;
+  }
+
+  // and from planar float to the destination format
+  if (dst_fmt != AV_SAMPLE_FMT_FLTP)
+  {
+    m_post.reset(new CActiveAEResampleFFMPEG());
+    if (!m_post->Init(dst_chan_layout, dst_channels, dst_rate, dst_fmt, dst_bits, dst_dither,
+                      dst_chan_layout, dst_channels, dst_rate, AV_SAMPLE_FMT_FLTP, 32, 0,
+                      false, false, nullptr, quality, false))
+      return false;
+  }
+
+  m_bank = CPolyphaseFilterBank::Get(src_rate, dst_rate, quality);
+  m_step = (double)src_rate / dst_rate;
+  m_position = 0.0;
+  m_flushed = false;
+
+  // start with silence before the center tap, the first output sample then
+  // lines up with the first input sample
+  m_input.assign(dst_channels, std::vector<float>(m_bank->Taps() / 2 - 1, 0.0f));
+  m_output.assign(m_post ? dst_channels : 0, std::vector<float>());
+
+  CLog::Log(LOGDEBUG, "CActiveAEResamplePolyphase::Init - %d Hz to %d Hz, %u taps, %u phases, %.0f dB",
+            src_rate, dst_rate, m_bank->Taps(), m_bank->Phases(), m_bank->Attenuation());
+  return true;
+}
+
+int CActiveAEResamplePolyphase::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
+{
+  if (m_bypass)
+    return m_bypass->Resample(dst_buffer, dst_samples, src_buffer, src_samples, ratio);
+
+  unsigned int taps = m_bank->Taps();
+  unsigned int phases = m_bank->Phases();
+
+  if (src_buffer && src_samples > 0)
+  {
+    size_t start = m_input[0].size();
+    for (auto& plane : m_input)
+      plane.resize(start + src_samples);
+
+    if (m_pre)
+    {
+      uint8_t *planes[AE_CH_MAX];
+      for (int ch = 0; ch < m_dst_channels; ch++)
+        planes[ch] = reinterpret_cast<uint8_t*>(m_input[ch].data() + start);
+      int ret = m_pre->Resample(planes, src_samples, src_buffer, src_samples, 1.0);
+      if (ret < 0)
+        return -1;
+      for (auto& plane : m_input)
+        plane.resize(start + ret);
+    }
+    else
+    {
+      for (int ch = 0; ch < m_dst_channels; ch++)
+        memcpy(m_input[ch].data() + start, src_buffer[ch], src_samples * sizeof(float));
+    }
+    m_flushed = false;
+  }
+  else if (!src_buffer && !m_flushed)
+  {
+    // push the remaining samples past the center tap
+    for (auto& plane : m_input)
+      plane.resize(plane.size() + taps / 2, 0.0f);
+    m_flushed = true;
+  }
+
+  float *out[AE_CH_MAX];
+  for (int ch = 0; ch < m_dst_channels; ch++)
+  {
+    if (m_post)
+    {
+      if (m_output[ch].size() < (size_t)dst_samples)
+        m_output[ch].resize(dst_samples);
+      out[ch] = m_output[ch].data();
+    }
+    else
+      out[ch] = reinterpret_cast<float*>(dst_buffer[ch]);
+  }
+
+  const CAEKernels::Table& kernels = CAEKernels::Get();
+  size_t frames = m_input[0].size();
+  double step = m_step / ratio;
+  m_coefs.resize(taps);
+
+  int produced = 0;
+  while (produced < dst_samples)
+  {
+    size_t first = (size_t)m_position;
+    if (first + taps > frames)
+      break;
+
+    // interpolate between the two nearest phases, once for all channels
+    double phase = (m_position - first) * phases;
+    unsigned int p = (unsigned int)phase;
+    memcpy(m_coefs.data(), m_bank->Phase(p), taps * sizeof(float));
+    kernels.MulAddArray(m_coefs.data(), m_bank->Delta(p), (float)(phase - p), taps);
+
+    for (int ch = 0; ch < m_dst_channels; ch++)
+      out[ch][produced] = kernels.DotProduct(m_input[ch].data() + first, m_coefs.data(), taps);
+
+    produced++;
+    m_position += step;
+  }
+
+  size_t consumed = std::min((size_t)m_position, frames);
+  if (consumed)
+  {
+    for (auto& plane : m_input)
+      plane.erase(plane.begin(), plane.begin() + consumed);
+    m_position -= consumed;
+  }
+
+  if (m_post && produced)
+  {
+    uint8_t *planes[AE_CH_MAX];
+    for (int ch = 0; ch < m_dst_channels; ch++)
+      planes[ch] = reinterpret_cast<uint8_t*>(m_output[ch].data());
+    if (m_post->Resample(dst_buffer, dst_samples, planes, produced, 1.0) < 0)
+      return -1;
+  }
+
+  return produced;
+}
+
+double CActiveAEResamplePolyphase::GetPendingSamples()
+{
+  // input samples after the one the next output sample is centered on
+  unsigned int taps = m_bank->Taps();
+  double pending = (double)m_input[0].size() - m_position - (taps / 2 - 1);
+  if (m_flushed)
+    pending -= taps / 2;
+  return std::max(0.0, pending);
+}
+
+int64_t CActiveAEResamplePolyphase::GetDelay(int64_t base)
+{
+  if (m_bypass)
+    return m_bypass->GetDelay(base);
+
+  return (int64_t)(GetPendingSamples() * base / m_src_rate);
+}
+
+int CActiveAEResamplePolyphase::GetBufferedSamples()
+{
+  if (m_bypass)
+    return m_bypass->GetBufferedSamples();
+
+  return (int)ceil(GetPendingSamples() * m_dst_rate / m_src_rate);
+}
+
+int CActiveAEResamplePolyphase::CalcDstSampleCount(int src_samples, int dst_rate, int src_rate)
+{
+  return (int)(((int64_t)src_samples * dst_rate + src_rate - 1) / src_rate);
+}
+
+int CActiveAEResamplePolyphase::GetSrcBufferSize(int samples)
+{
+  return av_samples_get_buffer_size(NULL, m_src_channels, samples, m_src_fmt, 1);
+}
+
+int CActiveAEResamplePolyphase::GetDstBufferSize(int samples)
+{
+  return av_samples_get_buffer_size(NULL, m_dst_channels, samples, m_dst_fmt, 1);
+}
@@ -0,0 +1,104 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEChannelInfo.h"
+#include "cores/AudioEngine/Utils/AEAudioFormat.h"
+#include "cores/AudioEngine/Interfaces/AE.h"
+#include "cores/AudioEngine/Interfaces/AEResample.h"
+
+#include <memory>
+#include <vector>
+
+namespace ActiveAE
+{
+
+/*!
+ * \brief Kaiser windowed sinc low pass, sampled at Phases() + 1 fractional
+ * offsets of Taps() coefficients each.
+ *
+ * Filter banks only depend on the conversion ratio and the quality, they are
+ * shared between resamplers and kept across stream reconfigures.
+ */
+class CPolyphaseFilterBank
+{
+public:
+  static std::shared_ptr<const CPolyphaseFilterBank> Get(int src_rate, int dst_rate, AEQuality quality);
+
+  unsigned int Taps() const { return m_taps; }
+  unsigned int Phases() const { return m_phases; }
+  /* designed stopband attenuation in dB */
+  double Attenuation() const { return m_attenuation; }
+  const float *Phase(unsigned int phase) const { return &m_coefs[phase * m_taps]; }
+  /* difference to the next phase, for interpolation between phases */
+  const float *Delta(unsigned int phase) const { return &m_deltas[phase * m_taps]; }
+
+  CPolyphaseFilterBank(double ratio, AEQuality quality);
+
+private:
+  unsigned int m_taps;
+  unsigned int m_phases;
+  double m_attenuation;
+  std::vector<float> m_coefs;
+  std::vector<float> m_deltas;
+};
+
+/*!
+ * \brief Polyphase FIR resampler for AE_QUALITY_REALLYHIGH.
+ *
+ * Sample rate conversion runs on planar float with the cached filter banks
+ * and the vector kernels. Format conversion and remixing are left to
+ * swresample, streams without rate conversion are passed on to it entirely.
+ * A new resample ratio only changes the step between output samples.
+ */
+class CActiveAEResamplePolyphase : public IAEResample
+{
+public:
+  const char *GetName() override { return "ActiveAEResamplePolyphase"; }
+  CActiveAEResamplePolyphase();
+  ~CActiveAEResamplePolyphase() override;
+  bool Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, int dst_dither, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, int src_dither, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample) override;
+  int Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio) override;
+  int64_t GetDelay(int64_t base) override;
+  int GetBufferedSamples() override;
+  bool WantsNewSamples(int samples) override { return GetBufferedSamples() <= samples * 2; }
+  int CalcDstSampleCount(int src_samples, int dst_rate, int src_rate) override;
+  int GetSrcBufferSize(int samples) override;
+  int GetDstBufferSize(int samples) override;
+
+protected:
+  double GetPendingSamples();
+
+  std::unique_ptr<IAEResample> m_bypass;
+  std::unique_ptr<IAEResample> m_pre;
+  std::unique_ptr<IAEResample> m_post;
+  std::shared_ptr<const CPolyphaseFilterBank> m_bank;
+  int m_src_rate, m_dst_rate;
+  int m_src_channels, m_dst_channels;
+  AVSampleFormat m_src_fmt, m_dst_fmt;
+  double m_step;
+  double m_position;
+  bool m_flushed;
+  std::vector<std::vector<float>> m_input;
+  std::vector<std::vector<float>> m_output;
+  std::vector<float> m_coefs;
+};
+
+}
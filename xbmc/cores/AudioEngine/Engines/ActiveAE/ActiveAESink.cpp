@@ -25,6 +25,7 @@
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
 #include "cores/AudioEngine/Utils/AEBitstreamPacker.h"
 #include "utils/EndianSwap.h"
+#include "utils/TimeUtils.h"
 #include "ActiveAE.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "utils/log.h"
@@ -433,7 +434,10 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
           CSampleBuffer *samples;
           unsigned int delay;
           samples = *((CSampleBuffer**)msg->data);
+          int64_t start;
+          start = CurrentHostCounter();
           delay = OutputSamples(samples);
+          m_stats->AddStageTime(AE_STAGE_SINK, (CurrentHostCounter() - start) * 1000000 / CurrentHostFrequency());
           msg->Reply(CSinkDataProtocol::RETURNSAMPLE, &samples, sizeof(CSampleBuffer*));
           if (m_extError)
           {
@@ -543,6 +547,9 @@ void CActiveAESink::StateMachine(int signal, Protocol *port, Message *msg)
         switch (signal)
         {
         case CSinkControlProtocol::TIMEOUT:
+          // the engine did not deliver in time while streams are playing
+          if (m_extStreaming)
+            m_stats->AddUnderrun(true);
           if (!m_extSilenceTimer.IsTimePast())
           {
             m_state = S_TOP_CONFIGURED_SILENCE;
@@ -20,6 +20,7 @@
 
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 
@@ -28,7 +29,13 @@
 
 using namespace ActiveAE;
 
+/* upper bound for buffers handed to a stream at once, the input pool holds
+   MAX_CACHE_LEVEL worth of samples which is far less even for passthrough */
+#define MAX_STREAM_BUFFERS 512
+
 CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid, CActiveAE *ae)
+  : m_freeBuffers(MAX_STREAM_BUFFERS),
+    m_readyBuffers(MAX_STREAM_BUFFERS)
 {
   m_activeAE = ae;
   m_format = *format;
@@ -37,6 +44,7 @@ CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid, C
   m_currentBuffer = NULL;
   m_drain = false;
   m_paused = false;
+  m_starved = false;
   m_rgain = 1.0;
   m_volume = 1.0;
   SetVolume(1.0);
@@ -45,7 +53,7 @@ CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid, C
   m_streamDraining = false;
   m_streamDrained = false;
   m_streamFading = false;
-  m_streamFreeBuffers = 0;
+  m_maxAddDataTime = 0;
   m_streamIsBuffering = false;
   m_streamIsFlushed = false;
   m_bypassDSP = false;
@@ -74,22 +82,24 @@ CActiveAEStream::~CActiveAEStream()
   delete m_remapBuffer;
 }
 
-void CActiveAEStream::IncFreeBuffers()
+void CActiveAEStream::WakeupProducer()
 {
-  CSingleLock lock(m_streamLock);
-  m_streamFreeBuffers++;
+  if (m_bufferWakeup.IsWaiting())
+    m_inMsgEvent.Set();
 }
 
-void CActiveAEStream::DecFreeBuffers()
+void CActiveAEStream::SendReadyBuffer()
 {
-  CSingleLock lock(m_streamLock);
-  m_streamFreeBuffers--;
+  RemapBuffer();
+  // can't overflow, we never hold more buffers than the engine handed out
+  m_readyBuffers.Push(m_currentBuffer);
+  m_activeAE->WakeupEngine();
+  m_currentBuffer = NULL;
 }
 
-void CActiveAEStream::ResetFreeBuffers()
+double CActiveAEStream::GetMaxAddDataTime()
 {
-  CSingleLock lock(m_streamLock);
-  m_streamFreeBuffers = 0;
+  return (double)m_maxAddDataTime * 1000 / CurrentHostFrequency();
 }
 
 void CActiveAEStream::InitRemapper()
@@ -232,16 +242,16 @@ int CActiveAEStream::GetErrorInterval()
 
 unsigned int CActiveAEStream::GetSpace()
 {
-  CSingleLock lock(m_streamLock);
+  unsigned int freeBuffers = m_freeBuffers.Size();
   if (m_format.m_dataFormat == AE_FMT_RAW)
-    return m_streamFreeBuffers;
+    return freeBuffers;
   else
-    return m_streamFreeBuffers * m_streamSpace;
+    return freeBuffers * m_streamSpace;
 }
 
 unsigned int CActiveAEStream::AddData(const uint8_t* const *data, unsigned int offset, unsigned int frames, double pts)
 {
-  Message *msg;
+  int64_t start = CurrentHostCounter();
   unsigned int copied = 0;
   int sourceFrames = frames;
   const uint8_t* const *buf = data;
@@ -310,37 +320,34 @@ unsigned int CActiveAEStream::AddData(const uint8_t* const *data, unsigned int o
 
       if (m_currentBuffer->pkt->nb_samples == m_currentBuffer->pkt->max_nb_samples || rawPktComplete)
       {
-        MsgStreamSample msgData;
-        msgData.buffer = m_currentBuffer;
-        msgData.stream = this;
-        RemapBuffer();
-        m_streamPort->SendOutMessage(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
-        m_currentBuffer = NULL;
+        SendReadyBuffer();
       }
       continue;
     }
-    else if (m_streamPort->ReceiveInMessage(&msg))
+    else if (m_freeBuffers.Pop(m_currentBuffer))
     {
-      if (msg->signal == CActiveAEDataProtocol::STREAMBUFFER)
-      {
-        m_currentBuffer = *((CSampleBuffer**)msg->data);
-        m_currentBuffer->timestamp = 0;
-        m_currentBuffer->pkt->nb_samples = 0;
-        m_currentBuffer->pkt->pause_burst_ms = 0;
-        msg->Release();
-        DecFreeBuffers();
-        continue;
-      }
-      else
-      {
-        CLog::Log(LOGERROR, "CActiveAEStream::AddData - unknown signal");
-        msg->Release();
-        break;
-      }
+      m_currentBuffer->timestamp = 0;
+      m_currentBuffer->pkt->nb_samples = 0;
+      m_currentBuffer->pkt->pause_burst_ms = 0;
+      continue;
     }
-    if (!m_inMsgEvent.WaitMSec(200))
+
+    // the engine only signals while we wait, so look again after telling it
+    m_bufferWakeup.BeginWait();
+    if (!m_freeBuffers.Empty())
+    {
+      m_bufferWakeup.EndWait();
+      continue;
+    }
+    bool gotBuffer = m_inMsgEvent.WaitMSec(200);
+    m_bufferWakeup.EndWait();
+    if (!gotBuffer)
       break;
   }
+
+  int64_t elapsed = CurrentHostCounter() - start;
+  if (elapsed > m_maxAddDataTime)
+    m_maxAddDataTime = elapsed;
   return copied;
 }
 
@@ -412,33 +419,32 @@ void CActiveAEStream::Drain(bool wait)
 
   if (m_currentBuffer)
   {
-    MsgStreamSample msgData;
-    msgData.buffer = m_currentBuffer;
-    msgData.stream = this;
-    RemapBuffer();
-    m_streamPort->SendOutMessage(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
-    m_currentBuffer = NULL;
+    SendReadyBuffer();
   }
 
   XbmcThreads::EndTime timer(2000);
   while (!timer.IsTimePast())
   {
+    // hand back unused buffers, the engine waits for all of them
+    CSampleBuffer *buffer;
+    bool returned = false;
+    while (m_freeBuffers.Pop(buffer))
+    {
+      m_readyBuffers.Push(buffer);
+      returned = true;
+    }
+    if (returned)
+      m_activeAE->WakeupEngine();
+
     if (m_streamPort->ReceiveInMessage(&msg))
     {
-      if (msg->signal == CActiveAEDataProtocol::STREAMBUFFER)
-      {
-        MsgStreamSample msgData;
-        msgData.stream = this;
-        msgData.buffer = *((CSampleBuffer**)msg->data);
-        msg->Reply(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
-        DecFreeBuffers();
-        continue;
-      }
-      else if (msg->signal == CActiveAEDataProtocol::STREAMDRAINED)
+      if (msg->signal == CActiveAEDataProtocol::STREAMDRAINED)
       {
         msg->Release();
         return;
       }
+      msg->Release();
+      continue;
     }
     else if (!wait)
       return;
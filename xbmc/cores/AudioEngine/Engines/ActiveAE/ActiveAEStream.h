@@ -22,6 +22,7 @@
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Utils/AELimiter.h"
+#include "threads/SPSCQueue.h"
 #include <atomic>
 
 namespace ActiveAE
@@ -142,9 +143,9 @@ protected:
   CActiveAEStream(AEAudioFormat *format, unsigned int streamid, CActiveAE *ae);
   ~CActiveAEStream() override;
   void FadingFinished();
-  void IncFreeBuffers();
-  void DecFreeBuffers();
-  void ResetFreeBuffers();
+  void WakeupProducer();
+  void SendReadyBuffer();
+  double GetMaxAddDataTime();
   void InitRemapper();
   void RemapBuffer();
   double CalcResampleRatio(double error);
@@ -205,7 +206,6 @@ protected:
   bool m_streamDraining;
   bool m_streamDrained;
   bool m_streamFading;
-  int m_streamFreeBuffers;
   bool m_streamIsBuffering;
   bool m_streamIsFlushed;
   bool m_bypassDSP;
@@ -226,10 +226,18 @@ protected:
   CActiveAEStreamBuffers *m_processingBuffers;
   std::deque<CSampleBuffer*> m_processingSamples;
   CActiveAEDataProtocol *m_streamPort;
+
+  // sample buffers move without locks or messages, free ones from the
+  // engine to AddData, filled ones back. Only control goes via m_streamPort
+  CSPSCQueue<CSampleBuffer*> m_freeBuffers;
+  CSPSCQueue<CSampleBuffer*> m_readyBuffers;
+  CSPSCWakeup m_bufferWakeup;
+  int64_t m_maxAddDataTime;
   CEvent m_inMsgEvent;
   bool m_drain;
   bool m_paused;
   bool m_started;
+  bool m_starved;
   CAELimiter m_limiter;
   float m_volume;
   float m_rgain;
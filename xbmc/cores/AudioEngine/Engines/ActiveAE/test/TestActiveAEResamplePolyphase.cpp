@@ -0,0 +1,175 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResamplePolyphase.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "libavutil/channel_layout.h"
+}
+
+using namespace ActiveAE;
+
+namespace
+{
+
+const int BLOCK = 1024;
+
+// runs a mono sine through the resampler in blocks, float planar on both
+// sides so only the polyphase filter is involved
+std::vector<float> Convert(CActiveAEResamplePolyphase& resampler, int src_rate, int dst_rate,
+                           double freq, int samples, double ratio = 1.0)
+{
+  std::vector<float> src(samples);
+  for (int i = 0; i < samples; i++)
+    src[i] = (float)(0.5 * sin(2.0 * M_PI * freq * i / src_rate));
+
+  std::vector<float> out;
+  std::vector<float> dst(BLOCK * 4);
+  uint8_t *dst_planes[1] = { reinterpret_cast<uint8_t*>(dst.data()) };
+  for (int pos = 0; pos < samples; pos += BLOCK)
+  {
+    uint8_t *src_planes[1] = { reinterpret_cast<uint8_t*>(src.data() + pos) };
+    int count = std::min(BLOCK, samples - pos);
+    int ret = resampler.Resample(dst_planes, dst.size(), src_planes, count, ratio);
+    EXPECT_GE(ret, 0);
+    out.insert(out.end(), dst.begin(), dst.begin() + ret);
+  }
+  int ret;
+  while ((ret = resampler.Resample(dst_planes, dst.size(), nullptr, 0, ratio)) > 0)
+    out.insert(out.end(), dst.begin(), dst.begin() + ret);
+  return out;
+}
+
+bool Init(CActiveAEResamplePolyphase& resampler, int src_rate, int dst_rate, AEQuality quality)
+{
+  return resampler.Init(AV_CH_LAYOUT_MONO, 1, dst_rate, AV_SAMPLE_FMT_FLTP, 32, 0,
+                        AV_CH_LAYOUT_MONO, 1, src_rate, AV_SAMPLE_FMT_FLTP, 32, 0,
+                        false, false, nullptr, quality, false);
+}
+
+// level in dB relative to the 0.5 amplitude input, skipping the edges
+double Level(const std::vector<float>& data)
+{
+  size_t skip = data.size() / 4;
+  double sum = 0.0;
+  for (size_t i = skip; i < data.size() - skip; i++)
+    sum += (double)data[i] * data[i];
+  double rms = sqrt(sum / (data.size() - 2 * skip));
+  return 20.0 * log10(rms / (0.5 / sqrt(2.0)));
+}
+
+}
+
+TEST(TestActiveAEResamplePolyphase, FilterBankCache)
+{
+  auto bank = CPolyphaseFilterBank::Get(44100, 48000, AE_QUALITY_REALLYHIGH);
+  // every upsampling ratio uses the same filter
+  EXPECT_EQ(bank, CPolyphaseFilterBank::Get(32000, 96000, AE_QUALITY_REALLYHIGH));
+  EXPECT_EQ(CPolyphaseFilterBank::Get(96000, 48000, AE_QUALITY_HIGH),
+            CPolyphaseFilterBank::Get(88200, 44100, AE_QUALITY_HIGH));
+  EXPECT_NE(CPolyphaseFilterBank::Get(96000, 48000, AE_QUALITY_HIGH),
+            CPolyphaseFilterBank::Get(96000, 48000, AE_QUALITY_REALLYHIGH));
+  EXPECT_EQ(0u, bank->Taps() % 8);
+  EXPECT_LE((bank->Phases() + 1) * bank->Taps() * 2 * sizeof(float), 4u * 1024 * 1024);
+}
+
+TEST(TestActiveAEResamplePolyphase, Passband)
+{
+  CActiveAEResamplePolyphase resampler;
+  ASSERT_TRUE(Init(resampler, 44100, 48000, AE_QUALITY_REALLYHIGH));
+  std::vector<float> out = Convert(resampler, 44100, 48000, 1000.0, 44100);
+  EXPECT_EQ(48000u, out.size());
+  EXPECT_NEAR(0.0, Level(out), 0.01);
+
+  // compare with the ideal output sample by sample
+  double error = 0.0;
+  for (size_t i = out.size() / 4; i < out.size() * 3 / 4; i++)
+    error = std::max(error, fabs(out[i] - 0.5 * sin(2.0 * M_PI * 1000.0 * i / 48000)));
+  EXPECT_LT(error, 1e-4);
+}
+
+TEST(TestActiveAEResamplePolyphase, Stopband)
+{
+  // 30 kHz would alias to 18 kHz
+  CActiveAEResamplePolyphase resampler;
+  ASSERT_TRUE(Init(resampler, 96000, 48000, AE_QUALITY_HIGH));
+  std::vector<float> out = Convert(resampler, 96000, 48000, 30000.0, 96000);
+  EXPECT_EQ(48000u, out.size());
+  EXPECT_LT(Level(out), -100.0);
+}
+
+TEST(TestActiveAEResamplePolyphase, Ratio)
+{
+  // sync by resample only changes the step between output samples
+  CActiveAEResamplePolyphase resampler;
+  ASSERT_TRUE(resampler.Init(AV_CH_LAYOUT_MONO, 1, 48000, AV_SAMPLE_FMT_FLTP, 32, 0,
+                             AV_CH_LAYOUT_MONO, 1, 48000, AV_SAMPLE_FMT_FLTP, 32, 0,
+                             false, false, nullptr, AE_QUALITY_REALLYHIGH, true));
+  std::vector<float> out = Convert(resampler, 48000, 48000, 1000.0, 48000, 1.01);
+  EXPECT_NEAR(48480.0, out.size(), 1.0);
+  EXPECT_NEAR(0.0, Level(out), 0.01);
+}
+
+TEST(TestActiveAEResamplePolyphase, Drain)
+{
+  CActiveAEResamplePolyphase resampler;
+  ASSERT_TRUE(Init(resampler, 48000, 44100, AE_QUALITY_REALLYHIGH));
+
+  std::vector<float> src(4800, 0.25f);
+  std::vector<float> dst(8192);
+  uint8_t *src_planes[1] = { reinterpret_cast<uint8_t*>(src.data()) };
+  uint8_t *dst_planes[1] = { reinterpret_cast<uint8_t*>(dst.data()) };
+  int total = resampler.Resample(dst_planes, dst.size(), src_planes, src.size(), 1.0);
+  EXPECT_GT(resampler.GetBufferedSamples(), 0);
+  EXPECT_GT(resampler.GetDelay(1000), 0);
+
+  int ret;
+  while ((ret = resampler.Resample(dst_planes, dst.size(), nullptr, 0, 1.0)) > 0)
+    total += ret;
+  EXPECT_EQ(0, ret);
+  EXPECT_EQ(4410, total);
+  EXPECT_EQ(0, resampler.GetBufferedSamples());
+  EXPECT_EQ(0, resampler.GetDelay(1000));
+}
+
+TEST(TestActiveAEResamplePolyphase, DISABLED_Benchmark)
+{
+  const AEQuality qualities[] = { AE_QUALITY_LOW, AE_QUALITY_MID, AE_QUALITY_HIGH, AE_QUALITY_REALLYHIGH };
+  for (AEQuality quality : qualities)
+  {
+    CActiveAEResamplePolyphase resampler;
+    ASSERT_TRUE(Init(resampler, 44100, 48000, quality));
+    auto start = std::chrono::steady_clock::now();
+    Convert(resampler, 44100, 48000, 1000.0, 44100 * 10);
+    auto end = std::chrono::steady_clock::now();
+    auto bank = CPolyphaseFilterBank::Get(44100, 48000, quality);
+    std::cout << "quality " << quality << ": " << bank->Taps() << " taps, "
+              << bank->Phases() << " phases, " << bank->Attenuation() << " dB, "
+              << std::chrono::duration<double, std::milli>(end - start).count() / 10
+              << " ms per second of audio and channel" << std::endl;
+  }
+}
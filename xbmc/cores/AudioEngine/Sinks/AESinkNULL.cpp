@@ -0,0 +1,376 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AESinkNULL.h"
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#define NULL_PERIOD_MS 20
+#define NULL_PERIODS   4
+
+static const unsigned int NullSampleRates[] = { 32000, 44100, 48000, 88200, 96000, 176400, 192000 };
+
+// WAVEFORMATEXTENSIBLE speaker positions, indexed by AEChannel
+static const uint32_t WaveSpeakers[] = { 0,
+  0x1,   0x2,    0x4,    0x8,   0x10,  0x20,  0x40,
+  0x80,  0x100,  0x200,  0x400, 0x1000, 0x4000, 0x2000,
+  0x800, 0x8000, 0x20000, 0x10000, 0, 0 };
+
+static void PutLE(uint8_t *&buffer, uint32_t value, unsigned int bytes)
+{
+  for (unsigned int i = 0; i < bytes; ++i)
+    *buffer++ = (value >> (8 * i)) & 0xFF;
+}
+
+CAESinkNULL::CAESinkNULL()
+  : m_initialized(false)
+  , m_periodFrames(0)
+  , m_bufferFrames(0)
+  , m_buffered(0.0)
+  , m_clock(0)
+  , m_framesWritten(0)
+  , m_underruns(0)
+  , m_writeFile(false)
+  , m_dataSize(0)
+{
+}
+
+CAESinkNULL::~CAESinkNULL()
+{
+  Deinitialize();
+}
+
+void CAESinkNULL::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "NULL";
+  entry.createFunc = CAESinkNULL::Create;
+  entry.enumerateFunc = CAESinkNULL::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkNULL::Create(std::string &device, AEAudioFormat &desiredFormat)
+{
+  IAESink* sink = new CAESinkNULL();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+void CAESinkNULL::EnumerateDevicesEx(AEDeviceInfoList &list, bool force)
+{
+  CAEDeviceInfo info;
+  info.m_deviceName = "null";
+  info.m_displayName = "Null output";
+  info.m_displayNameExtra = "simulated device clock";
+  // HDMI so that high bitrate passthrough formats can be tested as well
+  info.m_deviceType = AE_DEVTYPE_HDMI;
+  info.m_wantsIECPassthrough = true;
+  info.m_channels = AE_CH_LAYOUT_7_1;
+  info.m_sampleRates.assign(NullSampleRates, NullSampleRates + sizeof(NullSampleRates) / sizeof(NullSampleRates[0]));
+  info.m_dataFormats.push_back(AE_FMT_FLOAT);
+  info.m_dataFormats.push_back(AE_FMT_S32NE);
+  info.m_dataFormats.push_back(AE_FMT_S16NE);
+  info.m_dataFormats.push_back(AE_FMT_RAW);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_AC3);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_EAC3);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTSHD_CORE);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_2048);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_1024);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_512);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTSHD);
+  info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_TRUEHD);
+  list.push_back(info);
+}
+
+bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
+{
+  if (format.m_sampleRate == 0)
+    return false;
+
+  if (format.m_dataFormat == AE_FMT_RAW)
+  {
+    // IEC 61937 frames are 16 bit, high bitrate formats use all eight channels
+    CAEChannelInfo layout;
+    if (format.m_streamInfo.m_type == CAEStreamInfo::STREAM_TYPE_TRUEHD ||
+        format.m_streamInfo.m_type == CAEStreamInfo::STREAM_TYPE_DTSHD)
+      layout = AE_CH_LAYOUT_7_1;
+    else
+      layout = AE_CH_LAYOUT_2_0;
+    format.m_channelLayout = layout;
+    format.m_frameSize = 2 * layout.Count();
+  }
+  else
+  {
+    if (format.m_dataFormat != AE_FMT_FLOAT &&
+        format.m_dataFormat != AE_FMT_S32NE &&
+        format.m_dataFormat != AE_FMT_S16NE)
+      format.m_dataFormat = AE_FMT_FLOAT;
+    format.m_frameSize = (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3) * format.m_channelLayout.Count();
+  }
+
+  if (format.m_frameSize == 0)
+    return false;
+
+  m_periodFrames = format.m_sampleRate * NULL_PERIOD_MS / 1000;
+  m_bufferFrames = m_periodFrames * NULL_PERIODS;
+  format.m_frames = m_periodFrames;
+  m_format = format;
+
+  m_writeFile = !device.empty() && !StringUtils::EqualsNoCase(device, "null") &&
+                !StringUtils::EqualsNoCase(device, "default");
+  m_dataSize = 0;
+  if (m_writeFile)
+  {
+    if (!m_file.OpenForWrite(device, true))
+    {
+      CLog::Log(LOGERROR, "CAESinkNULL::Initialize - unable to open %s", device.c_str());
+      return false;
+    }
+    if (!WriteHeader())
+    {
+      CLog::Log(LOGERROR, "CAESinkNULL::Initialize - unable to write to %s", device.c_str());
+      m_file.Close();
+      return false;
+    }
+  }
+
+  m_buffered = 0.0;
+  m_framesWritten = 0;
+  m_underruns = 0;
+  m_clock = GetClock();
+  m_initialized = true;
+
+  CLog::Log(LOGDEBUG, "CAESinkNULL::Initialize - %s, %u Hz, %u channels, period %u frames%s%s",
+            CAEUtil::DataFormatToStr(m_format.m_dataFormat), m_format.m_sampleRate,
+            m_format.m_channelLayout.Count(), m_periodFrames,
+            m_writeFile ? ", writing to " : "", m_writeFile ? device.c_str() : "");
+  return true;
+}
+
+void CAESinkNULL::Deinitialize()
+{
+  if (!m_initialized)
+    return;
+
+  CLog::Log(LOGDEBUG, "CAESinkNULL::Deinitialize - played %.3f s, %u underruns",
+            static_cast<double>(m_framesWritten) / m_format.m_sampleRate, m_underruns);
+
+  if (m_writeFile)
+    CloseFile();
+  m_initialized = false;
+}
+
+void CAESinkNULL::CloseFile()
+{
+  // now that the size of the data is known
+  m_file.Seek(0, SEEK_SET);
+  WriteHeader();
+  m_file.Close();
+  m_writeFile = false;
+}
+
+int64_t CAESinkNULL::GetClock()
+{
+  return CurrentHostCounter() * 1000000000LL / CurrentHostFrequency();
+}
+
+void CAESinkNULL::Wait(int64_t ns)
+{
+  XbmcThreads::ThreadSleep(static_cast<unsigned int>((ns + 999999) / 1000000));
+}
+
+void CAESinkNULL::Update()
+{
+  const int64_t now = GetClock();
+  const double played = (now - m_clock) * 1e-9 * m_format.m_sampleRate;
+  m_clock = now;
+
+  if (played > m_buffered)
+  {
+    // the device ran dry while data was still expected
+    if (m_buffered > 0.0)
+      ++m_underruns;
+    m_buffered = 0.0;
+  }
+  else
+    m_buffered -= played;
+}
+
+unsigned int CAESinkNULL::Write(const uint8_t *data, unsigned int frames)
+{
+  Update();
+
+  // like a real device, block until at least a period (or all of the data) fits
+  const unsigned int wanted = std::min(frames, m_periodFrames);
+  double space = m_bufferFrames - m_buffered;
+  if (space < wanted)
+  {
+    Wait(static_cast<int64_t>((wanted - space) * 1e9 / m_format.m_sampleRate));
+    Update();
+    space = m_bufferFrames - m_buffered;
+  }
+
+  const unsigned int written = std::min(frames, static_cast<unsigned int>(std::max(space, 0.0)));
+  if (written == 0)
+    return 0;
+
+  if (m_writeFile)
+  {
+    const size_t size = static_cast<size_t>(written) * m_format.m_frameSize;
+    ssize_t result;
+    if (data)
+      result = m_file.Write(data, size);
+    else
+    {
+      std::vector<uint8_t> silence(size, 0);
+      result = m_file.Write(silence.data(), size);
+    }
+    if (result > 0)
+      m_dataSize += result;
+    if (result != static_cast<ssize_t>(size))
+    {
+      // e.g. the disk is full, keep what made it to the file and only simulate the device from now on
+      CLog::Log(LOGERROR, "CAESinkNULL::Write - writing the output file failed, stopped writing after %llu bytes",
+                static_cast<unsigned long long>(m_dataSize));
+      CloseFile();
+    }
+  }
+
+  m_buffered += written;
+  m_framesWritten += written;
+  return written;
+}
+
+unsigned int CAESinkNULL::AddPackets(uint8_t **data, unsigned int frames, unsigned int offset)
+{
+  if (!m_initialized)
+    return 0;
+
+  return Write(data[0] + offset * m_format.m_frameSize, frames);
+}
+
+void CAESinkNULL::AddPause(unsigned int millis)
+{
+  if (!m_initialized)
+    return;
+
+  unsigned int frames = m_format.m_sampleRate * millis / 1000;
+  while (frames > 0)
+  {
+    unsigned int written = Write(nullptr, frames);
+    if (written == 0)
+      break;
+    frames -= written;
+  }
+}
+
+void CAESinkNULL::GetDelay(AEDelayStatus& status)
+{
+  if (!m_initialized)
+  {
+    status.SetDelay(0.0);
+    return;
+  }
+
+  Update();
+  status.SetDelay(m_buffered / m_format.m_sampleRate);
+}
+
+double CAESinkNULL::GetCacheTotal()
+{
+  if (!m_initialized)
+    return 0.0;
+
+  return static_cast<double>(m_bufferFrames) / m_format.m_sampleRate;
+}
+
+void CAESinkNULL::Drain()
+{
+  if (!m_initialized)
+    return;
+
+  Update();
+  if (m_buffered > 0.0)
+  {
+    Wait(static_cast<int64_t>(std::ceil(m_buffered * 1e9 / m_format.m_sampleRate)));
+    Update();
+  }
+  m_buffered = 0.0;
+}
+
+bool CAESinkNULL::WriteHeader()
+{
+  const unsigned int channels = m_format.m_channelLayout.Count();
+  const unsigned int bits = m_format.m_dataFormat == AE_FMT_RAW ? 16 : CAEUtil::DataFormatToBits(m_format.m_dataFormat);
+  const unsigned int formatTag = m_format.m_dataFormat == AE_FMT_FLOAT ? 3 : 1; // IEEE float or PCM
+
+  // players only map more than two channels (7.1 passthrough included) to speakers with a channel mask
+  const bool extensible = channels > 2;
+  const unsigned int formatSize = extensible ? 40 : 16;
+  const unsigned int headerSize = 20 + formatSize + 8;
+  const uint32_t dataSize = static_cast<uint32_t>(std::min<uint64_t>(m_dataSize, 0xFFFFFFFF - (headerSize - 8)));
+
+  uint8_t header[68];
+  uint8_t *p = header;
+  memcpy(p, "RIFF", 4); p += 4;
+  PutLE(p, headerSize - 8 + dataSize, 4);
+  memcpy(p, "WAVEfmt ", 8); p += 8;
+  PutLE(p, formatSize, 4);
+  PutLE(p, extensible ? 0xFFFE : formatTag, 2);
+  PutLE(p, channels, 2);
+  PutLE(p, m_format.m_sampleRate, 4);
+  PutLE(p, m_format.m_sampleRate * m_format.m_frameSize, 4);
+  PutLE(p, m_format.m_frameSize, 2);
+  PutLE(p, bits, 2);
+  if (extensible)
+  {
+    uint32_t mask = 0;
+    for (unsigned int i = 0; i < channels; ++i)
+    {
+      const AEChannel channel = m_format.m_channelLayout[i];
+      if (channel > AE_CH_RAW && channel <= AE_CH_BROC)
+        mask |= WaveSpeakers[channel];
+    }
+    PutLE(p, 22, 2);
+    PutLE(p, bits, 2);
+    PutLE(p, mask, 4);
+    // sub format GUID, the format tag followed by the fixed KSDATAFORMAT_SUBTYPE suffix
+    static const uint8_t subFormat[] = { 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+    PutLE(p, formatTag, 4);
+    memcpy(p, subFormat, sizeof(subFormat)); p += sizeof(subFormat);
+  }
+  memcpy(p, "data", 4); p += 4;
+  PutLE(p, dataSize, 4);
+
+  const size_t size = p - header;
+  return m_file.Write(header, size) == static_cast<ssize_t>(size);
+}
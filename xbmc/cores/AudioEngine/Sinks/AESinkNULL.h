@@ -0,0 +1,84 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+#include "filesystem/File.h"
+#include <stdint.h>
+
+/*!
+ \brief Sink without audio hardware.
+
+ Consumes audio at the pace of a simulated device clock and reports exact
+ delay and cache figures, so the engine can run on machines without sound
+ hardware. If the device is a path instead of "null" the output is written
+ there as a WAV file, passthrough output as IEC 61937 frames.
+ Only registered if requested through AE_SINK=NULL.
+ */
+class CAESinkNULL : public IAESink
+{
+public:
+  const char *GetName() override { return "NULL"; }
+
+  CAESinkNULL();
+  ~CAESinkNULL() override;
+
+  static void Register();
+  static IAESink* Create(std::string &device, AEAudioFormat &desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
+
+  bool Initialize(AEAudioFormat &format, std::string &device) override;
+  void Deinitialize() override;
+
+  double GetCacheTotal() override;
+  unsigned int AddPackets(uint8_t **data, unsigned int frames, unsigned int offset) override;
+  void AddPause(unsigned int millis) override;
+  void GetDelay(AEDelayStatus& status) override;
+  void Drain() override;
+
+  uint64_t GetFramesWritten() const { return m_framesWritten; }
+  unsigned int GetUnderruns() const { return m_underruns; }
+
+protected:
+  /*! \brief Current time of the simulated device clock in ns */
+  virtual int64_t GetClock();
+  /*! \brief Block until the simulated device clock advanced by the given ns */
+  virtual void Wait(int64_t ns);
+
+private:
+  void Update();
+  unsigned int Write(const uint8_t *data, unsigned int frames);
+  bool WriteHeader();
+  void CloseFile();
+
+  AEAudioFormat m_format;
+  bool m_initialized;
+  unsigned int m_periodFrames;
+  unsigned int m_bufferFrames;
+  double m_buffered;         // frames the simulated device has yet to play
+  int64_t m_clock;           // time of the last update
+  uint64_t m_framesWritten;
+  unsigned int m_underruns;
+
+  XFILE::CFile m_file;
+  bool m_writeFile;
+  uint64_t m_dataSize;
+};
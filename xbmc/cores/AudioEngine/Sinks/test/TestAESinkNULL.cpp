@@ -0,0 +1,248 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "filesystem/File.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+// sink whose device clock only moves when told to, or when the sink waits
+class CTestAESinkNULL : public CAESinkNULL
+{
+public:
+  void Advance(int64_t ns) { m_now += ns; }
+  int64_t Now() const { return m_now; }
+
+protected:
+  int64_t GetClock() override { return m_now; }
+  void Wait(int64_t ns) override { m_now += ns; }
+
+private:
+  int64_t m_now = 0;
+};
+
+AEAudioFormat MakeFormat(AEDataFormat dataFormat, unsigned int sampleRate = 48000)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = dataFormat;
+  format.m_sampleRate = sampleRate;
+  format.m_channelLayout = AE_CH_LAYOUT_2_0;
+  return format;
+}
+
+unsigned int Add(CAESinkNULL &sink, std::vector<uint8_t> &buffer, unsigned int frames, unsigned int frameSize)
+{
+  buffer.resize(frames * frameSize);
+  uint8_t *planes[] = { buffer.data() };
+  return sink.AddPackets(planes, frames, 0);
+}
+
+} // anonymous namespace
+
+TEST(TestAESinkNULL, Delay)
+{
+  CTestAESinkNULL sink;
+  std::string device = "null";
+  AEAudioFormat format = MakeFormat(AE_FMT_FLOAT);
+  ASSERT_TRUE(sink.Initialize(format, device));
+  EXPECT_EQ(960U, format.m_frames);
+  EXPECT_EQ(8U, format.m_frameSize);
+  EXPECT_DOUBLE_EQ(0.08, sink.GetCacheTotal());
+
+  std::vector<uint8_t> buffer;
+  EXPECT_EQ(960U, Add(sink, buffer, 960, format.m_frameSize));
+
+  AEDelayStatus status;
+  sink.GetDelay(status);
+  EXPECT_NEAR(0.02, status.delay, 1e-9);
+
+  sink.Advance(5000000);
+  sink.GetDelay(status);
+  EXPECT_NEAR(0.015, status.delay, 1e-9);
+  EXPECT_EQ(0U, sink.GetUnderruns());
+}
+
+TEST(TestAESinkNULL, Blocking)
+{
+  CTestAESinkNULL sink;
+  std::string device = "null";
+  AEAudioFormat format = MakeFormat(AE_FMT_S16NE);
+  ASSERT_TRUE(sink.Initialize(format, device));
+
+  // the cache only takes what fits without waiting
+  std::vector<uint8_t> buffer;
+  EXPECT_EQ(3840U, Add(sink, buffer, 4800, format.m_frameSize));
+  EXPECT_EQ(0, sink.Now());
+
+  // a full cache blocks for exactly one period
+  EXPECT_EQ(960U, Add(sink, buffer, 960, format.m_frameSize));
+  EXPECT_EQ(20000000, sink.Now());
+
+  sink.Drain();
+  EXPECT_EQ(100000000, sink.Now());
+  EXPECT_EQ(4800U, sink.GetFramesWritten());
+  EXPECT_EQ(0U, sink.GetUnderruns());
+}
+
+TEST(TestAESinkNULL, Underrun)
+{
+  CTestAESinkNULL sink;
+  std::string device = "null";
+  AEAudioFormat format = MakeFormat(AE_FMT_FLOAT);
+  ASSERT_TRUE(sink.Initialize(format, device));
+
+  std::vector<uint8_t> buffer;
+  Add(sink, buffer, 960, format.m_frameSize);
+  sink.Advance(30000000);
+
+  AEDelayStatus status;
+  sink.GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+  EXPECT_EQ(1U, sink.GetUnderruns());
+}
+
+TEST(TestAESinkNULL, Formats)
+{
+  CTestAESinkNULL sink;
+  std::string device = "null";
+
+  AEAudioFormat format = MakeFormat(AE_FMT_S24NE4P, 44100);
+  format.m_channelLayout = AE_CH_LAYOUT_5_1;
+  ASSERT_TRUE(sink.Initialize(format, device));
+  EXPECT_EQ(AE_FMT_FLOAT, format.m_dataFormat);
+  EXPECT_EQ(24U, format.m_frameSize);
+  EXPECT_EQ(882U, format.m_frames);
+  sink.Deinitialize();
+
+  format = MakeFormat(AE_FMT_RAW, 192000);
+  format.m_streamInfo.m_type = CAEStreamInfo::STREAM_TYPE_TRUEHD;
+  ASSERT_TRUE(sink.Initialize(format, device));
+  EXPECT_EQ(AE_FMT_RAW, format.m_dataFormat);
+  EXPECT_EQ(8U, format.m_channelLayout.Count());
+  EXPECT_EQ(16U, format.m_frameSize);
+  sink.Deinitialize();
+
+  format = MakeFormat(AE_FMT_RAW);
+  format.m_streamInfo.m_type = CAEStreamInfo::STREAM_TYPE_AC3;
+  ASSERT_TRUE(sink.Initialize(format, device));
+  EXPECT_EQ(4U, format.m_frameSize);
+}
+
+TEST(TestAESinkNULL, WaveFile)
+{
+  const std::string path = "special://temp/aesinknull.wav";
+  {
+    CTestAESinkNULL sink;
+    std::string device = path;
+    AEAudioFormat format = MakeFormat(AE_FMT_S16NE);
+    ASSERT_TRUE(sink.Initialize(format, device));
+
+    std::vector<uint8_t> buffer;
+    EXPECT_EQ(480U, Add(sink, buffer, 480, format.m_frameSize));
+    sink.AddPause(10);
+    sink.Deinitialize();
+  }
+
+  XFILE::CFile file;
+  ASSERT_TRUE(file.Open(path));
+  uint8_t header[44];
+  ASSERT_EQ(44, file.Read(header, sizeof(header)));
+  file.Close();
+  XFILE::CFile::Delete(path);
+
+  EXPECT_EQ(0, memcmp(header, "RIFF", 4));
+  EXPECT_EQ(0, memcmp(header + 8, "WAVEfmt ", 8));
+  EXPECT_EQ(1, header[20]);              // PCM
+  EXPECT_EQ(2, header[22]);              // channels
+  EXPECT_EQ(16, header[34]);             // bits
+  const uint32_t dataSize = header[40] | header[41] << 8 | header[42] << 16 | header[43] << 24;
+  EXPECT_EQ(960U * 4, dataSize);
+}
+
+TEST(TestAESinkNULL, WaveFileExtensible)
+{
+  const std::string path = "special://temp/aesinknull71.wav";
+  {
+    CTestAESinkNULL sink;
+    std::string device = path;
+    AEAudioFormat format = MakeFormat(AE_FMT_RAW, 192000);
+    format.m_streamInfo.m_type = CAEStreamInfo::STREAM_TYPE_TRUEHD;
+    ASSERT_TRUE(sink.Initialize(format, device));
+
+    std::vector<uint8_t> buffer;
+    EXPECT_EQ(480U, Add(sink, buffer, 480, format.m_frameSize));
+    sink.Deinitialize();
+  }
+
+  XFILE::CFile file;
+  ASSERT_TRUE(file.Open(path));
+  uint8_t header[68];
+  ASSERT_EQ(68, file.Read(header, sizeof(header)));
+  file.Close();
+  XFILE::CFile::Delete(path);
+
+  EXPECT_EQ(40, header[16]);             // format chunk size
+  EXPECT_EQ(0xFE, header[20]);           // WAVE_FORMAT_EXTENSIBLE
+  EXPECT_EQ(0xFF, header[21]);
+  EXPECT_EQ(8, header[22]);              // channels
+  EXPECT_EQ(16, header[34]);             // bits
+  EXPECT_EQ(22, header[36]);             // extension size
+  const uint32_t mask = header[40] | header[41] << 8 | header[42] << 16 | header[43] << 24;
+  EXPECT_EQ(0x63FU, mask);               // 7.1 with side surrounds
+  EXPECT_EQ(1, header[44]);              // PCM sub format
+  EXPECT_EQ(0, memcmp(header + 60, "data", 4));
+  const uint32_t dataSize = header[64] | header[65] << 8 | header[66] << 16 | header[67] << 24;
+  EXPECT_EQ(480U * 16, dataSize);
+}
+
+// Pushes a minute of 7.1 float audio through a freewheeling device clock,
+// run with --gtest_also_run_disabled_tests to get numbers.
+TEST(TestAESinkNULL, DISABLED_Benchmark)
+{
+  CTestAESinkNULL sink;
+  std::string device = "null";
+  AEAudioFormat format = MakeFormat(AE_FMT_FLOAT);
+  format.m_channelLayout = AE_CH_LAYOUT_7_1;
+  ASSERT_TRUE(sink.Initialize(format, device));
+
+  std::vector<uint8_t> buffer;
+  const uint64_t total = 60 * format.m_sampleRate;
+  auto start = std::chrono::steady_clock::now();
+  while (sink.GetFramesWritten() < total)
+  {
+    AEDelayStatus status;
+    sink.GetDelay(status);
+    Add(sink, buffer, format.m_frames, format.m_frameSize);
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "60 s of audio in " << elapsed * 1000 << " ms, "
+            << 60.0 / elapsed << "x realtime, device clock at "
+            << sink.Now() / 1000000 << " ms" << std::endl;
+  EXPECT_EQ(0U, sink.GetUnderruns());
+}
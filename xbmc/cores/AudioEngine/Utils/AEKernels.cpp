@@ -0,0 +1,657 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEKernels.h"
+#include "utils/CPUInfo.h"
+
+#include <math.h>
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(HAS_NEON) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define AE_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+/*
+ * Note: this file and AEKernelsAVX2.cpp are built with -ffp-contract=off,
+ * otherwise the compiler may fuse multiply and add in one variant but not
+ * in another and the results would no longer be bit identical.
+ */
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// C reference
+//-----------------------------------------------------------------------------
+
+inline float SoftClampC(float x)
+{
+  if (x < -3.0f)
+    return -1.0f;
+  else if (x > 3.0f)
+    return 1.0f;
+  float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+inline int16_t FloatToS16C(float x)
+{
+  float v = x * 32768.0f;
+  if (!(v > -32768.0f))
+    return INT16_MIN;
+  if (v > 32767.0f)
+    return INT16_MAX;
+  return (int16_t)lrintf(v);
+}
+
+inline int32_t FloatToS32C(float x)
+{
+  float v = x * 2147483648.0f;
+  if (v >= 2147483648.0f)
+    return INT32_MAX;
+  if (!(v > -2147483648.0f))
+    return INT32_MIN;
+  return (int32_t)lrintf(v);
+}
+
+void MulArrayC(float *data, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] *= mul;
+}
+
+void MulAddArrayC(float *data, const float *add, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] += add[i] * mul;
+}
+
+void MulFramesC(float *data, const float *gains, uint32_t channels, uint32_t frames)
+{
+  for (uint32_t f = 0; f < frames; ++f, data += channels)
+    MulArrayC(data, gains[f], channels);
+}
+
+void MulAddFramesC(float *data, const float *add, const float *gains, uint32_t channels, uint32_t frames)
+{
+  for (uint32_t f = 0; f < frames; ++f, data += channels, add += channels)
+    MulAddArrayC(data, add, gains[f], channels);
+}
+
+void ClampArrayC(float *data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] = SoftClampC(data[i]);
+}
+
+float PeakArrayC(const float *data, uint32_t count)
+{
+  float peak = 0.0f;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    float v = fabsf(data[i]);
+    if (v > peak)
+      peak = v;
+  }
+  return peak;
+}
+
+// adds the elements the vector loop left over and sums up the lanes
+float DotProductTail(float *lanes, const float *a, const float *b, uint32_t i, uint32_t count)
+{
+  for (; i < count; ++i)
+    lanes[i & 7] += a[i] * b[i];
+  float s0 = lanes[0] + lanes[4];
+  float s1 = lanes[1] + lanes[5];
+  float s2 = lanes[2] + lanes[6];
+  float s3 = lanes[3] + lanes[7];
+  return (s0 + s2) + (s1 + s3);
+}
+
+float DotProductC(const float *a, const float *b, uint32_t count)
+{
+  float lanes[8] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+  return DotProductTail(lanes, a, b, 0, count);
+}
+
+void FloatToS16C(int16_t *dst, const float *src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = FloatToS16C(src[i]);
+}
+
+void FloatToS32C(int32_t *dst, const float *src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = FloatToS32C(src[i]);
+}
+
+void S16ToFloatC(float *dst, const int16_t *src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = (float)src[i] * (1.0f / 32768.0f);
+}
+
+void S32ToFloatC(float *dst, const int32_t *src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = (float)src[i] * (1.0f / 2147483648.0f);
+}
+
+const CAEKernels::Table kernelsC =
+{
+  CAEKernels::ISA_C,
+  MulArrayC,
+  MulAddArrayC,
+  MulFramesC,
+  MulAddFramesC,
+  ClampArrayC,
+  PeakArrayC,
+  DotProductC,
+  FloatToS16C,
+  FloatToS32C,
+  S16ToFloatC,
+  S32ToFloatC
+};
+
+//-----------------------------------------------------------------------------
+// SSE
+//-----------------------------------------------------------------------------
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+void MulArraySSE(float *data, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+  MulArrayC(data + i, mul, count - i);
+}
+
+void MulAddArraySSE(float *data, const float *add, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 to = _mm_loadu_ps(data + i);
+    __m128 ad = _mm_loadu_ps(add + i);
+    _mm_storeu_ps(data + i, _mm_add_ps(to, _mm_mul_ps(ad, m)));
+  }
+  MulAddArrayC(data + i, add + i, mul, count - i);
+}
+
+void MulFramesSSE(float *data, const float *gains, uint32_t channels, uint32_t frames)
+{
+  if (channels == 1)
+  {
+    uint32_t i = 0;
+    for (; i + 4 <= frames; i += 4)
+      _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(gains + i)));
+    MulFramesC(data + i, gains + i, 1, frames - i);
+    return;
+  }
+  for (uint32_t f = 0; f < frames; ++f, data += channels)
+    MulArraySSE(data, gains[f], channels);
+}
+
+void MulAddFramesSSE(float *data, const float *add, const float *gains, uint32_t channels, uint32_t frames)
+{
+  if (channels == 1)
+  {
+    uint32_t i = 0;
+    for (; i + 4 <= frames; i += 4)
+    {
+      __m128 to = _mm_loadu_ps(data + i);
+      __m128 ad = _mm_loadu_ps(add + i);
+      _mm_storeu_ps(data + i, _mm_add_ps(to, _mm_mul_ps(ad, _mm_loadu_ps(gains + i))));
+    }
+    MulAddFramesC(data + i, add + i, gains + i, 1, frames - i);
+    return;
+  }
+  for (uint32_t f = 0; f < frames; ++f, data += channels, add += channels)
+    MulAddArraySSE(data, add, gains[f], channels);
+}
+
+void ClampArraySSE(float *data, uint32_t count)
+{
+  const __m128 c27 = _mm_set1_ps(27.0f);
+  const __m128 c9 = _mm_set1_ps(9.0f);
+  const __m128 c3 = _mm_set1_ps(3.0f);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 x = _mm_loadu_ps(data + i);
+    __m128 y = _mm_mul_ps(x, x);
+    __m128 r = _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(c27, y)),
+                          _mm_add_ps(c27, _mm_mul_ps(c9, y)));
+    // |x| > 3 saturates to +-1
+    __m128 big = _mm_cmpgt_ps(_mm_andnot_ps(sign, x), c3);
+    __m128 sat = _mm_or_ps(_mm_and_ps(x, sign), one);
+    _mm_storeu_ps(data + i, _mm_or_ps(_mm_and_ps(big, sat), _mm_andnot_ps(big, r)));
+  }
+  ClampArrayC(data + i, count - i);
+}
+
+float PeakArraySSE(const float *data, uint32_t count)
+{
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  __m128 peak = _mm_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // _mm_max_ps returns its second operand for NaN which keeps the peak
+    peak = _mm_max_ps(_mm_andnot_ps(sign, _mm_loadu_ps(data + i)), peak);
+  }
+  peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+  peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, 1));
+  float result = _mm_cvtss_f32(peak);
+  float tail = PeakArrayC(data + i, count - i);
+  return tail > result ? tail : result;
+}
+
+float DotProductSSE(const float *a, const float *b, uint32_t count)
+{
+  // two registers make up the 8 lanes of the C reference
+  __m128 lo = _mm_setzero_ps();
+  __m128 hi = _mm_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    lo = _mm_add_ps(lo, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    hi = _mm_add_ps(hi, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  float lanes[8];
+  _mm_storeu_ps(lanes, lo);
+  _mm_storeu_ps(lanes + 4, hi);
+  return DotProductTail(lanes, a, b, i, count);
+}
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+void FloatToS16SSE(int16_t *dst, const float *src, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(32768.0f);
+  const __m128 lo = _mm_set1_ps(-32768.0f);
+  const __m128 hi = _mm_set1_ps(32767.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128 a = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+    __m128 b = _mm_mul_ps(_mm_loadu_ps(src + i + 4), scale);
+    a = _mm_min_ps(_mm_max_ps(a, lo), hi);
+    b = _mm_min_ps(_mm_max_ps(b, lo), hi);
+    __m128i s = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+  }
+  FloatToS16C(dst + i, src + i, count - i);
+}
+
+void FloatToS32SSE(int32_t *dst, const float *src, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+    // cvtps2dq yields 0x80000000 on positive overflow, flip it to INT32_MAX
+    __m128i over = _mm_castps_si128(_mm_cmpge_ps(v, scale));
+    __m128i s = _mm_xor_si128(_mm_cvtps_epi32(v), over);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+  }
+  FloatToS32C(dst + i, src + i, count - i);
+}
+
+void S16ToFloatSSE(float *dst, const int16_t *src, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i a = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+    __m128i b = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(a), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(b), scale));
+  }
+  S16ToFloatC(dst + i, src + i, count - i);
+}
+
+void S32ToFloatSSE(float *dst, const int32_t *src, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(s), scale));
+  }
+  S32ToFloatC(dst + i, src + i, count - i);
+}
+#endif
+
+const CAEKernels::Table kernelsSSE =
+{
+  CAEKernels::ISA_SSE,
+  MulArraySSE,
+  MulAddArraySSE,
+  MulFramesSSE,
+  MulAddFramesSSE,
+  ClampArraySSE,
+  PeakArraySSE,
+  DotProductSSE,
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  FloatToS16SSE,
+  FloatToS32SSE,
+  S16ToFloatSSE,
+  S32ToFloatSSE
+#else
+  FloatToS16C,
+  FloatToS32C,
+  S16ToFloatC,
+  S32ToFloatC
+#endif
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// NEON
+//-----------------------------------------------------------------------------
+
+#if defined(AE_KERNELS_NEON)
+void MulArrayNEON(float *data, float mul, uint32_t count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), m));
+  MulArrayC(data + i, mul, count - i);
+}
+
+void MulAddArrayNEON(float *data, const float *add, float mul, uint32_t count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // separate mul and add, vmla/vfma would round differently from C
+    float32x4_t ad = vmulq_f32(vld1q_f32(add + i), m);
+    vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), ad));
+  }
+  MulAddArrayC(data + i, add + i, mul, count - i);
+}
+
+void MulFramesNEON(float *data, const float *gains, uint32_t channels, uint32_t frames)
+{
+  if (channels == 1)
+  {
+    uint32_t i = 0;
+    for (; i + 4 <= frames; i += 4)
+      vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), vld1q_f32(gains + i)));
+    MulFramesC(data + i, gains + i, 1, frames - i);
+    return;
+  }
+  for (uint32_t f = 0; f < frames; ++f, data += channels)
+    MulArrayNEON(data, gains[f], channels);
+}
+
+void MulAddFramesNEON(float *data, const float *add, const float *gains, uint32_t channels, uint32_t frames)
+{
+  if (channels == 1)
+  {
+    uint32_t i = 0;
+    for (; i + 4 <= frames; i += 4)
+    {
+      float32x4_t ad = vmulq_f32(vld1q_f32(add + i), vld1q_f32(gains + i));
+      vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), ad));
+    }
+    MulAddFramesC(data + i, add + i, gains + i, 1, frames - i);
+    return;
+  }
+  for (uint32_t f = 0; f < frames; ++f, data += channels, add += channels)
+    MulAddArrayNEON(data, add, gains[f], channels);
+}
+
+float PeakArrayNEON(const float *data, uint32_t count)
+{
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // compare and select instead of vmax, which propagates NaN
+    float32x4_t v = vabsq_f32(vld1q_f32(data + i));
+    peak = vbslq_f32(vcgtq_f32(v, peak), v, peak);
+  }
+  float lanes[4];
+  vst1q_f32(lanes, peak);
+  float result = PeakArrayC(lanes, 4);
+  float tail = PeakArrayC(data + i, count - i);
+  return tail > result ? tail : result;
+}
+
+float DotProductNEON(const float *a, const float *b, uint32_t count)
+{
+  // separate multiply and add, vmla may be fused
+  float32x4_t lo = vdupq_n_f32(0.0f);
+  float32x4_t hi = vdupq_n_f32(0.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    lo = vaddq_f32(lo, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    hi = vaddq_f32(hi, vmulq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4)));
+  }
+  float lanes[8];
+  vst1q_f32(lanes, lo);
+  vst1q_f32(lanes + 4, hi);
+  return DotProductTail(lanes, a, b, i, count);
+}
+
+#if defined(__aarch64__)
+// AArch64 has an exact divide and round to nearest conversions, ARMv7 NEON
+// only has estimates and truncation so those kernels stay in C there.
+void ClampArrayNEON(float *data, uint32_t count)
+{
+  const float32x4_t c27 = vdupq_n_f32(27.0f);
+  const float32x4_t c9 = vdupq_n_f32(9.0f);
+  const float32x4_t c3 = vdupq_n_f32(3.0f);
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t x = vld1q_f32(data + i);
+    float32x4_t y = vmulq_f32(x, x);
+    float32x4_t r = vdivq_f32(vmulq_f32(x, vaddq_f32(c27, y)),
+                              vaddq_f32(c27, vmulq_f32(c9, y)));
+    uint32x4_t big = vcagtq_f32(x, c3);
+    float32x4_t sat = vbslq_f32(vdupq_n_u32(0x80000000), x, one);
+    vst1q_f32(data + i, vbslq_f32(big, sat, r));
+  }
+  ClampArrayC(data + i, count - i);
+}
+
+void FloatToS16NEON(int16_t *dst, const float *src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(32768.0f);
+  const float32x4_t lo = vdupq_n_f32(-32768.0f);
+  const float32x4_t hi = vdupq_n_f32(32767.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    float32x4_t a = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i), scale), lo), hi);
+    float32x4_t b = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i + 4), scale), lo), hi);
+    int16x8_t s = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b)));
+    vst1q_s16(dst + i, s);
+  }
+  FloatToS16C(dst + i, src + i, count - i);
+}
+
+void FloatToS32NEON(int32_t *dst, const float *src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // fcvtns saturates on its own
+    vst1q_s32(dst + i, vcvtnq_s32_f32(vmulq_f32(vld1q_f32(src + i), scale)));
+  }
+  FloatToS32C(dst + i, src + i, count - i);
+}
+#endif
+
+void S16ToFloatNEON(float *dst, const int16_t *src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    int16x8_t s = vld1q_s16(src + i);
+    float32x4_t a = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+    float32x4_t b = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+    vst1q_f32(dst + i, vmulq_f32(a, scale));
+    vst1q_f32(dst + i + 4, vmulq_f32(b, scale));
+  }
+  S16ToFloatC(dst + i, src + i, count - i);
+}
+
+void S32ToFloatNEON(float *dst, const int32_t *src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(1.0f / 2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(src + i)), scale));
+  S32ToFloatC(dst + i, src + i, count - i);
+}
+
+const CAEKernels::Table kernelsNEON =
+{
+  CAEKernels::ISA_NEON,
+  MulArrayNEON,
+  MulAddArrayNEON,
+  MulFramesNEON,
+  MulAddFramesNEON,
+#if defined(__aarch64__)
+  ClampArrayNEON,
+#else
+  ClampArrayC,
+#endif
+  PeakArrayNEON,
+  DotProductNEON,
+#if defined(__aarch64__)
+  FloatToS16NEON,
+  FloatToS32NEON,
+#else
+  FloatToS16C,
+  FloatToS32C,
+#endif
+  S16ToFloatNEON,
+  S32ToFloatNEON
+};
+#endif
+
+}
+
+//-----------------------------------------------------------------------------
+// Dispatch
+//-----------------------------------------------------------------------------
+
+const CAEKernels::Table* CAEKernels::GetSSE()
+{
+#if defined(HAVE_SSE) && defined(__SSE__)
+  return &kernelsSSE;
+#else
+  return nullptr;
+#endif
+}
+
+const CAEKernels::Table* CAEKernels::GetNEON()
+{
+#if defined(AE_KERNELS_NEON)
+  return &kernelsNEON;
+#else
+  return nullptr;
+#endif
+}
+
+const CAEKernels::Table* CAEKernels::Get(Isa isa)
+{
+  unsigned int features = g_cpuInfo.GetCPUFeatures();
+  switch (isa)
+  {
+  case ISA_C:
+    return &kernelsC;
+  case ISA_SSE:
+    // built with -msse, so the check only matters for the SSE2 conversions
+    if ((features & CPU_FEATURE_SSE2) == 0)
+      return nullptr;
+    return GetSSE();
+  case ISA_AVX2:
+    if ((features & CPU_FEATURE_AVX2) == 0)
+      return nullptr;
+    return GetAVX2();
+  case ISA_NEON:
+#if !defined(__aarch64__)
+    if ((features & CPU_FEATURE_NEON) == 0)
+      return nullptr;
+#endif
+    return GetNEON();
+  default:
+    return nullptr;
+  }
+}
+
+const CAEKernels::Table& CAEKernels::Get()
+{
+  static const Table* best = []()
+  {
+    const Isa order[] = { ISA_AVX2, ISA_NEON, ISA_SSE };
+    for (Isa isa : order)
+    {
+      const Table* table = Get(isa);
+      if (table)
+        return table;
+    }
+    return Get(ISA_C);
+  }();
+  return *best;
+}
+
+const char* CAEKernels::GetIsaName(Isa isa)
+{
+  switch (isa)
+  {
+  case ISA_C:
+    return "C";
+  case ISA_SSE:
+    return "SSE";
+  case ISA_AVX2:
+    return "AVX2";
+  case ISA_NEON:
+    return "NEON";
+  default:
+    return "unknown";
+  }
+}
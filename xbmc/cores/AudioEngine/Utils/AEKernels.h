@@ -0,0 +1,95 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+/*!
+ * \brief Vectorized sample kernels used by ActiveAE for mixing, volume,
+ * clamping and float <-> integer packing.
+ *
+ * Every kernel exists as a plain C reference and, where the platform has it,
+ * as SSE, AVX2 and NEON variants. The variant is chosen once at runtime from
+ * the CPU features, so a single binary can use AVX2 on machines which have
+ * it without requiring it everywhere.
+ *
+ * All variants produce bit identical results to the C reference for finite
+ * input: they use the same operation order, never fuse multiply and add and
+ * round to nearest when converting to integers. NaN input yields an
+ * unspecified but valid sample.
+ */
+class CAEKernels
+{
+public:
+  enum Isa
+  {
+    ISA_C = 0,
+    ISA_SSE,
+    ISA_AVX2,
+    ISA_NEON,
+    ISA_MAX
+  };
+
+  struct Table
+  {
+    Isa isa;
+
+    /*! data[i] *= mul */
+    void (*MulArray)(float *data, float mul, uint32_t count);
+    /*! data[i] += add[i] * mul */
+    void (*MulAddArray)(float *data, const float *add, float mul, uint32_t count);
+    /*! data[f * channels + c] *= gains[f], used for volume ramps and the limiter */
+    void (*MulFrames)(float *data, const float *gains, uint32_t channels, uint32_t frames);
+    /*! data[f * channels + c] += add[f * channels + c] * gains[f] */
+    void (*MulAddFrames)(float *data, const float *add, const float *gains, uint32_t channels, uint32_t frames);
+    /*! soft clamp to [-1, 1], see CAEUtil::SoftClamp */
+    void (*ClampArray)(float *data, uint32_t count);
+    /*! largest absolute value, 0 for an empty array */
+    float (*PeakArray)(const float *data, uint32_t count);
+    /*! sum of a[i] * b[i], accumulated in 8 lanes (element i goes to lane i % 8)
+     *  which are summed up in a fixed order, used for FIR filters */
+    float (*DotProduct)(const float *a, const float *b, uint32_t count);
+
+    /*! float [-1, 1) to S16 with saturation, same scaling as swresample */
+    void (*FloatToS16)(int16_t *dst, const float *src, uint32_t count);
+    /*! float [-1, 1) to S32 with saturation, S24 formats are derived from it */
+    void (*FloatToS32)(int32_t *dst, const float *src, uint32_t count);
+    void (*S16ToFloat)(float *dst, const int16_t *src, uint32_t count);
+    void (*S32ToFloat)(float *dst, const int32_t *src, uint32_t count);
+  };
+
+  /*!
+   * \brief kernels for the best instruction set of this CPU
+   */
+  static const Table& Get();
+
+  /*!
+   * \brief kernels for a given instruction set
+   * \return NULL if the set was not compiled in or is not supported by the CPU
+   */
+  static const Table* Get(Isa isa);
+
+  static const char* GetIsaName(Isa isa);
+
+private:
+  static const Table* GetSSE();
+  static const Table* GetAVX2();
+  static const Table* GetNEON();
+};
@@ -0,0 +1,306 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEKernels.h"
+
+#if defined(__AVX2__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define AE_KERNELS_AVX2
+#include <immintrin.h>
+#include <math.h>
+#endif
+
+/*
+ * This file is the only one built with -mavx2. It must not instantiate inline
+ * functions or templates shared with other files, the linker could pick the
+ * AVX2 copy for callers running on CPUs without it. Tails are therefore
+ * handled by local helpers instead of the C kernels in AEKernels.cpp.
+ */
+
+#if defined(AE_KERNELS_AVX2)
+namespace
+{
+
+inline float SoftClampAVX2(float x)
+{
+  if (x < -3.0f)
+    return -1.0f;
+  else if (x > 3.0f)
+    return 1.0f;
+  float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+void MulArrayAVX2(float *data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  for (; i < count; ++i)
+    data[i] *= mul;
+}
+
+void MulAddArrayAVX2(float *data, const float *add, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 to = _mm256_loadu_ps(data + i);
+    __m256 ad = _mm256_loadu_ps(add + i);
+    _mm256_storeu_ps(data + i, _mm256_add_ps(to, _mm256_mul_ps(ad, m)));
+  }
+  for (; i < count; ++i)
+    data[i] += add[i] * mul;
+}
+
+void MulFramesAVX2(float *data, const float *gains, uint32_t channels, uint32_t frames)
+{
+  if (channels == 1)
+  {
+    uint32_t i = 0;
+    for (; i + 8 <= frames; i += 8)
+      _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_loadu_ps(gains + i)));
+    for (; i < frames; ++i)
+      data[i] *= gains[i];
+    return;
+  }
+  if (channels == 2)
+  {
+    // four stereo frames per register, gains duplicated as g0 g0 g1 g1 ...
+    const __m256i dup = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    uint32_t f = 0;
+    for (; f + 4 <= frames; f += 4, data += 8)
+    {
+      __m256 g = _mm256_permutevar8x32_ps(_mm256_castps128_ps256(_mm_loadu_ps(gains + f)), dup);
+      _mm256_storeu_ps(data, _mm256_mul_ps(_mm256_loadu_ps(data), g));
+    }
+    for (; f < frames; ++f, data += 2)
+    {
+      data[0] *= gains[f];
+      data[1] *= gains[f];
+    }
+    return;
+  }
+  for (uint32_t f = 0; f < frames; ++f, data += channels)
+    MulArrayAVX2(data, gains[f], channels);
+}
+
+void MulAddFramesAVX2(float *data, const float *add, const float *gains, uint32_t channels, uint32_t frames)
+{
+  if (channels == 1)
+  {
+    uint32_t i = 0;
+    for (; i + 8 <= frames; i += 8)
+    {
+      __m256 to = _mm256_loadu_ps(data + i);
+      __m256 ad = _mm256_mul_ps(_mm256_loadu_ps(add + i), _mm256_loadu_ps(gains + i));
+      _mm256_storeu_ps(data + i, _mm256_add_ps(to, ad));
+    }
+    for (; i < frames; ++i)
+      data[i] += add[i] * gains[i];
+    return;
+  }
+  if (channels == 2)
+  {
+    const __m256i dup = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    uint32_t f = 0;
+    for (; f + 4 <= frames; f += 4, data += 8, add += 8)
+    {
+      __m256 g = _mm256_permutevar8x32_ps(_mm256_castps128_ps256(_mm_loadu_ps(gains + f)), dup);
+      __m256 ad = _mm256_mul_ps(_mm256_loadu_ps(add), g);
+      _mm256_storeu_ps(data, _mm256_add_ps(_mm256_loadu_ps(data), ad));
+    }
+    for (; f < frames; ++f, data += 2, add += 2)
+    {
+      data[0] += add[0] * gains[f];
+      data[1] += add[1] * gains[f];
+    }
+    return;
+  }
+  for (uint32_t f = 0; f < frames; ++f, data += channels, add += channels)
+    MulAddArrayAVX2(data, add, gains[f], channels);
+}
+
+void ClampArrayAVX2(float *data, uint32_t count)
+{
+  const __m256 c27 = _mm256_set1_ps(27.0f);
+  const __m256 c9 = _mm256_set1_ps(9.0f);
+  const __m256 c3 = _mm256_set1_ps(3.0f);
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_loadu_ps(data + i);
+    __m256 y = _mm256_mul_ps(x, x);
+    __m256 r = _mm256_div_ps(_mm256_mul_ps(x, _mm256_add_ps(c27, y)),
+                             _mm256_add_ps(c27, _mm256_mul_ps(c9, y)));
+    __m256 big = _mm256_cmp_ps(_mm256_andnot_ps(sign, x), c3, _CMP_GT_OQ);
+    __m256 sat = _mm256_or_ps(_mm256_and_ps(x, sign), one);
+    _mm256_storeu_ps(data + i, _mm256_blendv_ps(r, sat, big));
+  }
+  for (; i < count; ++i)
+    data[i] = SoftClampAVX2(data[i]);
+}
+
+float PeakArrayAVX2(const float *data, uint32_t count)
+{
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+  __m256 peak = _mm256_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    peak = _mm256_max_ps(_mm256_andnot_ps(sign, _mm256_loadu_ps(data + i)), peak);
+  __m128 p = _mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1));
+  p = _mm_max_ps(p, _mm_movehl_ps(p, p));
+  p = _mm_max_ss(p, _mm_shuffle_ps(p, p, 1));
+  float result = _mm_cvtss_f32(p);
+  for (; i < count; ++i)
+  {
+    float v = fabsf(data[i]);
+    if (v > result)
+      result = v;
+  }
+  return result;
+}
+
+float DotProductAVX2(const float *a, const float *b, uint32_t count)
+{
+  __m256 sum = _mm256_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  float lanes[8];
+  _mm256_storeu_ps(lanes, sum);
+  // same tail and summation order as the C reference
+  for (; i < count; ++i)
+    lanes[i & 7] += a[i] * b[i];
+  float s0 = lanes[0] + lanes[4];
+  float s1 = lanes[1] + lanes[5];
+  float s2 = lanes[2] + lanes[6];
+  float s3 = lanes[3] + lanes[7];
+  return (s0 + s2) + (s1 + s3);
+}
+
+void FloatToS16AVX2(int16_t *dst, const float *src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(32768.0f);
+  const __m256 lo = _mm256_set1_ps(-32768.0f);
+  const __m256 hi = _mm256_set1_ps(32767.0f);
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256 a = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+    __m256 b = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale);
+    a = _mm256_min_ps(_mm256_max_ps(a, lo), hi);
+    b = _mm256_min_ps(_mm256_max_ps(b, lo), hi);
+    // packs works per 128 bit lane, restore sample order afterwards
+    __m256i s = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+    s = _mm256_permute4x64_epi64(s, _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), s);
+  }
+  for (; i < count; ++i)
+  {
+    float v = src[i] * 32768.0f;
+    if (!(v > -32768.0f))
+      dst[i] = INT16_MIN;
+    else if (v > 32767.0f)
+      dst[i] = INT16_MAX;
+    else
+      dst[i] = (int16_t)lrintf(v);
+  }
+}
+
+void FloatToS32AVX2(int32_t *dst, const float *src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 v = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+    __m256i over = _mm256_castps_si256(_mm256_cmp_ps(v, scale, _CMP_GE_OQ));
+    __m256i s = _mm256_xor_si256(_mm256_cvtps_epi32(v), over);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), s);
+  }
+  for (; i < count; ++i)
+  {
+    float v = src[i] * 2147483648.0f;
+    if (v >= 2147483648.0f)
+      dst[i] = INT32_MAX;
+    else if (!(v > -2147483648.0f))
+      dst[i] = INT32_MIN;
+    else
+      dst[i] = (int32_t)lrintf(v);
+  }
+}
+
+void S16ToFloatAVX2(float *dst, const int16_t *src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i s = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+  }
+  for (; i < count; ++i)
+    dst[i] = (float)src[i] * (1.0f / 32768.0f);
+}
+
+void S32ToFloatAVX2(float *dst, const int32_t *src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / 2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+  }
+  for (; i < count; ++i)
+    dst[i] = (float)src[i] * (1.0f / 2147483648.0f);
+}
+
+const CAEKernels::Table kernelsAVX2 =
+{
+  CAEKernels::ISA_AVX2,
+  MulArrayAVX2,
+  MulAddArrayAVX2,
+  MulFramesAVX2,
+  MulAddFramesAVX2,
+  ClampArrayAVX2,
+  PeakArrayAVX2,
+  DotProductAVX2,
+  FloatToS16AVX2,
+  FloatToS32AVX2,
+  S16ToFloatAVX2,
+  S32ToFloatAVX2
+};
+
+}
+#endif
+
+const CAEKernels::Table* CAEKernels::GetAVX2()
+{
+#if defined(AE_KERNELS_AVX2)
+  return &kernelsAVX2;
+#else
+  return nullptr;
+#endif
+}
@@ -0,0 +1,89 @@
+/*
+ *      Copyright (C) 2010-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AELatencyStats.h"
+
+void CAELatencyHistogram::Add(int64_t us)
+{
+  if (us < 0)
+    us = 0;
+
+  int bucket = 0;
+  while (bucket < BUCKETS - 1 && us >= GetBucketLimit(bucket))
+    bucket++;
+
+  m_buckets[bucket]++;
+  m_count++;
+  m_total += us;
+  if (us > m_max)
+    m_max = us;
+}
+
+void CAELatencyHistogram::Merge(const CAELatencyHistogram &other)
+{
+  for (int i = 0; i < BUCKETS; i++)
+    m_buckets[i] += other.m_buckets[i];
+  m_count += other.m_count;
+  m_total += other.m_total;
+  if (other.m_max > m_max)
+    m_max = other.m_max;
+}
+
+int64_t CAELatencyHistogram::GetBucketLimit(int bucket)
+{
+  if (bucket >= BUCKETS - 1)
+    return -1;
+  return static_cast<int64_t>(16) << bucket;
+}
+
+int64_t CAELatencyHistogram::GetPercentile(double percentile) const
+{
+  if (m_count == 0)
+    return 0;
+
+  double target = m_count * percentile / 100.0;
+  uint64_t count = 0;
+  for (int i = 0; i < BUCKETS - 1; i++)
+  {
+    count += m_buckets[i];
+    if (count >= target)
+      return GetBucketLimit(i);
+  }
+  return m_max;
+}
+
+const char *AELatencyStats::GetStageName(AEStage stage)
+{
+  switch (stage)
+  {
+  case AE_STAGE_INPUT:
+    return "input";
+  case AE_STAGE_RESAMPLE:
+    return "resample";
+  case AE_STAGE_MIX:
+    return "mix";
+  case AE_STAGE_ENCODE:
+    return "encode";
+  case AE_STAGE_SINK:
+    return "sink";
+  default:
+    return "unknown";
+  }
+}
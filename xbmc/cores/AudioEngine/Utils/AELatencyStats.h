@@ -0,0 +1,90 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <vector>
+
+enum AEStage
+{
+  AE_STAGE_INPUT = 0,
+  AE_STAGE_RESAMPLE,
+  AE_STAGE_MIX,
+  AE_STAGE_ENCODE,
+  AE_STAGE_SINK,
+  AE_STAGE_MAX
+};
+
+/*!
+ * \brief Histogram of processing times with power of two buckets.
+ *
+ * Bucket 0 counts times below 16us, bucket i times below 16us << i and the
+ * last bucket everything longer. Counters are never reset, readers take
+ * differences between two snapshots.
+ */
+class CAELatencyHistogram
+{
+public:
+  static const int BUCKETS = 16;
+
+  void Add(int64_t us);
+  /*! add the counts of another histogram to this one */
+  void Merge(const CAELatencyHistogram &other);
+  uint64_t GetCount() const { return m_count; }
+  int64_t GetTotal() const { return m_total; }
+  int64_t GetMax() const { return m_max; }
+  uint64_t GetBucket(int bucket) const { return m_buckets[bucket]; }
+  /*! upper limit of a bucket in us, -1 for the last one */
+  static int64_t GetBucketLimit(int bucket);
+  /*! upper limit of the bucket holding the given percentile (0-100) */
+  int64_t GetPercentile(double percentile) const;
+
+private:
+  uint64_t m_buckets[BUCKETS] = {};
+  uint64_t m_count = 0;
+  int64_t m_total = 0;
+  int64_t m_max = 0;
+};
+
+struct AEStreamLatencyStats
+{
+  unsigned int id;
+  double bufferedTime;  // ms of audio between the stream and the mixer
+  double syncError;     // ms
+  double resampleRatio;
+  int syncState;        // CAESyncInfo::AESyncState
+};
+
+/*!
+ * \brief Snapshot of the audio engine's timing, published by the engine
+ * through CDataCacheCore.
+ */
+struct AELatencyStats
+{
+  CAELatencyHistogram stages[AE_STAGE_MAX];
+  double engineBufferedTime = 0.0;  // ms mixed but not yet taken by the sink
+  double sinkDelay = 0.0;           // ms until a sample written now is heard
+  double sinkCacheTotal = 0.0;      // ms the sink buffers at most
+  uint64_t streamUnderruns = 0;     // a playing stream ran out of samples
+  uint64_t sinkUnderruns = 0;       // the sink had to play silence
+  std::vector<AEStreamLatencyStats> streams;
+
+  static const char *GetStageName(AEStage stage);
+};
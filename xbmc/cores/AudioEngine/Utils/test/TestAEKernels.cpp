@@ -0,0 +1,321 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+// odd size and offsets so every variant runs through its unaligned head
+// and its scalar tail as well as the vector loop
+const uint32_t SAMPLES = 1021;
+
+std::vector<float> MakeSignal(uint32_t count, float range, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(-range, range);
+  std::vector<float> data(count);
+  for (auto& v : data)
+    v = dist(gen);
+  // values on the edges of clamping and saturation
+  const float edges[] = { 0.0f, -0.0f, 1.0f, -1.0f, 3.0f, -3.0f, 3.5f, -3.5f,
+                          0.99999994f, -0.99999994f, 1.5f, -1.5f, 1e10f, -1e10f };
+  for (unsigned int i = 0; i < sizeof(edges) / sizeof(edges[0]) && i < count; i++)
+    data[(i * 71) % count] = edges[i];
+  return data;
+}
+
+std::vector<const CAEKernels::Table*> GetVariants()
+{
+  std::vector<const CAEKernels::Table*> variants;
+  for (int isa = CAEKernels::ISA_C + 1; isa < CAEKernels::ISA_MAX; isa++)
+  {
+    const CAEKernels::Table* table = CAEKernels::Get(static_cast<CAEKernels::Isa>(isa));
+    if (table)
+      variants.push_back(table);
+  }
+  return variants;
+}
+
+template<typename T>
+void ExpectBitExact(const std::vector<T>& ref, const std::vector<T>& out, const CAEKernels::Table* table)
+{
+  ASSERT_EQ(ref.size(), out.size());
+  EXPECT_EQ(0, memcmp(ref.data(), out.data(), ref.size() * sizeof(T)))
+    << CAEKernels::GetIsaName(table->isa);
+}
+
+}
+
+TEST(TestAEKernels, Dispatch)
+{
+  const CAEKernels::Table* c = CAEKernels::Get(CAEKernels::ISA_C);
+  ASSERT_NE(nullptr, c);
+  EXPECT_EQ(CAEKernels::ISA_C, c->isa);
+
+  const CAEKernels::Table& best = CAEKernels::Get();
+  EXPECT_EQ(&best, CAEKernels::Get(best.isa));
+}
+
+TEST(TestAEKernels, MulArray)
+{
+  const CAEKernels::Table* c = CAEKernels::Get(CAEKernels::ISA_C);
+  std::vector<float> src = MakeSignal(SAMPLES, 2.0f, 1);
+
+  for (auto table : GetVariants())
+  {
+    for (uint32_t offset = 0; offset < 4; offset++)
+    {
+      std::vector<float> ref(src.begin() + offset, src.end());
+      std::vector<float> out(ref);
+      c->MulArray(ref.data(), 0.7071f, ref.size());
+      table->MulArray(out.data(), 0.7071f, out.size());
+      ExpectBitExact(ref, out, table);
+    }
+  }
+}
+
+TEST(TestAEKernels, MulAddArray)
+{
+  const CAEKernels::Table* c = CAEKernels::Get(CAEKernels::ISA_C);
+  std::vector<float> dst = MakeSignal(SAMPLES, 1.0f, 2);
+  std::vector<float> add = MakeSignal(SAMPLES, 1.0f, 3);
+
+  for (auto table : GetVariants())
+  {
+    for (uint32_t offset = 0; offset < 4; offset++)
+    {
+      std::vector<float> ref(dst.begin() + offset, dst.end());
+      std::vector<float> out(ref);
+      c->MulAddArray(ref.data(), add.data(), 0.3f, ref.size());
+      table->MulAddArray(out.data(), add.data(), 0.3f, out.size());
+      ExpectBitExact(ref, out, table);
+    }
+  }
+}
+
+TEST(TestAEKernels, Frames)
+{
+  const CAEKernels::Table* c = CAEKernels::Get(CAEKernels::ISA_C);
+
+  for (uint32_t channels : { 1, 2, 3, 6, 8 })
+  {
+    const uint32_t frames = 257;
+    std::vector<float> dst = MakeSignal(frames * channels, 1.0f, 4);
+    std::vector<float> add = MakeSignal(frames * channels, 1.0f, 5);
+
+    // a fade in, as CActiveAE builds it
+    std::vector<float> gains(frames);
+    float volume = 0.0f;
+    for (auto& g : gains)
+      g = volume += 1.0f / frames;
+
+    for (auto table : GetVariants())
+    {
+      std::vector<float> ref(dst);
+      std::vector<float> out(dst);
+      c->MulFrames(ref.data(), gains.data(), channels, frames);
+      table->MulFrames(out.data(), gains.data(), channels, frames);
+      ExpectBitExact(ref, out, table);
+
+      c->MulAddFrames(ref.data(), add.data(), gains.data(), channels, frames);
+      table->MulAddFrames(out.data(), add.data(), gains.data(), channels, frames);
+      ExpectBitExact(ref, out, table);
+    }
+  }
+}
+
+TEST(TestAEKernels, ClampArray)
+{
+  const CAEKernels::Table* c = CAEKernels::Get(CAEKernels::ISA_C);
+  std::vector<float> src = MakeSignal(SAMPLES, 4.0f, 6);
+
+  std::vector<float> ref(src);
+  c->ClampArray(ref.data(), ref.size());
+  // the curve peaks at exactly 1 for |x| == 3, allow for rounding around it
+  for (auto v : ref)
+  {
+    EXPECT_LE(v, 1.000001f);
+    EXPECT_GE(v, -1.000001f);
+  }
+
+  for (auto table : GetVariants())
+  {
+    std::vector<float> out(src);
+    table->ClampArray(out.data(), out.size());
+    ExpectBitExact(ref, out, table);
+  }
+}
+
+TEST(TestAEKernels, PeakArray)
+{
+  const CAEKernels::Table* c = CAEKernels::Get(CAEKernels::ISA_C);
+  std::vector<float> src = MakeSignal(SAMPLES, 1.0f, 7);
+  src[SAMPLES - 1] = -1e10f;
+
+  EXPECT_EQ(0.0f, c->PeakArray(src.data(), 0));
+  EXPECT_EQ(1e10f, c->PeakArray(src.data(), src.size()));
+  for (auto table : GetVariants())
+  {
+    for (uint32_t count : { 0U, 1U, 3U, 8U, 17U, SAMPLES - 1, SAMPLES })
+      EXPECT_EQ(c->PeakArray(src.data(), count), table->PeakArray(src.data(), count))
+        << CAEKernels::GetIsaName(table->isa) << " " << count;
+  }
+}
+
+TEST(TestAEKernels, DotProduct)
+{
+  const CAEKernels::Table* c = CAEKernels::Get(CAEKernels::ISA_C);
+  std::vector<float> a = MakeSignal(SAMPLES, 1.0f, 8);
+  std::vector<float> b = MakeSignal(SAMPLES, 1.0f, 9);
+
+  EXPECT_EQ(0.0f, c->DotProduct(a.data(), b.data(), 0));
+  EXPECT_EQ(a[0] * b[0], c->DotProduct(a.data(), b.data(), 1));
+  double exact = 0.0;
+  for (uint32_t i = 0; i < 64; i++)
+    exact += (double)a[i + 1] * b[i + 1];
+  EXPECT_NEAR(exact, c->DotProduct(a.data() + 1, b.data() + 1, 64), 1e-4);
+  for (auto table : GetVariants())
+  {
+    for (uint32_t count : { 0U, 1U, 7U, 8U, 17U, 64U, SAMPLES - 2 })
+      EXPECT_EQ(c->DotProduct(a.data() + 1, b.data() + 1, count), table->DotProduct(a.data() + 1, b.data() + 1, count))
+        << CAEKernels::GetIsaName(table->isa) << " " << count;
+  }
+}
+
+TEST(TestAEKernels, FloatToInt)
+{
+  const CAEKernels::Table* c = CAEKernels::Get(CAEKernels::ISA_C);
+  std::vector<float> src = MakeSignal(SAMPLES, 1.1f, 8);
+
+  std::vector<int16_t> ref16(SAMPLES);
+  std::vector<int32_t> ref32(SAMPLES);
+  c->FloatToS16(ref16.data(), src.data(), SAMPLES);
+  c->FloatToS32(ref32.data(), src.data(), SAMPLES);
+
+  // same scaling and saturation as swresample
+  const float probe[] = { 1.0f, -1.0f, 0.5f, 1e10f, -1e10f };
+  int16_t probe16[5];
+  int32_t probe32[5];
+  c->FloatToS16(probe16, probe, 5);
+  c->FloatToS32(probe32, probe, 5);
+  EXPECT_EQ(INT16_MAX, probe16[0]);
+  EXPECT_EQ(INT16_MIN, probe16[1]);
+  EXPECT_EQ(16384, probe16[2]);
+  EXPECT_EQ(INT16_MAX, probe16[3]);
+  EXPECT_EQ(INT16_MIN, probe16[4]);
+  EXPECT_EQ(INT32_MAX, probe32[0]);
+  EXPECT_EQ(INT32_MIN, probe32[1]);
+  EXPECT_EQ(1073741824, probe32[2]);
+  EXPECT_EQ(INT32_MAX, probe32[3]);
+  EXPECT_EQ(INT32_MIN, probe32[4]);
+
+  for (auto table : GetVariants())
+  {
+    std::vector<int16_t> out16(SAMPLES);
+    std::vector<int32_t> out32(SAMPLES);
+    table->FloatToS16(out16.data(), src.data(), SAMPLES);
+    table->FloatToS32(out32.data(), src.data(), SAMPLES);
+    ExpectBitExact(ref16, out16, table);
+    ExpectBitExact(ref32, out32, table);
+  }
+}
+
+TEST(TestAEKernels, IntToFloat)
+{
+  const CAEKernels::Table* c = CAEKernels::Get(CAEKernels::ISA_C);
+  std::mt19937 gen(9);
+  std::vector<int16_t> src16(SAMPLES);
+  std::vector<int32_t> src32(SAMPLES);
+  for (uint32_t i = 0; i < SAMPLES; i++)
+  {
+    src32[i] = static_cast<int32_t>(gen());
+    src16[i] = static_cast<int16_t>(src32[i]);
+  }
+  src16[0] = INT16_MIN;
+  src32[0] = INT32_MIN;
+  src32[1] = INT32_MAX;
+
+  std::vector<float> ref16(SAMPLES);
+  std::vector<float> ref32(SAMPLES);
+  c->S16ToFloat(ref16.data(), src16.data(), SAMPLES);
+  c->S32ToFloat(ref32.data(), src32.data(), SAMPLES);
+  EXPECT_EQ(-1.0f, ref16[0]);
+  EXPECT_EQ(-1.0f, ref32[0]);
+
+  // a round trip through float must be lossless for S16
+  std::vector<int16_t> back(SAMPLES);
+  c->FloatToS16(back.data(), ref16.data(), SAMPLES);
+  EXPECT_EQ(src16, back);
+
+  for (auto table : GetVariants())
+  {
+    std::vector<float> out16(SAMPLES);
+    std::vector<float> out32(SAMPLES);
+    table->S16ToFloat(out16.data(), src16.data(), SAMPLES);
+    table->S32ToFloat(out32.data(), src32.data(), SAMPLES);
+    ExpectBitExact(ref16, out16, table);
+    ExpectBitExact(ref32, out32, table);
+  }
+}
+
+TEST(TestAEKernels, DISABLED_Benchmark)
+{
+  // one second of 7.1 float at 192 kHz, mixed, ramped, clamped and packed
+  const uint32_t channels = 8;
+  const uint32_t frames = 192000;
+  const int runs = 20;
+  std::vector<float> dst = MakeSignal(frames * channels, 1.0f, 10);
+  std::vector<float> add = MakeSignal(frames * channels, 1.0f, 11);
+  std::vector<float> gains(frames, 0.5f);
+  std::vector<int32_t> packed(frames * channels);
+
+  std::cout << "using " << CAEKernels::GetIsaName(CAEKernels::Get().isa) << " kernels" << std::endl;
+  for (int isa = CAEKernels::ISA_C; isa < CAEKernels::ISA_MAX; isa++)
+  {
+    const CAEKernels::Table* table = CAEKernels::Get(static_cast<CAEKernels::Isa>(isa));
+    if (!table)
+      continue;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++)
+    {
+      std::vector<float> work(dst);
+      table->MulAddFrames(work.data(), add.data(), gains.data(), channels, frames);
+      table->MulArray(work.data(), 0.8f, work.size());
+      if (table->PeakArray(work.data(), work.size()) > 1.0f)
+        table->ClampArray(work.data(), work.size());
+      table->FloatToS32(packed.data(), work.data(), work.size());
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << CAEKernels::GetIsaName(table->isa) << ": "
+              << elapsed * 1000 / runs << " ms per second of audio, "
+              << runs / elapsed << "x realtime" << std::endl;
+  }
+}
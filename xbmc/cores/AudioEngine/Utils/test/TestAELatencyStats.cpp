@@ -0,0 +1,90 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AELatencyStats.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+TEST(TestAELatencyStats, Buckets)
+{
+  CAELatencyHistogram histogram;
+  histogram.Add(-5);
+  histogram.Add(0);
+  histogram.Add(15);
+  histogram.Add(16);
+  histogram.Add(31);
+  histogram.Add(1000);
+  histogram.Add(10000000);
+
+  EXPECT_EQ(7u, histogram.GetCount());
+  EXPECT_EQ(3u, histogram.GetBucket(0));
+  EXPECT_EQ(2u, histogram.GetBucket(1));
+  // 1000us falls into [512, 1024)
+  EXPECT_EQ(1u, histogram.GetBucket(6));
+  EXPECT_EQ(1u, histogram.GetBucket(CAELatencyHistogram::BUCKETS - 1));
+  EXPECT_EQ(10000000, histogram.GetMax());
+  EXPECT_EQ(0 + 0 + 15 + 16 + 31 + 1000 + 10000000, histogram.GetTotal());
+
+  EXPECT_EQ(16, CAELatencyHistogram::GetBucketLimit(0));
+  EXPECT_EQ(1024, CAELatencyHistogram::GetBucketLimit(6));
+  EXPECT_EQ(-1, CAELatencyHistogram::GetBucketLimit(CAELatencyHistogram::BUCKETS - 1));
+}
+
+TEST(TestAELatencyStats, Percentile)
+{
+  CAELatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.GetPercentile(50));
+
+  for (int i = 0; i < 90; i++)
+    histogram.Add(100);
+  for (int i = 0; i < 9; i++)
+    histogram.Add(3000);
+  histogram.Add(900000);
+
+  EXPECT_EQ(128, histogram.GetPercentile(50));
+  EXPECT_EQ(128, histogram.GetPercentile(90));
+  EXPECT_EQ(4096, histogram.GetPercentile(99));
+  // beyond the last limit only the maximum is known
+  EXPECT_EQ(900000, histogram.GetPercentile(100));
+}
+
+TEST(TestAELatencyStats, Merge)
+{
+  CAELatencyHistogram histogram, cycle;
+  histogram.Add(10);
+  cycle.Add(100);
+  cycle.Add(5000);
+
+  histogram.Merge(cycle);
+  EXPECT_EQ(3u, histogram.GetCount());
+  EXPECT_EQ(5110, histogram.GetTotal());
+  EXPECT_EQ(5000, histogram.GetMax());
+  EXPECT_EQ(1u, histogram.GetBucket(0));
+  EXPECT_EQ(128, histogram.GetPercentile(50));
+}
+
+TEST(TestAELatencyStats, StageNames)
+{
+  for (int i = 0; i < AE_STAGE_MAX; i++)
+    EXPECT_NE(std::string("unknown"), AELatencyStats::GetStageName(static_cast<AEStage>(i)));
+  EXPECT_STREQ("resample", AELatencyStats::GetStageName(AE_STAGE_RESAMPLE));
+}
@@ -180,6 +180,50 @@ float CDataCacheCore::GetVideoDAR()
   return m_playerVideoInfo.dar;
 }
 
+void CDataCacheCore::SetVideoDecoderThreads(int threads, std::string method)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decoderThreads = threads;
+  m_playerVideoInfo.decoderThreadMethod = method;
+}
+
+int CDataCacheCore::GetVideoDecoderThreads()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderThreads;
+}
+
+std::string CDataCacheCore::GetVideoDecoderThreadMethod()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderThreadMethod;
+}
+
+void CDataCacheCore::SetVideoDecoderLoad(float decodeTime, float load)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decodeTime = decodeTime;
+  m_playerVideoInfo.decoderLoad = load;
+}
+
+float CDataCacheCore::GetVideoDecodeTime()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decodeTime;
+}
+
+float CDataCacheCore::GetVideoDecoderLoad()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderLoad;
+}
+
 // player audio info
 void CDataCacheCore::SetAudioDecoderName(std::string name)
 {
@@ -237,6 +281,20 @@ int CDataCacheCore::GetAudioBitsPerSample()
   return m_playerAudioInfo.bitsPerSample;
 }
 
+void CDataCacheCore::SetAudioEngineStats(const AELatencyStats &stats)
+{
+  CSingleLock lock(m_audioEngineSection);
+
+  m_audioEngineStats = stats;
+}
+
+AELatencyStats CDataCacheCore::GetAudioEngineStats()
+{
+  CSingleLock lock(m_audioEngineSection);
+
+  return m_audioEngineStats;
+}
+
 void CDataCacheCore::SetRenderClockSync(bool enable)
 {
   CSingleLock lock(m_renderSection);
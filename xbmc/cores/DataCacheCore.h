@@ -22,6 +22,7 @@
 
 #include <atomic>
 #include <string>
+#include "cores/AudioEngine/Utils/AELatencyStats.h"
 #include "threads/CriticalSection.h"
 
 class CDataCacheCore
@@ -51,6 +52,12 @@ public:
   float GetVideoFps();
   void SetVideoDAR(float dar);
   float GetVideoDAR();
+  void SetVideoDecoderThreads(int threads, std::string method);
+  int GetVideoDecoderThreads();
+  std::string GetVideoDecoderThreadMethod();
+  void SetVideoDecoderLoad(float decodeTime, float load);
+  float GetVideoDecodeTime();
+  float GetVideoDecoderLoad();
 
   // player audio info
   void SetAudioDecoderName(std::string name);
@@ -62,6 +69,10 @@ public:
   void SetAudioBitsPerSample(int bitsPerSample);
   int GetAudioBitsPerSample();
 
+  // audio engine info
+  void SetAudioEngineStats(const AELatencyStats &stats);
+  AELatencyStats GetAudioEngineStats();
+
   // render info
   void SetRenderClockSync(bool enabled);
   bool IsRenderClockSync();
@@ -128,6 +139,10 @@ protected:
     int height;
     float fps;
     float dar;
+    int decoderThreads;
+    std::string decoderThreadMethod;
+    float decodeTime;
+    float decoderLoad;
   } m_playerVideoInfo;
 
   CCriticalSection m_audioPlayerSection;
@@ -139,6 +154,9 @@ protected:
     int bitsPerSample;
   } m_playerAudioInfo;
 
+  CCriticalSection m_audioEngineSection;
+  AELatencyStats m_audioEngineStats;
+
   CCriticalSection m_renderSection;
   struct SRenderInfo
   {
@@ -27,6 +27,7 @@
 #include "cores/RetroPlayer/rendering/RenderVideoSettings.h"
 #include "games/GameServices.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUITexture.h"
 #include "guilib/TransformMatrix.h"
 #include "settings/GameSettings.h"
 #include "settings/MediaSettings.h"
@@ -97,6 +98,7 @@ void CGUIGameControl::Process(unsigned int currentTime, CDirtyRegionList &dirtyr
 
 void CGUIGameControl::Render()
 {
+  CGUITexture::FlushBatch();
   m_renderHandle->Render();
 
   CGUIControl::Render();
@@ -104,6 +106,7 @@ void CGUIGameControl::Render()
 
 void CGUIGameControl::RenderEx()
 {
+  CGUITexture::FlushBatch();
   m_renderHandle->RenderEx();
 
   CGUIControl::RenderEx();
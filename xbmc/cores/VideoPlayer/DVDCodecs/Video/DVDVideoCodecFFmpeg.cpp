@@ -35,6 +35,8 @@
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderInfo.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/BitstreamConverter.h"
 #include <memory>
 
 extern "C" {
@@ -253,6 +255,84 @@ void CDVDVideoCodecFFmpeg::CDropControl::Process(int64_t pts, bool drop)
   m_lastPTS = pts;
 }
 
+//------------------------------------------------------------------------------
+// Thread control
+//
+// Tracks the time the decoder thread spends inside ffmpeg per output frame.
+// With frame threading this stays near zero as long as the worker threads
+// keep up with the frame rate and only grows once they fall behind, so
+// threads are added on high load and released one at a time while there is
+// plenty of headroom, never going back to a count that was seen overloaded.
+//------------------------------------------------------------------------------
+
+#define THREAD_WINDOW_FRAMES 50
+#define THREAD_LOAD_HIGH 0.75
+#define THREAD_LOAD_LOW 0.1
+
+CDVDVideoCodecFFmpeg::CThreadControl::CThreadControl()
+{
+  m_wanted = 0;
+  m_minThreads = 1;
+  Reset(0, 0);
+}
+
+void CDVDVideoCodecFFmpeg::CThreadControl::Reset(int threads, int maxThreads)
+{
+  m_threads = threads;
+  m_wanted = threads;
+  m_maxThreads = maxThreads;
+  m_windows = 0;
+  m_frames = 0;
+  m_ticks = 0;
+  m_decodeTime = 0.0;
+  m_load = 0.0;
+}
+
+void CDVDVideoCodecFFmpeg::CThreadControl::AddTime(int64_t ticks)
+{
+  m_ticks += ticks;
+}
+
+bool CDVDVideoCodecFFmpeg::CThreadControl::FrameDone(double framePeriod)
+{
+  m_frames++;
+  if (m_frames < THREAD_WINDOW_FRAMES)
+    return false;
+
+  m_decodeTime = static_cast<double>(m_ticks) / CurrentHostFrequency() / m_frames;
+  m_load = m_decodeTime / framePeriod;
+  m_frames = 0;
+  m_ticks = 0;
+  m_windows++;
+  return true;
+}
+
+int CDVDVideoCodecFFmpeg::CThreadControl::Evaluate()
+{
+  // the first window after open includes filling up the thread pipeline
+  if (m_windows < 2)
+    return m_threads;
+
+  if (m_load > THREAD_LOAD_HIGH)
+  {
+    m_minThreads = std::min(m_threads + 1, m_maxThreads);
+    return std::min(m_threads + std::max(1, m_threads / 2), m_maxThreads);
+  }
+  else if (m_load < THREAD_LOAD_LOW && m_threads > m_minThreads)
+    return m_threads - 1;
+
+  return m_threads;
+}
+
+static const char* ThreadTypeName(int type)
+{
+  if (type & FF_THREAD_FRAME)
+    return "frame";
+  else if (type & FF_THREAD_SLICE)
+    return "slice";
+  return "none";
+}
+
 enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx, const AVPixelFormat * fmt)
 {
   ICallbackHWAccel *cb = static_cast<ICallbackHWAccel*>(avctx->opaque);
@@ -395,12 +475,22 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     }
     else
     {
-      int num_threads = g_cpuInfo.getCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
+      int max_threads = g_cpuInfo.getCPUCount() * 3 / 2;
+      max_threads = std::max(1, std::min(max_threads, 16));
+      // each frame thread adds a frame of delay, realtime streams get
+      // one frame at most
+      if (hints.realtime)
+        max_threads = std::min(2, max_threads);
+      int num_threads = max_threads;
+      if (m_threadCtrl.m_wanted > 0)
+        num_threads = m_threadCtrl.m_wanted;
       m_pCodecContext->thread_count = num_threads;
+      m_pCodecContext->thread_type = GetThreadType(pCodec);
       m_pCodecContext->thread_safe_callbacks = 1;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with %d threads", num_threads);
+      m_threadCtrl.Reset(num_threads, max_threads);
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open %s threaded with %d threads",
+                ThreadTypeName(m_pCodecContext->thread_type), num_threads);
     }
   }
   else
@@ -550,6 +640,11 @@ void CDVDVideoCodecFFmpeg::UpdateName()
     m_name += "-" + m_pHardware->Name();
 
   m_processInfo.SetVideoDecoderName(m_name, m_pHardware ? true : false);
+  if (m_pHardware)
+    m_processInfo.SetVideoDecoderThreads(0, "");
+  else
+    m_processInfo.SetVideoDecoderThreads(m_pCodecContext->thread_count,
+                                         ThreadTypeName(m_pCodecContext->active_thread_type));
 
   CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - Updated codec: %s", m_name.c_str());
 }
@@ -583,6 +678,36 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   if (packet.recoveryPoint)
     m_started = true;
 
+  // ffmpeg fixes the thread count on open, a new count is applied at a
+  // keyframe by draining the decoder and reopening it for this packet.
+  // leading pictures of an open gop reference the one before, which a
+  // reopen drops, so only a closed gop start will do
+  if (m_threadDrain)
+    return false;
+
+  if (packet.keyFrame && m_started && m_decoderState == STATE_SW_MULTI && !m_pHardware &&
+      !(m_codecControlFlags & DVD_CODEC_CTRL_DRAIN) &&
+      CBitstreamParser::IsClosedGopStart(m_hints.codec, packet.pData, packet.iSize,
+                                         static_cast<const uint8_t*>(m_hints.extradata), m_hints.extrasize))
+  {
+    m_threadCtrl.m_wanted = m_threadCtrl.Evaluate();
+    if (m_threadCtrl.m_wanted != m_threadCtrl.m_threads)
+    {
+      CLog::Log(LOGNOTICE, "CDVDVideoCodecFFmpeg::AddData - decode time %.2f ms, load %.2f with %d threads, switching to %d threads",
+                m_threadCtrl.m_decodeTime * 1000, m_threadCtrl.m_load, m_threadCtrl.m_threads, m_threadCtrl.m_wanted);
+
+      AVPacket avpkt;
+      av_init_packet(&avpkt);
+      avpkt.data = nullptr;
+      avpkt.size = 0;
+      avpkt.dts = AV_NOPTS_VALUE;
+      avpkt.pts = AV_NOPTS_VALUE;
+      avcodec_send_packet(m_pCodecContext, &avpkt);
+      m_threadDrain = true;
+      return false;
+    }
+  }
+
   m_dts = packet.dts;
   m_pCodecContext->reordered_opaque = pts_dtoi(packet.pts);
 
@@ -595,7 +720,9 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   avpkt.side_data = static_cast<AVPacketSideData*>(packet.pSideData);
   avpkt.side_data_elems = packet.iSideDataElems;
 
+  int64_t start = CurrentHostCounter();
   int ret = avcodec_send_packet(m_pCodecContext, &avpkt);
+  m_threadCtrl.AddTime(CurrentHostCounter() - start);
 
   // try again
   if (ret == AVERROR(EAGAIN))
@@ -677,7 +804,9 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
     avcodec_send_packet(m_pCodecContext, &avpkt);
   }
 
+  int64_t start = CurrentHostCounter();
   int ret = avcodec_receive_frame(m_pCodecContext, m_pDecodedFrame);
+  m_threadCtrl.AddTime(CurrentHostCounter() - start);
 
   if (m_decoderState == STATE_HW_FAILED && !m_pHardware)
     return VC_REOPEN;
@@ -718,6 +847,10 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
         else
           return VC_PICTURE;
       }
+      else if (m_threadDrain)
+      {
+        return ApplyThreadCount();
+      }
       else
       {
         m_eof = true;
@@ -725,6 +858,10 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
         return VC_EOF;
       }
     }
+    else if (m_threadDrain)
+    {
+      return ApplyThreadCount();
+    }
     else
     {
       m_eof = true;
@@ -745,6 +882,10 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   // here we got a frame
   int64_t framePTS = av_frame_get_best_effort_timestamp(m_pDecodedFrame);
 
+  if (!m_pHardware && m_threadCtrl.FrameDone(GetFramePeriod()))
+    m_processInfo.SetVideoDecoderLoad(static_cast<float>(m_threadCtrl.m_decodeTime * 1000),
+                                      static_cast<float>(m_threadCtrl.m_load));
+
   if (m_pCodecContext->skip_frame > AVDISCARD_DEFAULT)
   {
     if (m_dropCtrl.m_state == CDropControl::VALID &&
@@ -897,6 +1038,8 @@ void CDVDVideoCodecFFmpeg::Reset()
   m_skippedDeint = 0;
   m_droppedFrames = 0;
   m_eof = false;
+  m_threadDrain = false;
+  m_threadCtrl.m_wanted = m_threadCtrl.m_threads;
   m_iLastKeyframe = m_pCodecContext->has_b_frames;
   avcodec_flush_buffers(m_pCodecContext);
   av_frame_unref(m_pFrame);
@@ -918,6 +1061,47 @@ void CDVDVideoCodecFFmpeg::Reopen()
   }
 }
 
+int CDVDVideoCodecFFmpeg::GetThreadType(const AVCodec* codec) const
+{
+  // frame threading scales with any stream, slice threading only helps
+  // when pictures are split into several slices, which most streams are not.
+  // the delay frame threading adds on realtime streams is kept in check by
+  // the thread count, so only codecs without frame threading are sliced
+  if (codec->capabilities & AV_CODEC_CAP_FRAME_THREADS)
+    return FF_THREAD_FRAME;
+  else if (codec->capabilities & AV_CODEC_CAP_SLICE_THREADS)
+    return FF_THREAD_SLICE;
+
+  return FF_THREAD_FRAME | FF_THREAD_SLICE;
+}
+
+double CDVDVideoCodecFFmpeg::GetFramePeriod() const
+{
+  if (m_dropCtrl.m_state == CDropControl::VALID)
+    return static_cast<double>(m_dropCtrl.m_diffPTS) / AV_TIME_BASE;
+  else if (m_hints.fpsrate > 0 && m_hints.fpsscale > 0)
+    return static_cast<double>(m_hints.fpsscale) / m_hints.fpsrate;
+
+  return 0.04;
+}
+
+CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::ApplyThreadCount()
+{
+  m_threadDrain = false;
+  int threads = m_threadCtrl.m_threads;
+
+  // filters were drained as well
+  Dispose();
+  m_filters = "";
+  if (!Open(m_hints, m_options))
+  {
+    CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::ApplyThreadCount - failed to reopen with %d threads", m_threadCtrl.m_wanted);
+    m_threadCtrl.m_wanted = threads;
+    return VC_REOPEN;
+  }
+  return VC_BUFFER;
+}
+
 bool CDVDVideoCodecFFmpeg::GetPictureCommon(VideoPicture* pVideoPicture)
 {
   if (!m_pFrame)
@@ -68,6 +68,9 @@ protected:
   void SetFilters();
   void UpdateName();
   bool SetPictureParams(VideoPicture* pVideoPicture);
+  int GetThreadType(const AVCodec* codec) const;
+  double GetFramePeriod() const;
+  CDVDVideoCodec::VCReturn ApplyThreadCount();
 
   bool HasHardware() { return m_pHardware != nullptr; };
   void SetHardware(IHardwareDecoder *hardware);
@@ -127,4 +130,24 @@ protected:
       VALID
     } m_state;
   } m_dropCtrl;
+
+  struct CThreadControl
+  {
+    CThreadControl();
+    void Reset(int threads, int maxThreads);
+    void AddTime(int64_t ticks);
+    bool FrameDone(double framePeriod);
+    int Evaluate();
+
+    int m_threads;
+    int m_wanted;
+    int m_maxThreads;
+    int m_minThreads;
+    int m_windows;
+    int m_frames;
+    int64_t m_ticks;
+    double m_decodeTime;
+    double m_load;
+  } m_threadCtrl;
+  bool m_threadDrain = false;
 };
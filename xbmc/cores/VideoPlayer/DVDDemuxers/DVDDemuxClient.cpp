@@ -22,6 +22,7 @@
 #include "DVDDemuxClient.h"
 #include "DVDDemuxUtils.h"
 #include "utils/log.h"
+#include "utils/BitstreamConverter.h"
 #include "settings/Settings.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 
@@ -142,7 +143,15 @@ bool CDVDDemuxClient::ParsePacket(DemuxPacket* pkt)
     return change;
 
   if (st->ExtraSize)
+  {
+    // stream properties come with the extradata, but addons don't flag
+    // keyframes. a look at the nal unit types finds them without parsing
+    if (st->type == STREAM_VIDEO && !pkt->keyFrame && !pkt->cryptoInfo &&
+        (st->codec == AV_CODEC_ID_H264 || st->codec == AV_CODEC_ID_HEVC))
+      pkt->keyFrame = CBitstreamParser::IsClosedGopStart(st->codec, pkt->pData, pkt->iSize,
+                                                         static_cast<const uint8_t*>(st->ExtraData), st->ExtraSize);
     return change;
+  }
 
   CDemuxStreamClientInternal* stream = dynamic_cast<CDemuxStreamClientInternal*>(st);
 
@@ -200,6 +209,9 @@ bool CDVDDemuxClient::ParsePacket(DemuxPacket* pkt)
                              (int64_t)(pkt->dts * DVD_TIME_BASE),
                              0);
   // our parse is setup to parse complete frames, so we don't care about outbufs
+  if (len >= 0 && st->type == STREAM_VIDEO && stream->m_parser->key_frame == 1)
+    pkt->keyFrame = true;
+
   if (len >= 0)
   {
     if (stream->m_context->profile != st->profile &&
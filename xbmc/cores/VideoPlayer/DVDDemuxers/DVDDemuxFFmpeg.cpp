@@ -574,6 +574,8 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
   {
     SeekTime(0);
   }
+
+  LoadKeyframeIndex();
   
   return true;
 }
@@ -583,6 +585,8 @@ void CDVDDemuxFFmpeg::Dispose()
   m_pkt.result = -1;
   av_packet_unref(&m_pkt.pkt);
 
+  SaveKeyframeIndex();
+
   if (m_pFormatContext)
   {
     if (m_ioContext && m_pFormatContext->pb && m_pFormatContext->pb != m_ioContext)
@@ -965,7 +969,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           {
             if(m_pkt.pkt.stream_index == (int)m_pFormatContext->programs[m_program]->stream_index[i])
             {
-              pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+              pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt);
               break;
             }
           }
@@ -974,7 +978,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
             bReturnEmpty = true;
         }
         else
-          pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+          pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt);
       }
       else
         bReturnEmpty = true;
@@ -988,16 +992,16 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           m_pkt.pkt.pts = AV_NOPTS_VALUE;
         }
 
-        // copy contents into our own packet
-        pPacket->iSize = m_pkt.pkt.size;
-
-        // maybe we can avoid a memcpy here by detecting where pkt.destruct is pointing too?
-        if (m_pkt.pkt.data)
-          memcpy(pPacket->pData, m_pkt.pkt.data, pPacket->iSize);
-
+        // payload was referenced or copied into our own packet on allocation
         pPacket->pts = ConvertTimestamp(m_pkt.pkt.pts, stream->time_base.den, stream->time_base.num);
         pPacket->dts = ConvertTimestamp(m_pkt.pkt.dts, stream->time_base.den, stream->time_base.num);
         pPacket->duration =  DVD_SEC_TO_TIME((double)m_pkt.pkt.duration * stream->time_base.num / stream->time_base.den);
+        pPacket->keyFrame = (m_pkt.pkt.flags & AV_PKT_FLAG_KEY) != 0;
+
+        if (pPacket->keyFrame && m_keyframeRecord &&
+            m_pkt.pkt.stream_index == m_keyframeStream &&
+            m_pkt.pkt.dts != AV_NOPTS_VALUE && m_pkt.pkt.pos >= 0)
+          av_add_index_entry(stream, m_pkt.pkt.pos, m_pkt.pkt.dts, 0, 0, AVINDEX_KEYFRAME);
 
         CDVDDemuxUtils::StoreSideData(pPacket, &m_pkt.pkt);
 
@@ -1144,7 +1148,7 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double *startpts)
     return false;
   }
 
-  int64_t seek_pts = (int64_t)time * (AV_TIME_BASE / 1000);
+  int64_t seek_pts = (int64_t)(time * (AV_TIME_BASE / 1000));
   bool ismp3 = m_pFormatContext->iformat && (strcmp(m_pFormatContext->iformat->name, "mp3") == 0);
 
   if (!m_streaminfo)
@@ -1349,6 +1353,103 @@ double CDVDDemuxFFmpeg::SelectAspect(AVStream* st, bool& forced)
   return 0.0;
 }
 
+void CDVDDemuxFFmpeg::LoadKeyframeIndex()
+{
+  m_keyframeStream = -1;
+  m_keyframeEntries = 0;
+  m_keyframeRecord = false;
+
+  // only worth it where probing the container costs network round trips
+  if (!m_pFormatContext || !m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) ||
+      m_pInput->IsRealtime() || m_pInput->GetIPosTime())
+    return;
+
+  std::string fileName = m_pInput->GetFileName();
+  int64_t length = m_pInput->GetLength();
+  if (!URIUtils::IsRemote(fileName) || length <= 0)
+    return;
+
+  // the stream av_seek_frame picks when not given one
+  int streamIdx = av_find_default_stream_index(m_pFormatContext);
+  if (streamIdx < 0)
+    return;
+
+  AVStream *st = m_pFormatContext->streams[streamIdx];
+  if (!st->codecpar || st->codecpar->codec_type != AVMEDIA_TYPE_VIDEO)
+    return;
+
+  m_keyframeStream = streamIdx;
+  m_keyframeFile = CDVDDemuxKeyframeIndex::GetCachePath(fileName);
+  m_keyframeIdentity.fileSize = length;
+  // a file replaced by one of the same size must not get the old index
+  struct __stat64 buffer;
+  m_keyframeIdentity.modTime = XFILE::CFile::Stat(fileName, &buffer) == 0 ? buffer.st_mtime : 0;
+  m_keyframeIdentity.stream = streamIdx;
+  m_keyframeIdentity.codec = st->codecpar->codec_id;
+  m_keyframeIdentity.timeBaseNum = st->time_base.num;
+  m_keyframeIdentity.timeBaseDen = st->time_base.den;
+
+  // formats seeking by binary search on timestamps (ts, ps) never add to the
+  // stream index, their packet positions are valid seek points though
+  const AVInputFormat *iformat = m_pFormatContext->iformat;
+  m_keyframeRecord = !(iformat->flags & AVFMT_GENERIC_INDEX) &&
+                     !iformat->read_seek && !iformat->read_seek2 && iformat->read_timestamp;
+
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (file.LoadFile(m_keyframeFile, buffer) > 0)
+  {
+    CDVDDemuxKeyframeIndex index;
+    if (index.Deserialize(m_keyframeIdentity, std::string(buffer.get(), buffer.size())))
+    {
+      for (const auto &entry : index.GetEntries())
+        av_add_index_entry(st, entry.pos, entry.timestamp, 0, 0, AVINDEX_KEYFRAME);
+
+      CLog::Log(LOGDEBUG, "CDVDDemuxFFmpeg::%s - loaded %d keyframes for %s", __FUNCTION__,
+                static_cast<int>(index.Size()), CURL::GetRedacted(fileName).c_str());
+    }
+    else
+      CLog::Log(LOGDEBUG, "CDVDDemuxFFmpeg::%s - ignoring stale keyframe index for %s", __FUNCTION__,
+                CURL::GetRedacted(fileName).c_str());
+  }
+
+  m_keyframeEntries = st->nb_index_entries;
+}
+
+void CDVDDemuxFFmpeg::SaveKeyframeIndex()
+{
+  if (m_keyframeStream < 0 || !m_pFormatContext ||
+      m_keyframeStream >= static_cast<int>(m_pFormatContext->nb_streams))
+    return;
+
+  AVStream *st = m_pFormatContext->streams[m_keyframeStream];
+  m_keyframeStream = -1;
+
+  // containers with a full index have nothing to add to it
+  if (st->nb_index_entries <= m_keyframeEntries)
+    return;
+
+  CDVDDemuxKeyframeIndex index;
+  for (int i = 0; i < st->nb_index_entries; i++)
+  {
+    const AVIndexEntry &entry = st->index_entries[i];
+    if (entry.flags & AVINDEX_KEYFRAME)
+      index.Add(entry.timestamp, entry.pos);
+  }
+
+  if (index.Size() < 2)
+    return;
+
+  std::string data;
+  index.Serialize(m_keyframeIdentity, data);
+
+  XFILE::CDirectory::Create(URIUtils::GetDirectory(m_keyframeFile));
+  XFILE::CFile file;
+  if (!file.OpenForWrite(m_keyframeFile, true) ||
+      file.Write(data.c_str(), data.size()) != static_cast<ssize_t>(data.size()))
+    CLog::Log(LOGWARNING, "CDVDDemuxFFmpeg::%s - unable to write %s", __FUNCTION__, m_keyframeFile.c_str());
+}
+
 void CDVDDemuxFFmpeg::CreateStreams(unsigned int program)
 {
   DisposeStreams();
@@ -21,6 +21,7 @@
  */
 
 #include "DVDDemux.h"
+#include "DVDDemuxKeyframeIndex.h"
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 #include <map>
@@ -143,6 +144,9 @@ protected:
   void GetL16Parameters(int &channels, int &samplerate);
   double SelectAspect(AVStream* st, bool& forced);
 
+  void LoadKeyframeIndex();
+  void SaveKeyframeIndex();
+
   CCriticalSection m_critSection;
   std::map<int, CDemuxStream*> m_streams;
   std::map<int, std::unique_ptr<CDemuxParserFFmpeg>> m_parsers;
@@ -175,5 +179,12 @@ protected:
   double m_dtsAtDisplayTime;
   bool m_seekToKeyFrame = false;
   double m_startTime = 0;
+
+  // keyframes of the stream ffmpeg seeks on, kept across playbacks of remote files
+  CDVDDemuxKeyframeIndex::Identity m_keyframeIdentity;
+  std::string m_keyframeFile;
+  int m_keyframeStream = -1;
+  int m_keyframeEntries = 0; // index size after open, only save if it grew
+  bool m_keyframeRecord = false; // format does not index keyframes itself
 };
 
@@ -0,0 +1,246 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DVDDemuxKeyframeIndex.h"
+#include "FileItem.h"
+#include "XBDateTime.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+// "KFI" followed by the format version
+#define KEYFRAME_INDEX_MAGIC "KFI\x02"
+#define KEYFRAME_INDEX_MAGIC_SIZE 4
+// a day of one second gops, keeps a corrupt count from eating memory
+#define KEYFRAME_INDEX_MAX_ENTRIES 100000
+#define KEYFRAME_INDEX_FOLDER "special://userdata/cache/keyframes/"
+// an index is a few kB, this keeps thousands of files around
+#define KEYFRAME_INDEX_MAX_CACHE_SIZE (32 * 1024 * 1024)
+#define KEYFRAME_INDEX_MAX_AGE_DAYS 180
+
+namespace
+{
+
+void PutFixed(std::string &data, uint64_t value, int bytes)
+{
+  for (int i = 0; i < bytes; i++)
+    data.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+}
+
+bool GetFixed(const std::string &data, size_t &offset, uint64_t &value, int bytes)
+{
+  if (data.size() - offset < static_cast<size_t>(bytes))
+    return false;
+
+  value = 0;
+  for (int i = 0; i < bytes; i++)
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(data[offset++])) << (i * 8);
+  return true;
+}
+
+// entries are stored as deltas to the previous one, zigzag coded into a
+// varint. a keyframe every few seconds fits in two or three bytes per value
+void PutDelta(std::string &data, int64_t delta)
+{
+  uint64_t value = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+  while (value >= 0x80)
+  {
+    data.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  data.push_back(static_cast<char>(value));
+}
+
+bool GetDelta(const std::string &data, size_t &offset, int64_t &delta)
+{
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7)
+  {
+    if (offset >= data.size())
+      return false;
+
+    uint8_t byte = static_cast<uint8_t>(data[offset++]);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+    {
+      delta = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+}
+
+bool CDVDDemuxKeyframeIndex::Identity::operator==(const Identity &other) const
+{
+  return fileSize == other.fileSize &&
+         modTime == other.modTime &&
+         stream == other.stream &&
+         codec == other.codec &&
+         timeBaseNum == other.timeBaseNum &&
+         timeBaseDen == other.timeBaseDen;
+}
+
+void CDVDDemuxKeyframeIndex::Clear()
+{
+  m_entries.clear();
+}
+
+void CDVDDemuxKeyframeIndex::Add(int64_t timestamp, int64_t pos)
+{
+  if (pos < 0)
+    return;
+
+  // playback mostly moves forward, so appending is the common case
+  if (m_entries.empty() || m_entries.back().timestamp < timestamp)
+  {
+    if (m_entries.size() < KEYFRAME_INDEX_MAX_ENTRIES)
+      m_entries.push_back({timestamp, pos});
+    return;
+  }
+
+  auto it = std::lower_bound(m_entries.begin(), m_entries.end(), timestamp,
+                             [](const Entry &entry, int64_t ts) { return entry.timestamp < ts; });
+  if (it != m_entries.end() && it->timestamp == timestamp)
+  {
+    it->pos = pos;
+    return;
+  }
+
+  if (m_entries.size() < KEYFRAME_INDEX_MAX_ENTRIES)
+    m_entries.insert(it, {timestamp, pos});
+}
+
+void CDVDDemuxKeyframeIndex::Serialize(const Identity &identity, std::string &data) const
+{
+  data.clear();
+  data.reserve(KEYFRAME_INDEX_MAGIC_SIZE + 36 + m_entries.size() * 6);
+  data.append(KEYFRAME_INDEX_MAGIC, KEYFRAME_INDEX_MAGIC_SIZE);
+  PutFixed(data, static_cast<uint64_t>(identity.fileSize), 8);
+  PutFixed(data, static_cast<uint64_t>(identity.modTime), 8);
+  PutFixed(data, static_cast<uint32_t>(identity.stream), 4);
+  PutFixed(data, static_cast<uint32_t>(identity.codec), 4);
+  PutFixed(data, static_cast<uint32_t>(identity.timeBaseNum), 4);
+  PutFixed(data, static_cast<uint32_t>(identity.timeBaseDen), 4);
+  PutFixed(data, m_entries.size(), 4);
+
+  Entry last = {0, 0};
+  for (const auto &entry : m_entries)
+  {
+    PutDelta(data, entry.timestamp - last.timestamp);
+    PutDelta(data, entry.pos - last.pos);
+    last = entry;
+  }
+}
+
+bool CDVDDemuxKeyframeIndex::Deserialize(const Identity &identity, const std::string &data)
+{
+  m_entries.clear();
+
+  if (data.compare(0, KEYFRAME_INDEX_MAGIC_SIZE, KEYFRAME_INDEX_MAGIC, KEYFRAME_INDEX_MAGIC_SIZE) != 0)
+    return false;
+
+  size_t offset = KEYFRAME_INDEX_MAGIC_SIZE;
+  uint64_t fileSize, modTime, stream, codec, timeBaseNum, timeBaseDen, count;
+  if (!GetFixed(data, offset, fileSize, 8) ||
+      !GetFixed(data, offset, modTime, 8) ||
+      !GetFixed(data, offset, stream, 4) ||
+      !GetFixed(data, offset, codec, 4) ||
+      !GetFixed(data, offset, timeBaseNum, 4) ||
+      !GetFixed(data, offset, timeBaseDen, 4) ||
+      !GetFixed(data, offset, count, 4))
+    return false;
+
+  Identity stored;
+  stored.fileSize = static_cast<int64_t>(fileSize);
+  stored.modTime = static_cast<int64_t>(modTime);
+  stored.stream = static_cast<int32_t>(stream);
+  stored.codec = static_cast<int32_t>(codec);
+  stored.timeBaseNum = static_cast<int32_t>(timeBaseNum);
+  stored.timeBaseDen = static_cast<int32_t>(timeBaseDen);
+  if (stored != identity || count > KEYFRAME_INDEX_MAX_ENTRIES)
+    return false;
+
+  std::vector<Entry> entries;
+  entries.reserve(count);
+  Entry last = {0, 0};
+  for (uint64_t i = 0; i < count; i++)
+  {
+    int64_t timestamp, pos;
+    if (!GetDelta(data, offset, timestamp) || !GetDelta(data, offset, pos))
+      return false;
+
+    last.timestamp += timestamp;
+    last.pos += pos;
+    if (!entries.empty() && entries.back().timestamp >= last.timestamp)
+      return false;
+    entries.push_back(last);
+  }
+
+  m_entries.swap(entries);
+  return true;
+}
+
+std::string CDVDDemuxKeyframeIndex::GetCachePath(const std::string &file)
+{
+  return StringUtils::Format(KEYFRAME_INDEX_FOLDER "%08x.kfi",
+                             Crc32::ComputeFromLowerCase(file));
+}
+
+void CDVDDemuxKeyframeIndex::PruneCache()
+{
+  PruneCache(KEYFRAME_INDEX_FOLDER, KEYFRAME_INDEX_MAX_CACHE_SIZE);
+}
+
+void CDVDDemuxKeyframeIndex::PruneCache(const std::string &folder, int64_t maxSize)
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(folder, items, ".kfi", XFILE::DIR_FLAG_NO_FILE_DIRS))
+    return;
+
+  // an index is rewritten whenever playback added to it, keep the recently written ones
+  items.Sort(SortByDate, SortOrderDescending);
+
+  const CDateTime oldest = CDateTime::GetCurrentDateTime() - CDateTimeSpan(KEYFRAME_INDEX_MAX_AGE_DAYS, 0, 0, 0);
+  int64_t size = 0;
+  int removed = 0;
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    const CFileItemPtr &item = items[i];
+    if (item->m_bIsFolder)
+      continue;
+
+    size += item->m_dwSize;
+    if (size > maxSize || (item->m_dateTime.IsValid() && item->m_dateTime < oldest))
+    {
+      if (XFILE::CFile::Delete(item->GetPath()))
+        removed++;
+    }
+  }
+
+  if (removed)
+    CLog::Log(LOGDEBUG, "CDVDDemuxKeyframeIndex::%s - removed %d keyframe indexes", __FUNCTION__, removed);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Keyframe timestamp to byte offset pairs of one stream of a file.
+ *
+ * The demuxer collects these while reading and keeps them in the userdata
+ * cache, so a later playback of the same file can seek straight to a keyframe
+ * instead of probing the container over the network.
+ *
+ * Timestamps are in the time base of the stream they were taken from. The
+ * serialized form keeps the identity of the file and stream it belongs to,
+ * an index that does not match is rejected on load.
+ */
+class CDVDDemuxKeyframeIndex
+{
+public:
+  struct Identity
+  {
+    int64_t fileSize = 0;
+    int64_t modTime = 0; ///< last modification of the file, 0 where the protocol doesn't tell
+    int stream = -1;
+    int codec = 0;
+    int timeBaseNum = 0;
+    int timeBaseDen = 0;
+
+    bool operator==(const Identity &other) const;
+    bool operator!=(const Identity &other) const { return !(*this == other); }
+  };
+
+  struct Entry
+  {
+    int64_t timestamp;
+    int64_t pos;
+  };
+
+  CDVDDemuxKeyframeIndex() = default;
+
+  void Clear();
+  void Add(int64_t timestamp, int64_t pos);
+
+  const std::vector<Entry>& GetEntries() const { return m_entries; }
+  bool IsEmpty() const { return m_entries.empty(); }
+  size_t Size() const { return m_entries.size(); }
+
+  void Serialize(const Identity &identity, std::string &data) const;
+  bool Deserialize(const Identity &identity, const std::string &data);
+
+  static std::string GetCachePath(const std::string &file);
+
+  /*!
+   * \brief Remove cached indexes that weren't written for months, and the
+   * least recently written ones once the cache exceeds its size limit.
+   */
+  static void PruneCache();
+  static void PruneCache(const std::string &folder, int64_t maxSize);
+
+private:
+  std::vector<Entry> m_entries;
+};
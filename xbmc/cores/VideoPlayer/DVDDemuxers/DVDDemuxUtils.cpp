@@ -21,8 +21,12 @@
 #include "DVDDemuxUtils.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxCrypto.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 
+#include <vector>
+
 #ifdef TARGET_POSIX
 #include "platform/linux/XMemUtils.h"
 #endif
@@ -31,12 +35,133 @@ extern "C" {
 #include "libavcodec/avcodec.h"
 }
 
+namespace
+{
+
+/*!
+ * Recycles packet payload buffers in power of two size classes. Every buffer
+ * carries a small header in front of the payload holding its size class, so
+ * it can be returned to the right free list. Payloads that reference an ffmpeg
+ * buffer don't come from the pool, the packet holds that reference itself.
+ */
+class CDemuxPacketPool
+{
+public:
+  ~CDemuxPacketPool()
+  {
+    for (auto &freeList : m_freeLists)
+      for (uint8_t *buffer : freeList)
+        _aligned_free(buffer);
+  }
+
+  uint8_t* Allocate(size_t size)
+  {
+    unsigned int sizeClass = GetSizeClass(size);
+    if (sizeClass < SIZE_CLASSES)
+    {
+      CSingleLock lock(m_section);
+      std::vector<uint8_t*> &freeList = m_freeLists[sizeClass];
+      if (!freeList.empty())
+      {
+        uint8_t *buffer = freeList.back();
+        freeList.pop_back();
+        m_stats.bytesPooled -= GetClassSize(sizeClass);
+        m_stats.poolHits++;
+        return buffer + HEADER_SIZE;
+      }
+      m_stats.poolMisses++;
+    }
+
+    size_t allocSize = sizeClass < SIZE_CLASSES ? GetClassSize(sizeClass) : size;
+    uint8_t *buffer = static_cast<uint8_t*>(_aligned_malloc(allocSize + HEADER_SIZE, 16));
+    if (!buffer)
+      return nullptr;
+
+    *reinterpret_cast<uint32_t*>(buffer) = sizeClass;
+    return buffer + HEADER_SIZE;
+  }
+
+  void Free(uint8_t *data)
+  {
+    uint8_t *buffer = data - HEADER_SIZE;
+    uint32_t sizeClass = *reinterpret_cast<uint32_t*>(buffer);
+    CSingleLock lock(m_section);
+    if (sizeClass < SIZE_CLASSES && m_stats.bytesPooled + GetClassSize(sizeClass) <= MAX_POOLED_BYTES)
+    {
+      m_freeLists[sizeClass].push_back(buffer);
+      m_stats.bytesPooled += GetClassSize(sizeClass);
+      return;
+    }
+    lock.Leave();
+    _aligned_free(buffer);
+  }
+
+  void AddReferenced(size_t size)
+  {
+    CSingleLock lock(m_section);
+    m_stats.bytesReferenced += size;
+  }
+
+  void AddCopied(size_t size)
+  {
+    CSingleLock lock(m_section);
+    m_stats.bytesCopied += size;
+  }
+
+  DemuxPacketPoolStats GetStats() const
+  {
+    CSingleLock lock(m_section);
+    return m_stats;
+  }
+
+private:
+  // keep the payload 16 byte aligned behind the header
+  static const size_t HEADER_SIZE = 16;
+  // 1 KiB up to 8 MiB, larger payloads are not pooled
+  static const unsigned int MIN_CLASS_SHIFT = 10;
+  static const unsigned int SIZE_CLASSES = 14;
+  static const uint64_t MAX_POOLED_BYTES = 32 * 1024 * 1024;
+
+  static size_t GetClassSize(unsigned int sizeClass)
+  {
+    return static_cast<size_t>(1) << (sizeClass + MIN_CLASS_SHIFT);
+  }
+
+  static unsigned int GetSizeClass(size_t size)
+  {
+    unsigned int sizeClass = 0;
+    while (sizeClass < SIZE_CLASSES && GetClassSize(sizeClass) < size)
+      sizeClass++;
+    return sizeClass;
+  }
+
+  mutable CCriticalSection m_section;
+  std::vector<uint8_t*> m_freeLists[SIZE_CLASSES];
+  DemuxPacketPoolStats m_stats;
+};
+
+CDemuxPacketPool& GetPacketPool()
+{
+  static CDemuxPacketPool pool;
+  return pool;
+}
+
+// payloads smaller than this are cheaper to copy than to track
+const int ZERO_COPY_MIN_SIZE = 16 * 1024;
+
+}
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
-    if (pPacket->pData)
-      _aligned_free(pPacket->pData);
+    if (pPacket->pBufferRef)
+    {
+      AVBufferRef *ref = static_cast<AVBufferRef*>(pPacket->pBufferRef);
+      av_buffer_unref(&ref);
+    }
+    else if (pPacket->pData)
+      GetPacketPool().Free(pPacket->pData);
     if (pPacket->iSideDataElems)
     {
       AVPacket avPkt;
@@ -64,7 +189,7 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16);
+    pPacket->pData = GetPacketPool().Allocate(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE);
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
@@ -78,6 +203,36 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
   return pPacket;
 }
 
+DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(const AVPacket &src)
+{
+  // ffmpeg packet buffers are padded, so the payload can be handed to the
+  // codecs as is as long as the packet owns a reference counted buffer
+  if (src.buf && src.data && src.size >= ZERO_COPY_MIN_SIZE &&
+      src.data >= src.buf->data &&
+      src.data + src.size + AV_INPUT_BUFFER_PADDING_SIZE <= src.buf->data + src.buf->size)
+  {
+    AVBufferRef *ref = av_buffer_ref(src.buf);
+    if (ref)
+    {
+      DemuxPacket* pPacket = new DemuxPacket();
+      pPacket->pBufferRef = ref;
+      pPacket->pData = src.data;
+      pPacket->iSize = src.size;
+      GetPacketPool().AddReferenced(src.size);
+      return pPacket;
+    }
+  }
+
+  DemuxPacket* pPacket = AllocateDemuxPacket(src.size);
+  if (pPacket && src.data)
+  {
+    pPacket->iSize = src.size;
+    memcpy(pPacket->pData, src.data, src.size);
+    GetPacketPool().AddCopied(src.size);
+  }
+  return pPacket;
+}
+
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount)
 {
   DemuxPacket *ret(AllocateDemuxPacket(iDataSize));
@@ -94,3 +249,8 @@ void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
   pkt->pSideData = avPkt.side_data;
   pkt->iSideDataElems = avPkt.side_data_elems;
 }
+
+DemuxPacketPoolStats CDVDDemuxUtils::GetPoolStats()
+{
+  return GetPacketPool().GetStats();
+}
@@ -25,12 +25,30 @@ extern "C" {
 #include "libavcodec/avcodec.h"
 }
 
+#include <stdint.h>
+
+struct DemuxPacketPoolStats
+{
+  uint64_t poolHits = 0;        // allocations served from a recycled buffer
+  uint64_t poolMisses = 0;      // allocations that needed a new buffer
+  uint64_t bytesCopied = 0;     // payload bytes copied out of ffmpeg packets
+  uint64_t bytesReferenced = 0; // payload bytes handed over without a copy
+  uint64_t bytesPooled = 0;     // bytes currently held in the free lists
+};
+
 class CDVDDemuxUtils
 {
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
+  /*!
+   * \brief Create a packet with the payload of an ffmpeg packet.
+   * Large reference counted payloads are referenced instead of copied,
+   * the reference is dropped again by FreeDemuxPacket.
+   */
+  static DemuxPacket* AllocateDemuxPacket(const AVPacket &src);
   static void StoreSideData(DemuxPacket *pkt, AVPacket *src);
+  static DemuxPacketPoolStats GetPoolStats();
 };
 
@@ -46,6 +46,7 @@ public:
     GENERAL_SYNCHRONIZE,            //
     GENERAL_GUI_ACTION,             // gui action of some sort
     GENERAL_EOF,                    // eof of stream
+    GENERAL_SKIP,                   // drop output before a pts, decoder keeps going
 
     // player core related messages (cVideoPlayer.cpp)
     PLAYER_SET_AUDIOSTREAM,         //
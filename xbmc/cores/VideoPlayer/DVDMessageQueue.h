@@ -23,7 +23,7 @@
 #include "DVDMessage.h"
 #include <atomic>
 #include <string>
-#include <list>
+#include <deque>
 #include <algorithm>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
@@ -41,6 +41,12 @@ struct DVDMessageListItem
     priority = 0;
   }
   DVDMessageListItem(const DVDMessageListItem&) = delete;
+  DVDMessageListItem(DVDMessageListItem&& other) noexcept
+  {
+    message = other.message;
+    priority = other.priority;
+    other.message = NULL;
+  }
  ~DVDMessageListItem()
   {
     if(message)
@@ -48,6 +54,12 @@ struct DVDMessageListItem
   }
 
   DVDMessageListItem& operator=(const DVDMessageListItem&) = delete;
+  DVDMessageListItem& operator=(DVDMessageListItem&& other) noexcept
+  {
+    std::swap(message, other.message);
+    std::swap(priority, other.priority);
+    return *this;
+  }
 
   CDVDMsg* message;
   int priority;
@@ -116,6 +128,7 @@ private:
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
+  int m_waiters = 0;
 
   std::atomic<bool> m_bAbortRequest;
   bool m_bInitialized;
@@ -129,7 +142,9 @@ private:
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
-  std::list<DVDMessageListItem> m_prioMessages;
+  // deques are used instead of lists, so that queueing a message does not
+  // need a heap allocation per item on the demuxer -> decoder hot path
+  std::deque<DVDMessageListItem> m_messages;
+  std::deque<DVDMessageListItem> m_prioMessages;
 };
 
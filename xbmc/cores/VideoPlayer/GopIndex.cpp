@@ -0,0 +1,129 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GopIndex.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+
+#include <algorithm>
+#include <cmath>
+
+// keyframes closer than this are the same one
+#define GOP_PTS_TOLERANCE DVD_MSEC_TO_TIME(1)
+// plenty for a few hours at short gop lengths
+#define GOP_MAX_ENTRIES 100000
+
+void CGopIndex::Clear()
+{
+  m_keyframes.clear();
+  m_hasLast = false;
+}
+
+size_t CGopIndex::Find(double pts) const
+{
+  auto it = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), pts,
+                             [](double value, const Keyframe &keyframe) { return value < keyframe.pts; });
+  return it - m_keyframes.begin();
+}
+
+void CGopIndex::Add(double pts, bool contiguous)
+{
+  if (pts == DVD_NOPTS_VALUE)
+    return;
+
+  size_t pos = Find(pts);
+
+  // a keyframe within tolerance was seen before
+  size_t same = m_keyframes.size();
+  if (pos > 0 && std::abs(m_keyframes[pos - 1].pts - pts) < GOP_PTS_TOLERANCE)
+    same = pos - 1;
+  else if (pos < m_keyframes.size() && std::abs(m_keyframes[pos].pts - pts) < GOP_PTS_TOLERANCE)
+    same = pos;
+
+  // only links to the keyframe added before if that one is the direct predecessor
+  size_t entry = same < m_keyframes.size() ? same : pos;
+  bool linked = contiguous && m_hasLast && entry > 0 &&
+                std::abs(m_keyframes[entry - 1].pts - m_lastPts) < GOP_PTS_TOLERANCE;
+
+  if (same < m_keyframes.size())
+  {
+    if (linked)
+      m_keyframes[same].contiguous = true;
+  }
+  else if (m_keyframes.size() < GOP_MAX_ENTRIES)
+  {
+    // the gop this keyframe splits has not been read through up to its end
+    if (pos < m_keyframes.size())
+      m_keyframes[pos].contiguous = false;
+
+    m_keyframes.insert(m_keyframes.begin() + pos, { pts, linked });
+  }
+
+  m_lastPts = pts;
+  m_hasLast = true;
+}
+
+double CGopIndex::GetKeyframe(double pts) const
+{
+  size_t pos = Find(pts);
+  if (pos == 0)
+    return DVD_NOPTS_VALUE;
+
+  return m_keyframes[pos - 1].pts;
+}
+
+double CGopIndex::GetNextKeyframe(double pts) const
+{
+  size_t pos = Find(pts);
+  if (pos > 0 && m_keyframes[pos - 1].pts == pts)
+    return pts;
+  if (pos == m_keyframes.size())
+    return DVD_NOPTS_VALUE;
+
+  return m_keyframes[pos].pts;
+}
+
+double CGopIndex::GetNearestKeyframe(double pts, double maxDistance) const
+{
+  double before = GetKeyframe(pts);
+  double after = GetNextKeyframe(pts);
+
+  double nearest = DVD_NOPTS_VALUE;
+  double distance = maxDistance;
+  if (before != DVD_NOPTS_VALUE && pts - before <= distance)
+  {
+    nearest = before;
+    distance = pts - before;
+  }
+  if (after != DVD_NOPTS_VALUE && after - pts < distance)
+    nearest = after;
+
+  return nearest;
+}
+
+bool CGopIndex::GetGop(double pts, double &start, double &end) const
+{
+  size_t pos = Find(pts);
+  if (pos == 0 || pos == m_keyframes.size() || !m_keyframes[pos].contiguous)
+    return false;
+
+  start = m_keyframes[pos - 1].pts;
+  end = m_keyframes[pos].pts;
+  return true;
+}
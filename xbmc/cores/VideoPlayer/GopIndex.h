@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstddef>
+#include <vector>
+
+/*!
+ * \brief Index of video keyframes seen while playing.
+ *
+ * Keyframes are kept sorted by pts. An entry is marked contiguous if the
+ * stream was read without a gap since the keyframe before it, only then the
+ * bounds of a group of pictures are known.
+ */
+class CGopIndex
+{
+public:
+  CGopIndex() = default;
+
+  void Clear();
+  void Add(double pts, bool contiguous);
+
+  double GetKeyframe(double pts) const;     //last keyframe at or before pts
+  double GetNextKeyframe(double pts) const; //first keyframe at or after pts
+  double GetNearestKeyframe(double pts, double maxDistance) const;
+  bool GetGop(double pts, double &start, double &end) const; //gop holding pts, if both ends were seen
+
+  bool IsEmpty() const { return m_keyframes.empty(); }
+  size_t Size() const { return m_keyframes.size(); }
+
+private:
+  struct Keyframe
+  {
+    double pts;
+    bool contiguous; //no keyframe between the previous entry and this one
+  };
+
+  size_t Find(double pts) const; //index of the first entry after pts
+
+  std::vector<Keyframe> m_keyframes;
+  double m_lastPts = 0.0;
+  bool m_hasLast = false;
+};
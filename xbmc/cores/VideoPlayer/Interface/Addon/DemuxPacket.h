@@ -49,4 +49,7 @@ typedef struct DemuxPacket
   bool recoveryPoint = false;
 
   std::shared_ptr<DemuxCryptoInfo> cryptoInfo;
+
+  bool keyFrame = false; // packet starts a picture that can be decoded on its own
+  void *pBufferRef = nullptr; // ffmpeg buffer pData points into, unreferenced when the packet is freed
 } DemuxPacket;
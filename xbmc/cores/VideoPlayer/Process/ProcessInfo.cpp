@@ -80,6 +80,10 @@ void CProcessInfo::ResetVideoCodecInfo()
   m_videoHeight = 0;
   m_videoFPS = 0.0;
   m_videoDAR = 0.0;
+  m_videoDecoderThreads = 0;
+  m_videoDecoderThreadMethod.clear();
+  m_videoDecodeTime = 0.0;
+  m_videoDecoderLoad = 0.0;
   m_deintMethods.clear();
   m_deintMethods.push_back(EINTERLACEMETHOD::VS_INTERLACEMETHOD_NONE);
   m_deintMethodDefault = EINTERLACEMETHOD::VS_INTERLACEMETHOD_NONE;
@@ -93,6 +97,8 @@ void CProcessInfo::ResetVideoCodecInfo()
     m_dataCache->SetVideoDimensions(m_videoWidth, m_videoHeight);
     m_dataCache->SetVideoFps(m_videoFPS);
     m_dataCache->SetVideoDAR(m_videoDAR);
+    m_dataCache->SetVideoDecoderThreads(m_videoDecoderThreads, m_videoDecoderThreadMethod);
+    m_dataCache->SetVideoDecoderLoad(m_videoDecodeTime, m_videoDecoderLoad);
     m_dataCache->SetStateSeeking(m_stateSeeking);
     m_dataCache->SetVideoStereoMode(m_videoStereoMode);
   }
@@ -227,6 +233,42 @@ float CProcessInfo::GetVideoDAR()
   return m_videoDAR;
 }
 
+void CProcessInfo::SetVideoDecoderThreads(int threads, const std::string &method)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  m_videoDecoderThreads = threads;
+  m_videoDecoderThreadMethod = method;
+
+  if (m_dataCache)
+    m_dataCache->SetVideoDecoderThreads(m_videoDecoderThreads, m_videoDecoderThreadMethod);
+}
+
+int CProcessInfo::GetVideoDecoderThreads()
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  return m_videoDecoderThreads;
+}
+
+void CProcessInfo::SetVideoDecoderLoad(float decodeTime, float load)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  m_videoDecodeTime = decodeTime;
+  m_videoDecoderLoad = load;
+
+  if (m_dataCache)
+    m_dataCache->SetVideoDecoderLoad(m_videoDecodeTime, m_videoDecoderLoad);
+}
+
+float CProcessInfo::GetVideoDecoderLoad()
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  return m_videoDecoderLoad;
+}
+
 EINTERLACEMETHOD CProcessInfo::GetFallbackDeintMethod()
 {
   return VS_INTERLACEMETHOD_DEINTERLACE;
@@ -396,6 +438,15 @@ int CProcessInfo::GetAudioBitsPerSample()
   return m_audioBitsPerSample;
 }
 
+AELatencyStats CProcessInfo::GetAudioEngineStats()
+{
+  // published by the audio engine, not by the player
+  if (m_dataCache)
+    return m_dataCache->GetAudioEngineStats();
+
+  return AELatencyStats();
+}
+
 bool CProcessInfo::AllowDTSHDDecode()
 {
   return true;
@@ -23,6 +23,7 @@
 #include "cores/IPlayer.h"
 #include "cores/VideoSettings.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderInfo.h"
+#include "cores/AudioEngine/Utils/AELatencyStats.h"
 #include "threads/CriticalSection.h"
 #include <atomic>
 #include <list>
@@ -59,6 +60,10 @@ public:
   float GetVideoFps();
   void SetVideoDAR(float dar);
   float GetVideoDAR();
+  void SetVideoDecoderThreads(int threads, const std::string &method);
+  int GetVideoDecoderThreads();
+  void SetVideoDecoderLoad(float decodeTime, float load);
+  float GetVideoDecoderLoad();
   virtual EINTERLACEMETHOD GetFallbackDeintMethod();
   virtual void SetSwDeinterlacingMethods();
   void UpdateDeinterlacingMethods(std::list<EINTERLACEMETHOD> &methods);
@@ -80,6 +85,7 @@ public:
   void SetAudioBitsPerSample(int bitsPerSample);
   int GetAudioBitsPerSample();
   virtual bool AllowDTSHDDecode();
+  AELatencyStats GetAudioEngineStats();
 
   // render info
   void SetRenderClockSync(bool enabled);
@@ -131,6 +137,10 @@ protected:
   int m_videoHeight;
   float m_videoFPS;
   float m_videoDAR;
+  int m_videoDecoderThreads;
+  std::string m_videoDecoderThreadMethod;
+  float m_videoDecodeTime;
+  float m_videoDecoderLoad;
   std::list<EINTERLACEMETHOD> m_deintMethods;
   EINTERLACEMETHOD m_deintMethodDefault;
   CCriticalSection m_videoCodecSection;
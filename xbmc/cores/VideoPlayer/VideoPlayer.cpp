@@ -1744,6 +1744,12 @@ void CVideoPlayer::ProcessVideoData(CDemuxStream* pStream, DemuxPacket* pPacket)
   if (CheckSceneSkip(m_CurrentVideo))
     drop = true;
 
+  if (pPacket->keyFrame && CanUseGopIndex())
+  {
+    m_gopIndex.Add(pPacket->pts != DVD_NOPTS_VALUE ? pPacket->pts : pPacket->dts, m_gopContiguous);
+    m_gopContiguous = true;
+  }
+
   m_VideoPlayerVideo->SendMessage(new CDVDMsgDemuxerPacket(pPacket, drop));
   m_CurrentVideo.packets++;
 }
@@ -2322,6 +2328,69 @@ bool CVideoPlayer::CheckContinuity(CCurrentStream& current, DemuxPacket* pPacket
   return true;
 }
 
+bool CVideoPlayer::CanUseGopIndex()
+{
+  // keyframe pts must match demuxer seek times
+  if (!m_pInputStream || m_pInputStream->IsRealtime() ||
+      std::dynamic_pointer_cast<CDVDInputStream::IMenus>(m_pInputStream))
+    return false;
+
+  return m_offset_pts == 0.0 && m_State.time_offset == 0.0;
+}
+
+bool CVideoPlayer::SkipToTime(double target)
+{
+  // a short seek ahead that stays in the gop being decoded doesn't need to
+  // go back to its keyframe: the demuxer and decoders carry on and the
+  // stream players drop everything before the target
+  if (!CanUseGopIndex() || m_omxplayer_mode || m_CurrentVideo.id < 0)
+    return false;
+
+  if (m_playSpeed != DVD_PLAYSPEED_NORMAL && m_playSpeed != DVD_PLAYSPEED_PAUSE)
+    return false;
+
+  if (m_CurrentVideo.syncState != IDVDStreamPlayer::SYNC_INSYNC ||
+      (m_CurrentAudio.id >= 0 && m_CurrentAudio.syncState != IDVDStreamPlayer::SYNC_INSYNC))
+    return false;
+
+  double current = m_clock.GetClock();
+  if (target <= current || target - current > DVD_SEC_TO_TIME(10))
+    return false;
+
+  // with a keyframe in between, a seek to it decodes less. without one
+  // indexed, the target is only known to be in this gop once the demuxer
+  // has read past it
+  double keyframe = m_gopIndex.GetNextKeyframe(current);
+  if (keyframe != DVD_NOPTS_VALUE)
+  {
+    if (keyframe <= target)
+      return false;
+  }
+  else if (m_CurrentVideo.dts == DVD_NOPTS_VALUE || m_CurrentVideo.dts <= target)
+    return false;
+
+  CLog::Log(LOGDEBUG, "CVideoPlayer::SkipToTime - skipping from %f to %f without flush", current / 1000, target / 1000);
+  m_seekSkipped = true;
+
+  m_VideoPlayerVideo->SendMessage(new CDVDMsgDouble(CDVDMsg::GENERAL_SKIP, target), 1);
+  m_CurrentVideo.syncState = IDVDStreamPlayer::SYNC_STARTING;
+  m_CurrentVideo.avsync = CCurrentStream::AV_SYNC_FORCE;
+  if (m_CurrentAudio.id >= 0)
+  {
+    m_VideoPlayerAudio->SendMessage(new CDVDMsgDouble(CDVDMsg::GENERAL_SKIP, target), 1);
+    m_CurrentAudio.syncState = IDVDStreamPlayer::SYNC_STARTING;
+    m_CurrentAudio.avsync = CCurrentStream::AV_SYNC_FORCE;
+  }
+
+  m_messenger.Flush(CDVDMsg::PLAYER_STARTED);
+  SetCaching(CACHESTATE_FLUSH);
+  m_clock.Discontinuity(target);
+  m_State.dts = target;
+  m_State.lastSeek = m_clock.GetAbsoluteClock();
+  UpdatePlayState(0);
+  return true;
+}
+
 bool CVideoPlayer::CheckSceneSkip(CCurrentStream& current)
 {
   if(!m_Edl.HasCut())
@@ -2570,6 +2639,7 @@ void CVideoPlayer::HandleMessages()
       m_pInputStream.reset();
 
       m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NONE);
+      m_gopIndex.Clear();
 
       Prepare();
     }
@@ -2624,8 +2694,54 @@ void CVideoPlayer::HandleMessages()
       if (m_pInputStream->GetIPosTime() == nullptr)
         time -= m_State.time_offset/1000l;
 
-      CLog::Log(LOGDEBUG, "demuxer seek to: %f", time);
-      if (m_pDemuxer && m_pDemuxer->SeekTime(time, msg.GetBackward(), &start))
+      m_seekRequest = m_clock.GetAbsoluteClock();
+      m_seekSkipped = false;
+
+      if (msg.GetAccurate() && msg.GetSync() && !msg.GetTrickPlay() &&
+          SkipToTime(DVD_MSEC_TO_TIME(time)))
+      {
+        g_infoManager.SetDisplayAfterSeek();
+        m_processInfo->SetStateSeeking(false);
+        pMsg->Release();
+        continue;
+      }
+
+      // seek right to a keyframe seen before, accurate seeks only if no
+      // other keyframe was missed in between, so decoding starts as close
+      // to the target as possible and scrub steps show a picture at once
+      double seekTime = time;
+      bool backward = msg.GetBackward();
+      double keyframe = DVD_NOPTS_VALUE;
+      if (CanUseGopIndex() && !m_gopIndex.IsEmpty())
+      {
+        double target = DVD_MSEC_TO_TIME(time);
+        double gopStart, gopEnd;
+        if (msg.GetAccurate())
+        {
+          if (m_gopIndex.GetGop(target, gopStart, gopEnd))
+            keyframe = gopStart;
+        }
+        else
+        {
+          double current = m_clock.GetClock();
+          keyframe = m_gopIndex.GetNearestKeyframe(target, DVD_SEC_TO_TIME(5));
+          if (keyframe != DVD_NOPTS_VALUE &&
+              (backward ? keyframe >= current : keyframe <= current))
+            keyframe = DVD_NOPTS_VALUE;
+        }
+
+        if (keyframe != DVD_NOPTS_VALUE)
+        {
+          CLog::Log(LOGDEBUG, "demuxer seek to indexed keyframe: %f for %f", keyframe / 1000, time);
+          // round up, a backward seek to a time truncated below the
+          // keyframe would land on the one before it
+          seekTime = ceil(DVD_TIME_TO_MSEC(keyframe));
+          backward = true;
+        }
+      }
+
+      CLog::Log(LOGDEBUG, "demuxer seek to: %f", seekTime);
+      if (m_pDemuxer && m_pDemuxer->SeekTime(seekTime, backward, &start))
       {
         CLog::Log(LOGDEBUG, "demuxer seek to: %f, success", time);
         if(m_pSubtitleDemuxer)
@@ -2636,6 +2752,9 @@ void CVideoPlayer::HandleMessages()
         // dts after successful seek
         if (start == DVD_NOPTS_VALUE)
           start = DVD_MSEC_TO_TIME(time) - m_State.time_offset;
+        // accurate seeks still start at the target
+        else if (keyframe != DVD_NOPTS_VALUE && msg.GetAccurate())
+          start = DVD_MSEC_TO_TIME(time);
 
         m_State.dts = start;
         m_State.lastSeek = m_clock.GetAbsoluteClock();
@@ -2955,6 +3074,14 @@ void CVideoPlayer::HandleMessages()
         m_CurrentVideo.cachetime = msg.cachetime;
         m_CurrentVideo.cachetotal = msg.cachetotal;
         m_CurrentVideo.starttime = msg.timestamp;
+
+        if (m_seekRequest != DVD_NOPTS_VALUE)
+        {
+          CLog::Log(LOGDEBUG, "CVideoPlayer::HandleMessages - seek to first frame took %d ms%s",
+                    DVD_TIME_TO_MSEC(m_clock.GetAbsoluteClock() - m_seekRequest),
+                    m_seekSkipped ? " (no flush)" : "");
+          m_seekRequest = DVD_NOPTS_VALUE;
+        }
       }
       CLog::Log(LOGDEBUG, "CVideoPlayer::HandleMessages - player started %d", msg.player);
     }
@@ -3703,6 +3830,9 @@ bool CVideoPlayer::OpenVideoStream(CDVDStreamInfo& hint, bool reset)
     if (!player->OpenStream(hint))
       return false;
 
+    m_gopIndex.Clear();
+    m_gopContiguous = false;
+
     // look for any EDL files
     m_Edl.Clear();
     if (hint.fpsrate > 0 && hint.fpsscale > 0)
@@ -3867,6 +3997,7 @@ void CVideoPlayer::FlushBuffers(double pts, bool accurate, bool sync)
   m_CurrentVideo.dts         = DVD_NOPTS_VALUE;
   m_CurrentVideo.startpts    = startpts;
   m_CurrentVideo.packets = 0;
+  m_gopContiguous = false;
 
   m_CurrentSubtitle.dts      = DVD_NOPTS_VALUE;
   m_CurrentSubtitle.startpts = startpts;
@@ -36,6 +36,7 @@
 #include "VideoPlayerTeletext.h"
 #include "VideoPlayerRadioRDS.h"
 #include "Edl.h"
+#include "GopIndex.h"
 #include "FileItem.h"
 #include "threads/SystemClock.h"
 #include "threads/Thread.h"
@@ -463,6 +464,8 @@ protected:
   void SynchronizeDemuxer();
   void CheckAutoSceneSkip();
   bool CheckContinuity(CCurrentStream& current, DemuxPacket* pPacket);
+  bool CanUseGopIndex();
+  bool SkipToTime(double target);
   bool CheckSceneSkip(CCurrentStream& current);
   bool CheckPlayerInit(CCurrentStream& current);
   void UpdateCorrection(DemuxPacket* pkt, double correction);
@@ -586,6 +589,11 @@ protected:
   CEdl m_Edl;
   bool m_SkipCommercials;
 
+  CGopIndex m_gopIndex;
+  bool m_gopContiguous = false;  // no packets skipped since the last keyframe
+  double m_seekRequest = DVD_NOPTS_VALUE; // absolute clock when the last seek was handled
+  bool m_seekSkipped = false; // the last seek decoded ahead instead of flushing
+
   bool m_HasVideo;
   bool m_HasAudio;
 
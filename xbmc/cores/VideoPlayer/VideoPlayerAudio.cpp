@@ -68,6 +68,7 @@ CVideoPlayerAudio::CVideoPlayerAudio(CDVDClock* pClock, CDVDMessageQueue& parent
   m_stalled = true;
   m_paused = false;
   m_syncState = IDVDStreamPlayer::SYNC_STARTING;
+  m_skipTo = DVD_NOPTS_VALUE;
   m_synctype = SYNC_DISCON;
   m_setsynctype = SYNC_DISCON;
   m_prevsynctype = -1;
@@ -336,6 +337,7 @@ void CVideoPlayerAudio::Process()
       m_audioClock = 0;
       audioframe.nb_frames = 0;
       m_syncState = IDVDStreamPlayer::SYNC_STARTING;
+      m_skipTo = DVD_NOPTS_VALUE;
     }
     else if (pMsg->IsType(CDVDMsg::GENERAL_FLUSH))
     {
@@ -344,6 +346,7 @@ void CVideoPlayerAudio::Process()
       m_stalled = true;
       m_audioClock = 0;
       audioframe.nb_frames = 0;
+      m_skipTo = DVD_NOPTS_VALUE;
 
       if (sync)
       {
@@ -354,6 +357,19 @@ void CVideoPlayerAudio::Process()
       if (m_pAudioCodec)
         m_pAudioCodec->Reset();
     }
+    else if (pMsg->IsType(CDVDMsg::GENERAL_SKIP))
+    {
+      // short seek ahead: drop what the sink holds and all audio before
+      // the target, then sync again
+      m_skipTo = static_cast<CDVDMsgDouble*>(pMsg)->m_value;
+      m_audioSink.Flush();
+      m_audioSink.Pause();
+      m_stalled = true;
+      audioframe.nb_frames = 0;
+      m_syncState = IDVDStreamPlayer::SYNC_STARTING;
+
+      CLog::Log(LOGDEBUG, "CVideoPlayerAudio - CDVDMsg::GENERAL_SKIP(%f)", m_skipTo);
+    }
     else if (pMsg->IsType(CDVDMsg::GENERAL_EOF))
     {
       CLog::Log(LOGDEBUG, "CVideoPlayerAudio - CDVDMsg::GENERAL_EOF");
@@ -399,6 +415,10 @@ void CVideoPlayerAudio::Process()
       DemuxPacket* pPacket = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
       bool bPacketDrop  = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacketDrop();
 
+      if (m_skipTo != DVD_NOPTS_VALUE && pPacket->pts != DVD_NOPTS_VALUE &&
+          pPacket->pts + pPacket->duration < m_skipTo)
+        bPacketDrop = true;
+
       if (bPacketDrop ||
           (!m_processInfo.IsTempoAllowed(static_cast<float>(m_speed)/DVD_PLAYSPEED_NORMAL) &&
            m_syncState == IDVDStreamPlayer::SYNC_INSYNC))
@@ -451,6 +471,16 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe)
       m_audioClock = audioframe.pts;
     }
 
+    if (m_skipTo != DVD_NOPTS_VALUE)
+    {
+      if (audioframe.hasTimestamp && audioframe.pts + audioframe.duration <= m_skipTo)
+      {
+        audioframe.nb_frames = 0;
+        return true;
+      }
+      m_skipTo = DVD_NOPTS_VALUE;
+    }
+
     if (audioframe.format.m_sampleRate && m_streaminfo.samplerate != (int) audioframe.format.m_sampleRate)
     {
       // The sample rate has changed or we just got it for the first time
@@ -97,6 +97,7 @@ protected:
   bool m_stalled;
   bool m_paused;
   IDVDStreamPlayer::ESyncState m_syncState;
+  double m_skipTo; // audio before this pts is dropped, see GENERAL_SKIP
   XbmcThreads::EndTime m_syncTimer;
 
   //SYNC_DISCON, SYNC_SKIPDUP, SYNC_RESAMPLE
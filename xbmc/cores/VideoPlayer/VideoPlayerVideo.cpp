@@ -74,6 +74,7 @@ CVideoPlayerVideo::CVideoPlayerVideo(CDVDClock* pClock
   m_stalled = false;
   m_paused = false;
   m_syncState = IDVDStreamPlayer::SYNC_STARTING;
+  m_skipTo = DVD_NOPTS_VALUE;
   m_iSubtitleDelay = 0;
   m_iLateFrames = 0;
   m_iDroppedRequest = 0;
@@ -442,6 +443,7 @@ void CVideoPlayerVideo::Process()
       m_packets.clear();
       m_droppingStats.Reset();
       m_syncState = IDVDStreamPlayer::SYNC_STARTING;
+      m_skipTo = DVD_NOPTS_VALUE;
       m_rewindStalled = false;
     }
     else if (pMsg->IsType(CDVDMsg::GENERAL_FLUSH)) // private message sent by (CVideoPlayerVideo::Flush())
@@ -456,6 +458,7 @@ void CVideoPlayerVideo::Process()
       }
       m_packets.clear();
       pts = 0;
+      m_skipTo = DVD_NOPTS_VALUE;
       m_rewindStalled = false;
 
       m_ptsTracker.Flush();
@@ -470,6 +473,23 @@ void CVideoPlayerVideo::Process()
 
       m_renderManager.DiscardBuffer();
     }
+    else if (pMsg->IsType(CDVDMsg::GENERAL_SKIP))
+    {
+      // short seek ahead: keep the decoder, drop what is queued for display
+      // and everything decoded before the target, then sync again
+      m_skipTo = static_cast<CDVDMsgDouble*>(pMsg)->m_value;
+      if (m_picture.videoBuffer)
+      {
+        m_picture.videoBuffer->Release();
+        m_picture.videoBuffer = nullptr;
+      }
+      m_outputSate = OUTPUT_NORMAL;
+      m_droppingStats.Reset();
+      m_syncState = IDVDStreamPlayer::SYNC_STARTING;
+      m_renderManager.DiscardBuffer();
+
+      CLog::Log(LOGDEBUG, "CVideoPlayerVideo - CDVDMsg::GENERAL_SKIP(%f)", m_skipTo);
+    }
     else if (pMsg->IsType(CDVDMsg::PLAYER_SETSPEED))
     {
       m_speed = static_cast<CDVDMsgInt*>(pMsg)->m_value;
@@ -557,6 +577,12 @@ void CVideoPlayerVideo::Process()
         codecControl |= DVD_CODEC_CTRL_NO_POSTPROC;
       if (bPacketDrop)
         codecControl |= DVD_CODEC_CTRL_DROP;
+      if (m_skipTo != DVD_NOPTS_VALUE)
+      {
+        double packetPts = pPacket->pts != DVD_NOPTS_VALUE ? pPacket->pts : pPacket->dts;
+        if (packetPts != DVD_NOPTS_VALUE && packetPts < m_skipTo)
+          codecControl |= DVD_CODEC_CTRL_DROP;
+      }
       if (bRequestDrop)
         codecControl |= DVD_CODEC_CTRL_DROP_ANY;
       if (!m_renderManager.Supports(RENDERFEATURE_ROTATION))
@@ -723,6 +749,14 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
     if (m_speed != 0)
       pts += m_picture.iDuration * m_speed / abs(m_speed);
 
+    if (m_skipTo != DVD_NOPTS_VALUE)
+    {
+      if (m_picture.pts < m_skipTo)
+        m_picture.iFlags |= DVP_FLAG_DROPPED;
+      else
+        m_skipTo = DVD_NOPTS_VALUE;
+    }
+
     m_outputSate = OutputPicture(&m_picture);
 
     if (m_outputSate == OUTPUT_AGAIN)
@@ -137,6 +137,7 @@ protected:
   std::atomic_bool m_rewindStalled;
   bool m_paused;
   IDVDStreamPlayer::ESyncState m_syncState;
+  double m_skipTo;           // pictures before this pts are dropped, see GENERAL_SKIP
   std::atomic_bool m_bAbortOutput;
 
   BitstreamStats m_videoStats;
@@ -0,0 +1,140 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxKeyframeIndex.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+CDVDDemuxKeyframeIndex::Identity GetIdentity()
+{
+  CDVDDemuxKeyframeIndex::Identity identity;
+  identity.fileSize = 4700000000LL;
+  identity.modTime = 1514764800;
+  identity.stream = 0;
+  identity.codec = 27;
+  identity.timeBaseNum = 1;
+  identity.timeBaseDen = 90000;
+  return identity;
+}
+}
+
+TEST(TestDVDDemuxKeyframeIndex, Add)
+{
+  CDVDDemuxKeyframeIndex index;
+  index.Add(180000, 2000);
+  index.Add(0, 0);
+  index.Add(90000, 1000);
+  index.Add(90000, 1100);
+  index.Add(270000, -1);
+
+  ASSERT_EQ(3U, index.Size());
+  EXPECT_EQ(0, index.GetEntries()[0].timestamp);
+  EXPECT_EQ(90000, index.GetEntries()[1].timestamp);
+  EXPECT_EQ(1100, index.GetEntries()[1].pos);
+  EXPECT_EQ(180000, index.GetEntries()[2].timestamp);
+}
+
+TEST(TestDVDDemuxKeyframeIndex, RoundTrip)
+{
+  CDVDDemuxKeyframeIndex index;
+  for (int64_t i = 0; i < 1000; i++)
+    index.Add(i * 180000 + 3600, i * 1500000 + (i % 7) * 188);
+
+  std::string data;
+  index.Serialize(GetIdentity(), data);
+  // deltas of a few seconds and megabytes take a handful of bytes each
+  EXPECT_LT(data.size(), 8000U);
+
+  CDVDDemuxKeyframeIndex loaded;
+  ASSERT_TRUE(loaded.Deserialize(GetIdentity(), data));
+  ASSERT_EQ(index.Size(), loaded.Size());
+  for (size_t i = 0; i < index.Size(); i++)
+  {
+    EXPECT_EQ(index.GetEntries()[i].timestamp, loaded.GetEntries()[i].timestamp);
+    EXPECT_EQ(index.GetEntries()[i].pos, loaded.GetEntries()[i].pos);
+  }
+}
+
+TEST(TestDVDDemuxKeyframeIndex, Reject)
+{
+  CDVDDemuxKeyframeIndex index;
+  index.Add(0, 0);
+  index.Add(90000, 564);
+
+  std::string data;
+  index.Serialize(GetIdentity(), data);
+
+  CDVDDemuxKeyframeIndex loaded;
+  CDVDDemuxKeyframeIndex::Identity other = GetIdentity();
+  other.fileSize++;
+  EXPECT_FALSE(loaded.Deserialize(other, data));
+  EXPECT_TRUE(loaded.IsEmpty());
+
+  other = GetIdentity();
+  other.modTime++;
+  EXPECT_FALSE(loaded.Deserialize(other, data));
+  EXPECT_TRUE(loaded.IsEmpty());
+
+  EXPECT_FALSE(loaded.Deserialize(GetIdentity(), data.substr(0, data.size() - 1)));
+  EXPECT_FALSE(loaded.Deserialize(GetIdentity(), ""));
+  EXPECT_FALSE(loaded.Deserialize(GetIdentity(), "garbage"));
+  EXPECT_TRUE(loaded.IsEmpty());
+
+  EXPECT_TRUE(loaded.Deserialize(GetIdentity(), data));
+  EXPECT_EQ(2U, loaded.Size());
+}
+
+TEST(TestDVDDemuxKeyframeIndex, PruneCache)
+{
+  const std::string folder = "special://temp/keyframes/";
+  ASSERT_TRUE(XFILE::CDirectory::Create(folder));
+
+  const std::string data(1000, 'x');
+  for (int i = 0; i < 4; i++)
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(StringUtils::Format("%s%d.kfi", folder.c_str(), i), true));
+    ASSERT_EQ(static_cast<ssize_t>(data.size()), file.Write(data.c_str(), data.size()));
+  }
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(folder + "other.txt", true));
+  }
+
+  // within the limit nothing goes
+  CDVDDemuxKeyframeIndex::PruneCache(folder, 4000);
+  int left = 0;
+  for (int i = 0; i < 4; i++)
+    left += XFILE::CFile::Exists(StringUtils::Format("%s%d.kfi", folder.c_str(), i));
+  EXPECT_EQ(4, left);
+
+  CDVDDemuxKeyframeIndex::PruneCache(folder, 2500);
+  left = 0;
+  for (int i = 0; i < 4; i++)
+    left += XFILE::CFile::Exists(StringUtils::Format("%s%d.kfi", folder.c_str(), i));
+  EXPECT_EQ(2, left);
+  EXPECT_TRUE(XFILE::CFile::Exists(folder + "other.txt"));
+
+  XFILE::CDirectory::RemoveRecursive(folder);
+}
@@ -0,0 +1,182 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "threads/SystemClock.h"
+#include "threads/test/TestHelpers.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <string>
+
+namespace
+{
+CDVDMsgDemuxerPacket* CreatePacket(int size, double dts)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->iSize = size;
+  packet->dts = dts;
+  packet->pts = dts;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+class PacketProducer : public IRunnable
+{
+public:
+  PacketProducer(CDVDMessageQueue& queue, unsigned int count) : m_queue(queue), m_count(count) {}
+
+  void Run() override
+  {
+    for (unsigned int i = 0; i < m_count; i++)
+    {
+      // keep the queue bounded like CVideoPlayer does
+      while (m_queue.IsFull())
+        SleepMillis(1);
+      m_queue.Put(CreatePacket(1024, DVD_MSEC_TO_TIME(i)));
+    }
+  }
+
+private:
+  CDVDMessageQueue& m_queue;
+  unsigned int m_count;
+};
+
+class DelayedProducer : public IRunnable
+{
+public:
+  explicit DelayedProducer(CDVDMessageQueue& queue) : m_queue(queue), m_putTime(0) {}
+
+  void Run() override
+  {
+    SleepMillis(20);
+    m_putTime = XbmcThreads::SystemClockMillis();
+    m_queue.Put(CreatePacket(16, 0));
+  }
+
+  CDVDMessageQueue& m_queue;
+  std::atomic<unsigned int> m_putTime;
+};
+}
+
+class TestDVDMessageQueue : public testing::Test
+{
+protected:
+  TestDVDMessageQueue() : m_queue("test")
+  {
+    m_queue.SetMaxDataSize(1024 * 1024);
+    m_queue.SetMaxTimeSize(8.0);
+    m_queue.Init();
+  }
+
+  ~TestDVDMessageQueue() override
+  {
+    m_queue.End();
+  }
+
+  CDVDMessageQueue m_queue;
+};
+
+TEST_F(TestDVDMessageQueue, Ordering)
+{
+  m_queue.Put(CreatePacket(10, DVD_MSEC_TO_TIME(0)));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC));
+  m_queue.Put(CreatePacket(20, DVD_MSEC_TO_TIME(40)));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_FLUSH), 1);
+
+  CDVDMsg* msg;
+  int priority = 0;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0, priority));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_FLUSH));
+  EXPECT_EQ(1, priority);
+  msg->Release();
+
+  priority = 0;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0, priority));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(10, static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->iSize);
+  msg->Release();
+
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  msg->Release();
+
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  EXPECT_EQ(20, static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->iSize);
+  msg->Release();
+
+  EXPECT_EQ(MSGQ_TIMEOUT, m_queue.Get(&msg, 0));
+}
+
+TEST_F(TestDVDMessageQueue, LevelAccounting)
+{
+  for (int i = 0; i < 5; i++)
+    m_queue.Put(CreatePacket(100, DVD_SEC_TO_TIME(i)));
+
+  EXPECT_EQ(500, m_queue.GetDataSize());
+  EXPECT_EQ(4, m_queue.GetTimeSize());
+  EXPECT_EQ(50, m_queue.GetLevel());
+  EXPECT_EQ(5u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  m_queue.Flush();
+  EXPECT_EQ(0, m_queue.GetDataSize());
+  EXPECT_EQ(0, m_queue.GetLevel());
+  EXPECT_EQ(0u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+}
+
+TEST_F(TestDVDMessageQueue, PacketThroughput)
+{
+  static const unsigned int packetCount = 100000;
+
+  PacketProducer producer(m_queue, packetCount);
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  thread producerThread(producer);
+
+  unsigned int received = 0;
+  CDVDMsg* msg;
+  while (received < packetCount && m_queue.Get(&msg, 1000) == MSGQ_OK)
+  {
+    msg->Release();
+    received++;
+  }
+  producerThread.join();
+  unsigned int elapsed = std::max(1u, XbmcThreads::SystemClockMillis() - start);
+
+  EXPECT_EQ(packetCount, received);
+  RecordProperty("PacketsPerSecond", static_cast<int>(packetCount * 1000ull / elapsed));
+}
+
+TEST_F(TestDVDMessageQueue, WakeupLatency)
+{
+  DelayedProducer producer(m_queue);
+  thread producerThread(producer);
+
+  CDVDMsg* msg;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 5000));
+  unsigned int latency = XbmcThreads::SystemClockMillis() - producer.m_putTime;
+  msg->Release();
+  producerThread.join();
+
+  EXPECT_LT(latency, 100u);
+  RecordProperty("WakeupLatencyMs", static_cast<int>(latency));
+}
@@ -0,0 +1,107 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+TEST(TestDemuxPacketPool, ReusesBuffers)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(100 * 1024);
+  ASSERT_NE(nullptr, packet);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  DemuxPacketPoolStats before = CDVDDemuxUtils::GetPoolStats();
+  EXPECT_GT(before.bytesPooled, 0u);
+
+  packet = CDVDDemuxUtils::AllocateDemuxPacket(90 * 1024);
+  ASSERT_NE(nullptr, packet);
+  DemuxPacketPoolStats after = CDVDDemuxUtils::GetPoolStats();
+  EXPECT_EQ(before.poolHits + 1, after.poolHits);
+  EXPECT_EQ(before.poolMisses, after.poolMisses);
+
+  // padding has to be cleared on reused buffers as well
+  for (int i = 0; i < AV_INPUT_BUFFER_PADDING_SIZE; i++)
+    EXPECT_EQ(0, packet->pData[90 * 1024 + i]);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
+
+TEST(TestDemuxPacketPool, ReferencesLargePackets)
+{
+  AVPacket src;
+  av_init_packet(&src);
+  ASSERT_EQ(0, av_new_packet(&src, 64 * 1024));
+  memset(src.data, 0x55, src.size);
+
+  DemuxPacketPoolStats before = CDVDDemuxUtils::GetPoolStats();
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(src);
+  ASSERT_NE(nullptr, packet);
+  EXPECT_EQ(src.size, packet->iSize);
+  EXPECT_EQ(src.data, packet->pData);
+  av_packet_unref(&src);
+
+  // the packet keeps the payload alive
+  EXPECT_EQ(0x55, packet->pData[packet->iSize - 1]);
+  DemuxPacketPoolStats after = CDVDDemuxUtils::GetPoolStats();
+  EXPECT_EQ(before.bytesReferenced + 64 * 1024, after.bytesReferenced);
+  EXPECT_EQ(before.bytesCopied, after.bytesCopied);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
+
+TEST(TestDemuxPacketPool, SharedPayload)
+{
+  // e.g. the attached picture, handed out again after every seek
+  AVPacket src;
+  av_init_packet(&src);
+  ASSERT_EQ(0, av_new_packet(&src, 64 * 1024));
+  memset(src.data, 0x33, src.size);
+
+  DemuxPacket* first = CDVDDemuxUtils::AllocateDemuxPacket(src);
+  DemuxPacket* second = CDVDDemuxUtils::AllocateDemuxPacket(src);
+  av_packet_unref(&src);
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  EXPECT_EQ(first->pData, second->pData);
+
+  CDVDDemuxUtils::FreeDemuxPacket(first);
+  EXPECT_EQ(0x33, second->pData[second->iSize - 1]);
+  CDVDDemuxUtils::FreeDemuxPacket(second);
+}
+
+TEST(TestDemuxPacketPool, CopiesSmallPackets)
+{
+  AVPacket src;
+  av_init_packet(&src);
+  ASSERT_EQ(0, av_new_packet(&src, 512));
+  memset(src.data, 0xaa, src.size);
+
+  DemuxPacketPoolStats before = CDVDDemuxUtils::GetPoolStats();
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(src);
+  ASSERT_NE(nullptr, packet);
+  EXPECT_NE(src.data, packet->pData);
+  EXPECT_EQ(0, memcmp(src.data, packet->pData, src.size));
+  av_packet_unref(&src);
+
+  DemuxPacketPoolStats after = CDVDDemuxUtils::GetPoolStats();
+  EXPECT_EQ(before.bytesCopied + 512, after.bytesCopied);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
@@ -0,0 +1,136 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/GopIndex.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+double Sec(double seconds)
+{
+  return DVD_SEC_TO_TIME(seconds);
+}
+}
+
+TEST(TestGopIndex, Empty)
+{
+  CGopIndex index;
+  double start, end;
+  EXPECT_TRUE(index.IsEmpty());
+  EXPECT_EQ(DVD_NOPTS_VALUE, index.GetKeyframe(Sec(1)));
+  EXPECT_EQ(DVD_NOPTS_VALUE, index.GetNextKeyframe(Sec(1)));
+  EXPECT_EQ(DVD_NOPTS_VALUE, index.GetNearestKeyframe(Sec(1), Sec(10)));
+  EXPECT_FALSE(index.GetGop(Sec(1), start, end));
+}
+
+TEST(TestGopIndex, Lookup)
+{
+  CGopIndex index;
+  for (int i = 0; i < 10; i++)
+    index.Add(Sec(i * 2), true);
+
+  EXPECT_EQ(10u, index.Size());
+  EXPECT_EQ(Sec(4), index.GetKeyframe(Sec(5)));
+  EXPECT_EQ(Sec(4), index.GetKeyframe(Sec(4)));
+  EXPECT_EQ(Sec(6), index.GetNextKeyframe(Sec(5)));
+  EXPECT_EQ(Sec(6), index.GetNextKeyframe(Sec(6)));
+  EXPECT_EQ(DVD_NOPTS_VALUE, index.GetNextKeyframe(Sec(19)));
+  EXPECT_EQ(Sec(6), index.GetNearestKeyframe(Sec(5.5), Sec(10)));
+  EXPECT_EQ(Sec(4), index.GetNearestKeyframe(Sec(4.5), Sec(10)));
+  EXPECT_EQ(DVD_NOPTS_VALUE, index.GetNearestKeyframe(Sec(30), Sec(5)));
+
+  double start, end;
+  EXPECT_TRUE(index.GetGop(Sec(5), start, end));
+  EXPECT_EQ(Sec(4), start);
+  EXPECT_EQ(Sec(6), end);
+  EXPECT_FALSE(index.GetGop(Sec(19), start, end));
+}
+
+TEST(TestGopIndex, Gaps)
+{
+  CGopIndex index;
+  double start, end;
+
+  index.Add(Sec(0), true);
+  index.Add(Sec(2), true);
+  // seek
+  index.Add(Sec(10), false);
+  index.Add(Sec(12), true);
+
+  EXPECT_TRUE(index.GetGop(Sec(1), start, end));
+  EXPECT_FALSE(index.GetGop(Sec(5), start, end));
+  EXPECT_TRUE(index.GetGop(Sec(11), start, end));
+
+  // seek back and play through the gap
+  index.Add(Sec(2), false);
+  index.Add(Sec(4), true);
+  EXPECT_TRUE(index.GetGop(Sec(3), start, end));
+  EXPECT_FALSE(index.GetGop(Sec(5), start, end));
+  index.Add(Sec(10), true);
+  EXPECT_TRUE(index.GetGop(Sec(5), start, end));
+  EXPECT_EQ(Sec(4), start);
+  EXPECT_EQ(Sec(10), end);
+  EXPECT_EQ(5u, index.Size());
+
+  // a keyframe within a known gop means the timestamps were off
+  index.Add(Sec(7), false);
+  EXPECT_FALSE(index.GetGop(Sec(8), start, end));
+  EXPECT_FALSE(index.GetGop(Sec(5), start, end));
+}
+
+TEST(TestGopIndex, Duplicates)
+{
+  CGopIndex index;
+  index.Add(Sec(1), true);
+  index.Add(Sec(1) + 10, true);
+  index.Add(DVD_NOPTS_VALUE, true);
+  EXPECT_EQ(1u, index.Size());
+
+  index.Clear();
+  EXPECT_TRUE(index.IsEmpty());
+}
+
+// cost of the index itself only, seek to first frame latency depends on the
+// demuxer and decoders and is not measured here
+TEST(TestGopIndex, DISABLED_Benchmark)
+{
+  const int keyframes = 10000;
+  const int lookups = 1000000;
+
+  auto begin = std::chrono::steady_clock::now();
+  CGopIndex index;
+  for (int i = 0; i < keyframes; i++)
+    index.Add(Sec(i * 2), true);
+  auto built = std::chrono::steady_clock::now();
+
+  double sum = 0;
+  for (int i = 0; i < lookups; i++)
+    sum += index.GetKeyframe(Sec((i * 7919LL) % (keyframes * 2)));
+  auto done = std::chrono::steady_clock::now();
+
+  EXPECT_GT(sum, 0);
+  std::cout << "index build: " << std::chrono::duration<double, std::micro>(built - begin).count() / keyframes << " us/keyframe, "
+            << "index lookup: " << std::chrono::duration<double, std::nano>(done - built).count() / lookups << " ns" << std::endl;
+}
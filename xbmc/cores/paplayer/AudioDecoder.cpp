@@ -26,6 +26,8 @@
 #include "ServiceBroker.h"
 #include "music/tags/MusicInfoTag.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
 #include "utils/log.h"
 #include <math.h>
 
@@ -45,6 +47,7 @@ CAudioDecoder::CAudioDecoder()
   memset(&m_inputBuffer, 0, INPUT_SAMPLES * sizeof(float));
 
   m_rawBufferSize = 0;
+  m_pcmQueueSize = 0;
 }
 
 CAudioDecoder::~CAudioDecoder()
@@ -66,26 +69,40 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
+unsigned int CAudioDecoder::GetFileCache(const CFileItem &file)
+{
+  unsigned int filecache = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_CACHEAUDIO_INTERNET);
+  if ( file.IsHD() )
+    filecache = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_CACHE_HARDDISK);
+  else if ( file.IsOnDVD() )
+    filecache = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_CACHEAUDIO_DVDROM);
+  else if ( file.IsOnLAN() )
+    filecache = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_CACHEAUDIO_LAN);
+  return filecache;
+}
+
 bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
 {
   Destroy();
 
+  // create our codec
+  ICodec *codec = CodecFactory::CreateCodecDemux(file, GetFileCache(file) * 1024);
+  return Create(file, seekOffset, codec);
+}
+
+bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset, ICodec *codec)
+{
+  Destroy();
+
   CSingleLock lock(m_critSection);
 
   // reset our playback timing variables
   m_eof = false;
 
   // get correct cache size
-  unsigned int filecache = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_CACHEAUDIO_INTERNET);
-  if ( file.IsHD() )
-    filecache = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_CACHE_HARDDISK);
-  else if ( file.IsOnDVD() )
-    filecache = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_CACHEAUDIO_DVDROM);
-  else if ( file.IsOnLAN() )
-    filecache = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_CACHEAUDIO_LAN);
+  unsigned int filecache = GetFileCache(file);
 
-  // create our codec
-  m_codec=CodecFactory::CreateCodecDemux(file, filecache * 1024);
+  m_codec = codec;
 
   if (!m_codec || !m_codec->Init(file, filecache * 1024))
   {
@@ -102,8 +119,14 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_format.m_sampleRate);
+  /* allocate the pcmBuffer for the lookahead, but at least for the queue time */
+  unsigned int queueSize = PCM_QUEUE_TIME * blockSize * m_codec->m_format.m_sampleRate;
+  unsigned int bufferSize = std::min<uint64_t>((uint64_t)PCM_LOOKAHEAD_TIME * blockSize * m_codec->m_format.m_sampleRate,
+                                               PCM_LOOKAHEAD_SIZE);
+  // whole frames only, this way the codec can decode in place up to the end of the buffer
+  bufferSize -= bufferSize % blockSize;
+  m_pcmBuffer.Create(std::max(queueSize, bufferSize));
+  m_pcmQueueSize = queueSize * 0.9;
 
   if (file.HasMusicInfoTag())
   {
@@ -224,6 +247,22 @@ void *CAudioDecoder::GetData(unsigned int samples)
   return NULL;
 }
 
+void *CAudioDecoder::PeekData(unsigned int &samples)
+{
+  unsigned int bytesPerSample = m_codec->m_bitsPerSample >> 3;
+  unsigned int size;
+  char *data = m_pcmBuffer.getReadBuffer(size);
+  samples = std::min(samples, size / bytesPerSample);
+  return data;
+}
+
+void CAudioDecoder::SkipData(unsigned int samples)
+{
+  m_pcmBuffer.SkipBytes(samples * (m_codec->m_bitsPerSample >> 3));
+  if (m_status == STATUS_ENDING && m_pcmBuffer.getMaxReadSize() == 0)
+    m_status = STATUS_ENDED;
+}
+
 uint8_t *CAudioDecoder::GetRawData(int &size)
 {
   if (m_status == STATUS_ENDING)
@@ -258,16 +297,30 @@ int CAudioDecoder::ReadSamples(int numsamples)
     numsamples -= (numsamples % GetFormat().m_channelLayout.Count());  // make sure it's divisible by our number of channels
     if (numsamples)
     {
+      // let the codec decode right into our buffer, only if the free space
+      // wraps in the middle of a frame we have to go through the input buffer
+      unsigned int frameSize = (m_codec->m_bitsPerSample >> 3) * GetFormat().m_channelLayout.Count();
+      unsigned int space;
+      uint8_t *buffer = (uint8_t*)m_pcmBuffer.getWriteBuffer(space);
+      bool inPlace = space >= frameSize;
+      if (inPlace)
+        numsamples = std::min<int>(numsamples, space / frameSize * GetFormat().m_channelLayout.Count());
+      else
+        buffer = m_pcmInputBuffer;
+
       int readSize = 0;
-      int result = m_codec->ReadPCM(m_pcmInputBuffer, numsamples * (m_codec->m_bitsPerSample >> 3), &readSize);
+      int result = m_codec->ReadPCM(buffer, numsamples * (m_codec->m_bitsPerSample >> 3), &readSize);
 
       if (result != READ_ERROR && readSize)
       {
         // move it into our buffer
-        m_pcmBuffer.WriteData((char *)m_pcmInputBuffer, readSize);
+        if (inPlace)
+          m_pcmBuffer.CommitWrite(readSize);
+        else
+          m_pcmBuffer.WriteData((char *)m_pcmInputBuffer, readSize);
 
         // update status
-        if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_pcmBuffer.getSize() * 0.9)
+        if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_pcmQueueSize)
         {
           CLog::Log(LOGINFO, "AudioDecoder: File is queued");
           m_status = STATUS_QUEUED;
@@ -330,6 +383,42 @@ int CAudioDecoder::ReadSamples(int numsamples)
   return RET_SLEEP; // nothing to do
 }
 
+unsigned int CAudioDecoder::Prefetch(unsigned int time, unsigned int timeout)
+{
+  XbmcThreads::EndTime timer(timeout);
+  while (GetCacheTime() < time && !timer.IsTimePast())
+  {
+    int status = GetStatus();
+    if (status == STATUS_NO_FILE || status == STATUS_ENDING || status == STATUS_ENDED)
+      break;
+
+    int ret = ReadSamples(PACKET_SIZE);
+    if (ret == RET_ERROR)
+      break;
+    if (ret == RET_SLEEP)
+    {
+      // buffer is full or the codec has nothing for us right now
+      if (m_codec->m_format.m_dataFormat == AE_FMT_RAW ||
+          m_pcmBuffer.getMaxWriteSize() < INPUT_SIZE)
+        break;
+      XbmcThreads::ThreadSleep(1);
+    }
+  }
+  return GetCacheTime();
+}
+
+unsigned int CAudioDecoder::GetCacheTime()
+{
+  if (!m_codec || m_codec->m_format.m_dataFormat == AE_FMT_RAW)
+    return 0;
+
+  unsigned int frameSize = (m_codec->m_bitsPerSample >> 3) * m_codec->m_format.m_channelLayout.Count();
+  if (!frameSize || !m_codec->m_format.m_sampleRate)
+    return 0;
+
+  return (uint64_t)m_pcmBuffer.getMaxReadSize() * 1000 / frameSize / m_codec->m_format.m_sampleRate;
+}
+
 float CAudioDecoder::GetReplayGain(float &peakVal)
 {
 #define REPLAY_GAIN_DEFAULT_LEVEL 89.0f
@@ -37,6 +37,10 @@ class CFileItem;
 #define OUTPUT_SAMPLES PACKET_SIZE      // max number of output samples
 #define INPUT_SAMPLES  PACKET_SIZE      // number of input samples (distributed over channels)
 
+#define PCM_QUEUE_TIME      2                 // seconds of decoded audio required before a stream is queued
+#define PCM_LOOKAHEAD_TIME  10                // seconds of decoded audio we are allowed to decode ahead
+#define PCM_LOOKAHEAD_SIZE  16 * 1024 * 1024  // upper bound of the lookahead buffer in bytes
+
 #define STATUS_NO_FILE  0
 #define STATUS_QUEUING  1
 #define STATUS_QUEUED   2
@@ -56,9 +60,15 @@ public:
   ~CAudioDecoder();
 
   bool Create(const CFileItem &file, int64_t seekOffset);
+  // same as above but on top of a codec created by the caller, takes ownership of the codec
+  bool Create(const CFileItem &file, int64_t seekOffset, ICodec *codec);
   void Destroy();
 
   int ReadSamples(int numsamples);
+  // decode ahead until time ms of audio are buffered, the buffer is full, the
+  // stream ended or timeout ms have passed. returns the buffered time in ms
+  unsigned int Prefetch(unsigned int time, unsigned int timeout);
+  unsigned int GetCacheTime();
 
   bool CanSeek() { if (m_codec) return m_codec->CanSeek(); else return false; };
   int64_t Seek(int64_t time);
@@ -73,13 +83,20 @@ public:
   // Data management
   unsigned int GetDataSize(bool checkPktSize);
   void *GetData(unsigned int samples);
+  // zero copy variant of GetData. returns the decoded data in place and reduces
+  // samples to what is contiguous, the data has to be released with SkipData
+  void *PeekData(unsigned int &samples);
+  void SkipData(unsigned int samples);
   uint8_t* GetRawData(int &size);
   ICodec *GetCodec() const { return m_codec; }
   float GetReplayGain(float &peakVal);
 
 private:
+  static unsigned int GetFileCache(const CFileItem &file);
+
   // pcm buffer
   CRingBuffer m_pcmBuffer;
+  unsigned int m_pcmQueueSize;
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
   float m_outputBuffer[OUTPUT_SAMPLES];
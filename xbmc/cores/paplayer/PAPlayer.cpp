@@ -36,6 +36,7 @@
 #include "Util.h"
 
 #define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
+#define TIME_TO_PREFETCH_NEXT  10000 /* how much of the next song we try to decode ahead */
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
 
@@ -370,6 +371,19 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
     CThread::Sleep(1);
   }
 
+  /* decode ahead while the current song is still playing, a slow source
+   * would otherwise have to deliver the start of this song right at the
+   * transition. leave some of the remaining time for preparing the stream.
+   * only for a queued next song (fadeIn), a user skip via OpenFile wants the
+   * new song to start right away */
+  if (fadeIn && m_currentStream)
+  {
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    unsigned int prefetched = si->m_decoder.Prefetch(TIME_TO_PREFETCH_NEXT, TIME_TO_CACHE_NEXT_FILE / 2);
+    CLog::Log(LOGDEBUG, "PAPlayer::QueueNextFileEx - Prefetched %u ms of audio in %u ms",
+              prefetched, XbmcThreads::SystemClockMillis() - start);
+  }
+
   // set m_upcomingCrossfadeMS depending on type of file and user settings
   UpdateCrossfadeTime(si->m_fileItem);
 
@@ -848,18 +862,33 @@ bool PAPlayer::QueueData(StreamInfo *si)
       return true;
 
     // we want complete frames
-    samples -= samples % si->m_audioFormat.m_channelLayout.Count();
-
-    uint8_t* data = (uint8_t*)si->m_decoder.GetData(samples);
-    if (!data)
+    unsigned int channels = si->m_audioFormat.m_channelLayout.Count();
+    samples -= samples % channels;
+
+    // pass the data from the decoder's buffer to the stream without a copy,
+    // if the buffer wraps in the middle of a frame use a copy instead
+    unsigned int contiguous = samples;
+    uint8_t* data = (uint8_t*)si->m_decoder.PeekData(contiguous);
+    contiguous -= contiguous % channels;
+    if (contiguous)
     {
-      CLog::Log(LOGERROR, "PAPlayer::QueueData - Failed to get data from the decoder");
-      return false;
+      unsigned int added = si->m_stream->AddData(&data, 0, contiguous / channels, 0);
+      si->m_decoder.SkipData(added * channels);
+      si->m_framesSent += added;
     }
+    else if (samples)
+    {
+      data = (uint8_t*)si->m_decoder.GetData(samples);
+      if (!data)
+      {
+        CLog::Log(LOGERROR, "PAPlayer::QueueData - Failed to get data from the decoder");
+        return false;
+      }
 
-    unsigned int frames = samples/si->m_audioFormat.m_channelLayout.Count();
-    unsigned int added = si->m_stream->AddData(&data, 0, frames, 0);
-    si->m_framesSent += added;
+      unsigned int frames = samples / channels;
+      unsigned int added = si->m_stream->AddData(&data, 0, frames, 0);
+      si->m_framesSent += added;
+    }
   }
   else
   {
@@ -0,0 +1,197 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/paplayer/AudioDecoder.h"
+#include "FileItem.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <thread>
+
+#define SLOW_RATE     8000  // mono 16 bit
+#define SLOW_CHUNK    800   // samples returned per read, 100 ms
+#define SLOW_DELAY    10    // ms a read takes, the source delivers 10 times realtime
+#define TRACK_LENGTH  4000  // ms
+
+namespace
+{
+// a codec reading from a share which needs SLOW_DELAY ms for every chunk.
+// samples count up so that the order of the output can be verified
+class CSlowCodec : public ICodec
+{
+public:
+  bool Init(const CFileItem &file, unsigned int filecache) override
+  {
+    m_format.m_dataFormat = AE_FMT_S16NE;
+    m_format.m_sampleRate = SLOW_RATE;
+    m_format.m_channelLayout = AE_CH_LAYOUT_1_0;
+    m_bitsPerSample = 16;
+    m_TotalTime = TRACK_LENGTH;
+    return true;
+  }
+  bool Seek(int64_t iSeekTime) override { return false; }
+  bool CanInit() override { return true; }
+  int ReadPCM(unsigned char *pBuffer, int size, int *actualsize) override
+  {
+    XbmcThreads::ThreadSleep(SLOW_DELAY);
+    int total = TRACK_LENGTH * SLOW_RATE / 1000;
+    int samples = std::min(std::min(size / 2, SLOW_CHUNK), total - m_position);
+    int16_t *out = reinterpret_cast<int16_t*>(pBuffer);
+    for (int i = 0; i < samples; i++)
+      out[i] = static_cast<int16_t>(m_position++);
+    m_reads++;
+    *actualsize = samples * 2;
+    return m_position == total ? READ_EOF : READ_SUCCESS;
+  }
+
+  int m_position = 0;
+  int m_reads = 0;
+};
+
+// takes samples of a decoder like PAPlayer::QueueData, returns the number
+// of samples taken. fails if the decoder delivered samples out of order
+int TakeSamples(CAudioDecoder &decoder, int samples, int &expected)
+{
+  int taken = 0;
+  while (taken < samples)
+  {
+    unsigned int size = std::min<unsigned int>(decoder.GetDataSize(false), samples - taken);
+    if (!size)
+      break;
+    int16_t *data = static_cast<int16_t*>(decoder.GetData(size));
+    if (!data)
+      break;
+    for (unsigned int i = 0; i < size; i++)
+      EXPECT_EQ(static_cast<int16_t>(expected++), data[i]);
+    taken += size;
+  }
+  return taken;
+}
+}
+
+TEST(TestAudioDecoder, Prefetch)
+{
+  CFileItem item("/music/slow.pcm", false);
+  CSlowCodec *codec = new CSlowCodec();
+  CAudioDecoder decoder;
+  ASSERT_TRUE(decoder.Create(item, 0, codec));
+  decoder.Start();
+
+  // bounded by the timeout
+  unsigned int cached = decoder.Prefetch(TRACK_LENGTH, 5 * SLOW_DELAY);
+  EXPECT_LT(cached, TRACK_LENGTH / 2u);
+
+  // the whole track fits into the lookahead buffer
+  cached = decoder.Prefetch(TRACK_LENGTH, 10000);
+  EXPECT_EQ(TRACK_LENGTH, static_cast<int>(cached));
+  EXPECT_EQ(STATUS_ENDING, decoder.GetStatus());
+
+  int reads = codec->m_reads;
+  int expected = 0;
+  EXPECT_EQ(TRACK_LENGTH * SLOW_RATE / 1000, TakeSamples(decoder, TRACK_LENGTH * SLOW_RATE, expected));
+  EXPECT_EQ(reads, codec->m_reads);
+  EXPECT_EQ(0u, decoder.GetCacheTime());
+}
+
+TEST(TestAudioDecoder, InPlace)
+{
+  CFileItem item("/music/slow.pcm", false);
+  CAudioDecoder decoder;
+  ASSERT_TRUE(decoder.Create(item, 0, new CSlowCodec()));
+  decoder.Start();
+  ASSERT_EQ(TRACK_LENGTH, static_cast<int>(decoder.Prefetch(TRACK_LENGTH, 10000)));
+
+  int expected = 0;
+  while (decoder.GetStatus() != STATUS_ENDED)
+  {
+    unsigned int samples = SLOW_CHUNK / 2;
+    int16_t *data = static_cast<int16_t*>(decoder.PeekData(samples));
+    ASSERT_GT(samples, 0u);
+    for (unsigned int i = 0; i < samples; i++)
+      EXPECT_EQ(static_cast<int16_t>(expected++), data[i]);
+    decoder.SkipData(samples);
+  }
+  EXPECT_EQ(TRACK_LENGTH * SLOW_RATE / 1000, expected);
+}
+
+TEST(TestAudioDecoder, GaplessPlaylist)
+{
+  // play two songs from the slow share back to back. while the first one
+  // plays, the second one is opened and decoded ahead on another thread like
+  // PAPlayer::QueueNextFileEx does. playback runs at 10 times realtime so
+  // the share can't keep up with it, the transition has to be covered by
+  // the prefetched audio alone
+  CFileItem first("/music/first.pcm", false);
+  CFileItem second("/music/second.pcm", false);
+  CSlowCodec *firstCodec = new CSlowCodec();
+  CSlowCodec *secondCodec = new CSlowCodec();
+  CAudioDecoder current, next;
+
+  ASSERT_TRUE(current.Create(first, 0, firstCodec));
+  current.Start();
+  ASSERT_EQ(TRACK_LENGTH, static_cast<int>(current.Prefetch(TRACK_LENGTH, 10000)));
+
+  const unsigned int lookahead = TRACK_LENGTH / 2;
+  unsigned int prefetched = 0;
+  std::thread queue([&]() {
+    if (!next.Create(second, 0, secondCodec))
+      return;
+    next.Start();
+    prefetched = next.Prefetch(lookahead, 10000);
+  });
+
+  int expected = 0;
+  int played = 0;
+  while (played < TRACK_LENGTH * SLOW_RATE / 1000)
+  {
+    // no ASSERT before the join, leaving with a joinable thread terminates
+    int taken = TakeSamples(current, SLOW_CHUNK, expected);
+    EXPECT_GT(taken, 0);
+    if (taken <= 0)
+      break;
+    played += taken;
+    XbmcThreads::ThreadSleep(SLOW_DELAY);
+  }
+  queue.join();
+  ASSERT_GE(played, TRACK_LENGTH * SLOW_RATE / 1000);
+
+  // the transition, the next song must not wait for the share
+  EXPECT_GE(prefetched, lookahead);
+  int reads = secondCodec->m_reads;
+  expected = 0;
+  played = 0;
+  while (played < static_cast<int>(lookahead * SLOW_RATE / 1000))
+  {
+    int taken = TakeSamples(next, SLOW_CHUNK, expected);
+    ASSERT_GT(taken, 0);
+    played += taken;
+  }
+  EXPECT_EQ(reads, secondCodec->m_reads);
+
+  // and the rest of the song follows once we decode again
+  while (next.GetStatus() != STATUS_ENDED && next.ReadSamples(PACKET_SIZE) != RET_ERROR)
+  {
+    played += TakeSamples(next, SLOW_CHUNK, expected);
+  }
+  EXPECT_EQ(TRACK_LENGTH * SLOW_RATE / 1000, played);
+}
@@ -141,6 +141,7 @@ public:
 protected:
   friend class CGUIDialogSmartPlaylistEditor;
   friend class CGUIDialogMediaFilter;
+  friend class CSmartPlaylistIndex;
 
   Combination m_type;
   CDatabaseQueryRuleCombinations m_combinations;
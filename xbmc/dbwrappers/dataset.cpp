@@ -89,7 +89,7 @@ Dataset::Dataset():
 {
 
   db = NULL;
-  haveError = active = false;
+  haveError = active = streaming = false;
   frecno = 0;
   fbof = feof = true;
   autocommit = true;
@@ -107,7 +107,7 @@ Dataset::Dataset(Database *newDb):
 {
 
   db = newDb;
-  haveError = active = false;
+  haveError = active = streaming = false;
   frecno = 0;
   fbof = feof = true;
   autocommit = true;
@@ -204,6 +204,7 @@ void Dataset::parse_sql(std::string &sql) {
 
 void Dataset::close(void) {
   haveError  = false;
+  streaming = false;
   frecno = 0;
   fbof = feof = true;
   active = false;
@@ -380,7 +381,7 @@ const field_value Dataset::get_field_value(const char *f_name) {
       for (unsigned int i=0; i < fields_object->size(); i++) 
         if (str_compare((*fields_object)[i].props.name.c_str(), f_name) == 0 || (name && str_compare((*fields_object)[i].props.name.c_str(), name) == 0)) {
           fieldIndexMap_Entries[fieldIndexMapID].fieldIndex = i;
-          return (*fields_object)[i].val;
+          return get_field_value(static_cast<int>(i));
         }
     }
     throw DbErrors("Field not found: %s",f_name);
@@ -403,6 +404,13 @@ const field_value Dataset::get_field_value(int index) {
       if (index < 0 || index >= field_count())
         throw DbErrors("Field index not found: %d",index);
 
+      // values of a streamed row are not copied into the fields
+      if (streaming)
+      {
+        const sql_record *row = get_sql_record();
+        if (row)
+          return row->at(index);
+      }
       return (*fields_object)[index].val;
     }
   }
@@ -466,6 +474,44 @@ bool Dataset::locate(){
   return false;
 }
 
+std::string Dataset::bind_sql(const std::string &sql, const BindValues &params) {
+  std::string qry;
+  qry.reserve(sql.size() + params.size() * 16);
+  size_t param = 0;
+  bool quoted = false;
+  for (char c : sql) {
+    if (c == '\'')
+      quoted = !quoted;
+    if (c != '?' || quoted) {
+      qry += c;
+      continue;
+    }
+    if (param >= params.size())
+      throw DbErrors("Too few bound values for query: %s", sql.c_str());
+
+    const field_value &v = params[param++];
+    if (v.get_isNull())
+      qry += "NULL";
+    else if (v.get_fType() == ft_String || v.get_fType() == ft_Char)
+      qry += db->prepare("'%s'", v.get_asString().c_str());
+    else if (v.get_fType() == ft_Boolean)
+      qry += v.get_asBool() ? "1" : "0";
+    else
+      qry += v.get_asString();
+  }
+  if (param != params.size())
+    throw DbErrors("Too many bound values for query: %s", sql.c_str());
+  return qry;
+}
+
+bool Dataset::query(const std::string &sql, const BindValues &params) {
+  return query(bind_sql(sql, params));
+}
+
+int Dataset::exec(const std::string &sql, const BindValues &params) {
+  return exec(bind_sql(sql, params));
+}
+
 bool Dataset::locate(const ParamList &params) {
   plist = params;
   return locate();
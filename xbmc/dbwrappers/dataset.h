@@ -183,6 +183,7 @@ enum sqlType {sqlSelect,sqlUpdate,sqlInsert,sqlDelete,sqlExec};
 
 typedef std::list<std::string> StringList;
 typedef std::map<std::string,field_value> ParamList;
+typedef std::vector<field_value> BindValues;
 
 
 class Dataset  {
@@ -205,6 +206,7 @@ protected:
 
   bool active;			// Is Query Opened?
   bool haveError;
+  bool streaming;		// forward-only cursor, only the current row is held
   int frecno; 			// number of current row bei bewegung
   std::string sql;
 
@@ -263,6 +265,10 @@ protected:
 /* Returns old field value (for :OLD) */
   virtual const field_value f_old(const char *f);
 
+/* Substitutes each ? placeholder in sql with the escaped literal of the
+   matching value. Used by backends without native parameter binding. */
+  std::string bind_sql(const std::string &sql, const BindValues &params);
+
 public:
 
  virtual int str_compare(const char * s1, const char * s2);
@@ -308,6 +314,25 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+
+  /*! \brief Run a select with ? placeholders bound to the given values.
+   Backends that support it keep the compiled statement around so repeated
+   lookups skip the SQL parser. The default implementation substitutes
+   escaped literals and runs query(sql).
+   */
+  virtual bool query(const std::string &sql, const BindValues &params);
+  /*! \brief Execute a statement with ? placeholders bound to the given values.
+   \sa query(const std::string &, const BindValues &)
+   */
+  virtual int exec(const std::string &sql, const BindValues &params);
+
+  /*! \brief Run a select as a forward-only cursor.
+   Rows are fetched one at a time by next() and only the current row is kept
+   in memory, so large listings don't have to be materialized first. The row
+   count is not known up front and seek(), prev() and last() are not
+   available. Backends without cursor support fall back to query(sql).
+   */
+  virtual bool query_stream(const std::string &sql) { return query(sql); }
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
@@ -150,6 +150,9 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+/* bound values are substituted client side, see Dataset::bind_sql */
+  using Dataset::exec;
+  using Dataset::query;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
@@ -82,6 +82,8 @@ static int busy_callback(void*, int busyCount)
   return 1;
 }
 
+static const size_t MAX_CACHED_STATEMENTS = 128;
+
 //************* SqliteDatabase implementation ***************
 
 SqliteDatabase::SqliteDatabase() {
@@ -256,10 +258,35 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  finalize_statements();
   sqlite3_close(conn);
   active = false;
 }
 
+sqlite3_stmt *SqliteDatabase::get_statement(const std::string &sql) {
+  auto it = statements.find(sql);
+  if (it != statements.end())
+    return it->second;
+
+  // callers only bind a limited set of lookups, so simply start over if
+  // something keeps generating new statement texts
+  if (statements.size() >= MAX_CACHED_STATEMENTS)
+    finalize_statements();
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+    throw DbErrors(getErrorMsg());
+
+  statements.insert(std::make_pair(sql, stmt));
+  return stmt;
+}
+
+void SqliteDatabase::finalize_statements() {
+  for (auto &it : statements)
+    sqlite3_finalize(it.second);
+  statements.clear();
+}
+
 int SqliteDatabase::create() {
   return connect(true);
 }
@@ -450,6 +477,7 @@ SqliteDataset::SqliteDataset():Dataset() {
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  stream_stmt = NULL;
 }
 
 
@@ -458,9 +486,11 @@ SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  stream_stmt = NULL;
 }
 
  SqliteDataset::~SqliteDataset(){
+   if (stream_stmt) sqlite3_finalize(stream_stmt);
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -543,6 +573,10 @@ void SqliteDataset::fill_fields() {
       (*fields_object)[i].props = result.record_header[i];
   }
 
+  // streamed values are read straight from the current row
+  if (streaming)
+    return;
+
   //Filling result
   if (result.records.size() != 0)
   {
@@ -630,6 +664,77 @@ int SqliteDataset::exec() {
   return exec(sql);
 }
 
+int SqliteDataset::exec(const std::string &sql, const BindValues &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->get_statement(sql);
+  try
+  {
+    bind_params(stmt, params);
+  }
+  catch (...)
+  {
+    sqlite3_clear_bindings(stmt);
+    throw;
+  }
+
+  int res;
+  while ((res = sqlite3_step(stmt)) == SQLITE_ROW)
+    ;
+
+  if (res == SQLITE_DONE)
+    res = sqlite3_reset(stmt);
+  else
+    sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  if (db->setErr(res, sql.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+  return res;
+}
+
+void SqliteDataset::bind_params(sqlite3_stmt *stmt, const BindValues &params) {
+  if (sqlite3_bind_parameter_count(stmt) != static_cast<int>(params.size()))
+    throw DbErrors("Wrong number of bound values for query: %s", sqlite3_sql(stmt));
+
+  for (size_t i = 0; i < params.size(); i++)
+  {
+    const field_value &v = params[i];
+    const int col = static_cast<int>(i) + 1;
+    int err;
+    if (v.get_isNull())
+    {
+      err = sqlite3_bind_null(stmt, col);
+    }
+    else
+    {
+      switch (v.get_fType())
+      {
+      case ft_Boolean:
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+        err = sqlite3_bind_int(stmt, col, v.get_asInt());
+        break;
+      case ft_UInt:
+      case ft_Int64:
+        err = sqlite3_bind_int64(stmt, col, v.get_asInt64());
+        break;
+      case ft_Float:
+      case ft_Double:
+        err = sqlite3_bind_double(stmt, col, v.get_asDouble());
+        break;
+      default:
+        err = sqlite3_bind_text(stmt, col, v.get_asString().c_str(), -1, SQLITE_TRANSIENT);
+        break;
+      }
+    }
+    if (db->setErr(err, sqlite3_sql(stmt)) != SQLITE_OK)
+      throw DbErrors(db->getErrorMsg());
+  }
+}
+
 const void* SqliteDataset::getExecRes() {
   return &exec_res;
 }
@@ -649,6 +754,52 @@ bool SqliteDataset::query(const std::string &query) {
   if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
     throw DbErrors(db->getErrorMsg());
 
+  fetch_rows(stmt);
+
+  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
+  {
+    active = true;
+    ds_state = dsSelect;
+    this->first();
+    return true;
+  }
+  else
+  {
+    throw DbErrors(db->getErrorMsg());
+  }  
+}
+
+bool SqliteDataset::query(const std::string &query, const BindValues &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->get_statement(query);
+  try
+  {
+    bind_params(stmt, params);
+    fetch_rows(stmt);
+  }
+  catch (...)
+  {
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    throw;
+  }
+
+  // reset reports the error of the last step, if any
+  int err = sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  if (db->setErr(err, query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+void SqliteDataset::fetch_rows(sqlite3_stmt *stmt) {
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
@@ -658,45 +809,83 @@ bool SqliteDataset::query(const std::string &query) {
   // returned rows
   while (sqlite3_step(stmt) == SQLITE_ROW)
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
+    sql_record *res = new sql_record(numColumns);
+    read_row(stmt, *res);
+    result.records.push_back(res);
+  }
+}
+
+void SqliteDataset::read_row(sqlite3_stmt *stmt, sql_record &rec) {
+  for (unsigned int i = 0; i < rec.size(); i++)
+  {
+    field_value &v = rec[i];
+    v.set_isNull(false);
+    switch (sqlite3_column_type(stmt, i))
     {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
-      {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_NULL:
-      default:
-        v.set_asString("");
-        v.set_isNull();
-        break;
-      }
+    case SQLITE_INTEGER:
+      v.set_asInt64(sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      v.set_asDouble(sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_BLOB:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_NULL:
+    default:
+      v.set_asString("");
+      v.set_isNull();
+      break;
     }
-    result.records.push_back(res);
   }
-  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
+}
+
+bool SqliteDataset::query_stream(const std::string &query) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  if (db->setErr(sqlite3_prepare_v2(handle(), query.c_str(), -1, &stream_stmt, NULL), query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  const unsigned int numColumns = sqlite3_column_count(stream_stmt);
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = sqlite3_column_name(stream_stmt, i);
+
+  // the single record is reused for every row
+  result.records.push_back(new sql_record(numColumns));
+
+  streaming = true;
+  active = true;
+  ds_state = dsSelect;
+  frecno = 0;
+  fbof = false;
+  feof = !step_stream();
+  fill_fields();
+  return true;
+}
+
+bool SqliteDataset::step_stream() {
+  const int res = sqlite3_step(stream_stmt);
+  if (res == SQLITE_ROW)
   {
-    active = true;
-    ds_state = dsSelect;
-    this->first();
+    read_row(stream_stmt, *result.records[0]);
     return true;
   }
-  else
-  {
+
+  // end of rows (or error), release the statement and its read lock early
+  std::string qry = sqlite3_sql(stream_stmt);
+  const int err = sqlite3_finalize(stream_stmt);
+  stream_stmt = NULL;
+  delete result.records[0];
+  result.records.clear();
+  if (res != SQLITE_DONE && db->setErr(err, qry.c_str()) != SQLITE_OK)
     throw DbErrors(db->getErrorMsg());
-  }  
+  return false;
 }
 
 void SqliteDataset::open(const std::string &sql) {
@@ -715,6 +904,11 @@ void SqliteDataset::open() {
 
 
 void SqliteDataset::close() {
+  if (stream_stmt)
+  {
+    sqlite3_finalize(stream_stmt);
+    stream_stmt = NULL;
+  }
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -755,16 +949,27 @@ void SqliteDataset::first() {
 }
 
 void SqliteDataset::last() {
+  if (streaming) throw DbErrors("last() on a streamed dataset");
   Dataset::last();
   fill_fields();
 }
 
 void SqliteDataset::prev(void) {
+  if (streaming) throw DbErrors("prev() on a streamed dataset");
   Dataset::prev();
   fill_fields();
 }
 
 void SqliteDataset::next(void) {
+  if (streaming)
+  {
+    if (ds_state == dsSelect && !feof)
+    {
+      fbof = false;
+      feof = !(stream_stmt && step_stream());
+    }
+    return;
+  }
   Dataset::next();
   if (!eof()) 
       fill_fields();
@@ -784,6 +989,7 @@ void SqliteDataset::free_row(void)
 }
 
 bool SqliteDataset::seek(int pos) {
+  if (streaming) throw DbErrors("seek() on a streamed dataset");
   if (ds_state == dsSelect) {
     Dataset::seek(pos);
     fill_fields();
@@ -28,6 +28,7 @@
  *
  **********************************************************************/
 
+#include <map>
 #include <stdio.h>
 #include "dataset.h"
 #include <sqlite3.h>
@@ -44,6 +45,11 @@ protected:
   sqlite3 *conn;
   bool _in_transaction;
   int last_err;
+/* compiled statements for bound queries, keyed by their SQL text */
+  std::map<std::string, sqlite3_stmt*> statements;
+
+/* finalizes all cached statements */
+  void finalize_statements();
 
 public:
 /* default constructor */
@@ -96,6 +102,10 @@ public:
 
   bool in_transaction() override {return _in_transaction;}; 	
 
+/* returns the cached compiled statement for sql, preparing it on first use.
+   The statement is owned by the database and must be reset after use. */
+  sqlite3_stmt *get_statement(const std::string &sql);
+
 };
 
 
@@ -127,6 +137,18 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* binds params to the ? placeholders of stmt */
+  void bind_params(sqlite3_stmt *stmt, const BindValues &params);
+/* reads the column headers and all rows of stmt into the result set */
+  void fetch_rows(sqlite3_stmt *stmt);
+/* reads the current row of stmt into rec, reusing its storage */
+  void read_row(sqlite3_stmt *stmt, sql_record &rec);
+/* steps the streamed statement, returns false at the end of the rows */
+  bool step_stream();
+
+/* statement of the open forward-only cursor */
+  sqlite3_stmt *stream_stmt;
+
 public:
 /* constructor */
   SqliteDataset();
@@ -145,9 +167,12 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+  int  exec (const std::string &sql, const BindValues &params) override;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+  bool query(const std::string &query, const BindValues &params) override;
+  bool query_stream(const std::string &query) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,201 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdio.h>
+#if defined(TARGET_POSIX)
+#include <sys/resource.h>
+#endif
+
+#include "gtest/gtest.h"
+
+using namespace dbiplus;
+
+class TestSqliteDataset : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    m_db.setDatabase("TestSqliteDataset");
+    ASSERT_EQ(DB_CONNECTION_OK, m_db.connect(true));
+    m_ds.reset(m_db.CreateDataset());
+    m_ds->exec("CREATE TABLE path (idPath INTEGER PRIMARY KEY, strPath TEXT, iCount INTEGER)");
+  }
+
+  void TearDown() override
+  {
+    m_ds.reset();
+    m_db.disconnect();
+    remove(CSpecialProtocol::TranslatePath("special://temp/TestSqliteDataset.db").c_str());
+  }
+
+  SqliteDatabase m_db;
+  std::unique_ptr<Dataset> m_ds;
+};
+
+TEST_F(TestSqliteDataset, BoundInsertAndQuery)
+{
+  m_ds->exec("INSERT INTO path (idPath, strPath, iCount) VALUES (NULL, ?, ?)",
+             {field_value(std::string("/media/it's here/")), field_value(3)});
+  m_ds->exec("INSERT INTO path (idPath, strPath, iCount) VALUES (NULL, ?, ?)",
+             {field_value("/media/other/"), field_value(5)});
+
+  ASSERT_TRUE(m_ds->query("SELECT idPath, iCount FROM path WHERE strPath=?",
+                          {field_value("/media/it's here/")}));
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_EQ(1, m_ds->fv("idPath").get_asInt());
+  EXPECT_EQ(3, m_ds->fv("iCount").get_asInt());
+  m_ds->close();
+
+  // the cached statement is reused with new values
+  ASSERT_TRUE(m_ds->query("SELECT idPath, iCount FROM path WHERE strPath=?",
+                          {field_value("/media/other/")}));
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_EQ(5, m_ds->fv("iCount").get_asInt());
+  m_ds->close();
+
+  ASSERT_TRUE(m_ds->query("SELECT idPath FROM path WHERE strPath=?",
+                          {field_value("/media/missing/")}));
+  EXPECT_EQ(0, m_ds->num_rows());
+}
+
+TEST_F(TestSqliteDataset, BoundNull)
+{
+  field_value null;
+  null.set_isNull();
+  m_ds->exec("INSERT INTO path (idPath, strPath, iCount) VALUES (NULL, ?, ?)",
+             {field_value("/media/"), null});
+
+  ASSERT_TRUE(m_ds->query("SELECT idPath FROM path WHERE iCount IS NULL", {}));
+  EXPECT_EQ(1, m_ds->num_rows());
+}
+
+TEST_F(TestSqliteDataset, WrongParameterCount)
+{
+  EXPECT_THROW(m_ds->query("SELECT idPath FROM path WHERE strPath=?", {}), DbErrors);
+  EXPECT_THROW(m_ds->query("SELECT idPath FROM path WHERE strPath=?",
+                           {field_value("a"), field_value("b")}), DbErrors);
+
+  // the statement is still usable after a failed bind
+  ASSERT_TRUE(m_ds->query("SELECT idPath FROM path WHERE strPath=?", {field_value("a")}));
+  EXPECT_EQ(0, m_ds->num_rows());
+}
+
+TEST_F(TestSqliteDataset, Stream)
+{
+  for (int i = 0; i < 3; i++)
+    m_ds->exec("INSERT INTO path (idPath, strPath, iCount) VALUES (NULL, ?, ?)",
+               {field_value("/media/" + std::to_string(i) + "/"), field_value(i)});
+  m_ds->exec("UPDATE path SET iCount = NULL WHERE idPath = 2");
+
+  ASSERT_TRUE(m_ds->query_stream("SELECT idPath, strPath, iCount FROM path ORDER BY idPath"));
+  int rows = 0;
+  while (!m_ds->eof())
+  {
+    // only the current row is held
+    EXPECT_EQ(1U, m_ds->get_result_set().records.size());
+    const sql_record *record = m_ds->get_sql_record();
+    ASSERT_NE(nullptr, record);
+    EXPECT_EQ(rows + 1, record->at(0).get_asInt());
+    EXPECT_EQ(rows + 1, m_ds->fv("idPath").get_asInt());
+    EXPECT_EQ("/media/" + std::to_string(rows) + "/", m_ds->fv("strPath").get_asString());
+    EXPECT_EQ(rows == 1, m_ds->fv(2).get_isNull());
+    rows++;
+    m_ds->next();
+  }
+  EXPECT_EQ(3, rows);
+  EXPECT_EQ(nullptr, m_ds->get_sql_record());
+  EXPECT_THROW(m_ds->seek(0), DbErrors);
+  m_ds->close();
+
+  // the connection is usable for writes and ordinary queries afterwards
+  m_ds->exec("DELETE FROM path WHERE idPath = 1");
+  ASSERT_TRUE(m_ds->query("SELECT idPath FROM path"));
+  EXPECT_EQ(2, m_ds->num_rows());
+}
+
+TEST_F(TestSqliteDataset, StreamEmpty)
+{
+  ASSERT_TRUE(m_ds->query_stream("SELECT idPath FROM path"));
+  EXPECT_TRUE(m_ds->eof());
+  EXPECT_EQ(nullptr, m_ds->get_sql_record());
+}
+
+// Compares time to the first row and peak memory of a materialized query
+// against a streamed one over a large table. Run with
+// --gtest_also_run_disabled_tests --gtest_filter=*StreamBenchmark
+TEST_F(TestSqliteDataset, DISABLED_StreamBenchmark)
+{
+  const int rowCount = 100000;
+  m_db.start_transaction();
+  for (int i = 0; i < rowCount; i++)
+    m_ds->exec("INSERT INTO path (idPath, strPath, iCount) VALUES (NULL, ?, ?)",
+               {field_value("/storage/music/some artist/some album/" + std::to_string(i) + ".flac"),
+                field_value(i)});
+  m_db.commit_transaction();
+
+  auto peakKB = []() -> long
+  {
+#if defined(TARGET_POSIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+      return usage.ru_maxrss;
+#endif
+    return 0;
+  };
+
+  auto run = [&](bool stream)
+  {
+    const long startKB = peakKB();
+    const auto start = std::chrono::steady_clock::now();
+    if (stream)
+      m_ds->query_stream("SELECT * FROM path");
+    else
+      m_ds->query("SELECT * FROM path");
+    const auto first = std::chrono::steady_clock::now();
+    int rows = 0;
+    int64_t sum = 0;
+    while (!m_ds->eof())
+    {
+      sum += m_ds->get_sql_record()->at(2).get_asInt64();
+      rows++;
+      m_ds->next();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    m_ds->close();
+    EXPECT_EQ(rowCount, rows);
+    EXPECT_EQ(int64_t(rowCount) * (rowCount - 1) / 2, sum);
+
+    std::cout << (stream ? "streamed:     " : "materialized: ")
+              << "first row " << std::chrono::duration_cast<std::chrono::microseconds>(first - start).count() << "us, "
+              << "total " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms, "
+              << "peak rss +" << peakKB() - startKB << "kB" << std::endl;
+  };
+
+  // streamed first, the peak rss only ever grows
+  run(true);
+  run(false);
+}
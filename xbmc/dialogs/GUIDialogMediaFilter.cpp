@@ -30,6 +30,8 @@
 #include "music/MusicDatabase.h"
 #include "music/MusicDbUrl.h"
 #include "playlists/SmartPlayList.h"
+#include "playlists/SmartPlaylistIndex.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/SettingUtils.h"
 #include "settings/lib/Setting.h"
 #include "settings/windows/GUIControlSettings.h"
@@ -647,6 +649,14 @@ int CGUIDialogMediaFilter::GetItems(const Filter &filter, std::vector<std::strin
     }
   }
 
+  // counts over songs and movies can be answered without running the query
+  if (countOnly && m_dbUrl != NULL && g_advancedSettings.m_useLibraryIndex)
+  {
+    int count;
+    if (CSmartPlaylistIndex::GetInstance().CountDistinct(tmpFilter, m_dbUrl->ToString(), filter.field, count))
+      return count;
+  }
+
   if (m_mediaType == "movies" || m_mediaType == "tvshows" || m_mediaType == "episodes" || m_mediaType == "musicvideos")
   {
     CVideoDatabase videodb;
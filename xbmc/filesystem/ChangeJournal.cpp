@@ -0,0 +1,186 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ChangeJournal.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+
+#if defined(TARGET_LINUX)
+#include "platform/linux/InotifyWatcher.h"
+#endif
+
+using namespace XFILE;
+
+CChangeJournal::CChangeJournal()
+{
+#if defined(TARGET_LINUX)
+  m_watcher.reset(new CInotifyWatcher(*this));
+#endif
+}
+
+CChangeJournal::CChangeJournal(std::unique_ptr<IDirectoryWatcher> watcher)
+  : m_watcher(std::move(watcher))
+{
+}
+
+CChangeJournal::~CChangeJournal()
+{
+  // the watcher thread reports to us until it is stopped
+  m_watcher.reset();
+}
+
+CChangeJournal& CChangeJournal::GetInstance()
+{
+  static CChangeJournal journal;
+  return journal;
+}
+
+std::string CChangeJournal::Normalize(const std::string &path)
+{
+  std::string folder(path);
+  URIUtils::AddSlashAtEnd(folder);
+  return folder;
+}
+
+bool CChangeJournal::IsBelow(const std::string &path, const std::string &folder)
+{
+  return path.compare(0, folder.size(), folder) == 0;
+}
+
+uint64_t CChangeJournal::Watch(const std::set<std::string> &paths)
+{
+  CSingleLock lock(m_critSection);
+  if (!m_watcher)
+    return m_position;
+
+  for (const auto &path : paths)
+  {
+    if (!URIUtils::IsHD(path) || URIUtils::IsSpecial(path) || URIUtils::IsStack(path))
+      continue;
+
+    std::string folder = Normalize(path);
+    bool watched = false;
+    for (const auto &it : m_watched)
+    {
+      if (IsBelow(folder, it.first))
+      {
+        watched = true;
+        break;
+      }
+    }
+    if (watched)
+      continue;
+
+    if (m_watcher->Watch(folder))
+    {
+      CLog::Log(LOGDEBUG, "CChangeJournal::%s - watching %s", __FUNCTION__, folder.c_str());
+      // scans that started before the watch don't count
+      m_watched[folder] = ++m_position;
+    }
+  }
+  return m_position;
+}
+
+void CChangeJournal::MarkScanned(const std::string &path, uint64_t position)
+{
+  CSingleLock lock(m_critSection);
+  std::string folder = Normalize(path);
+
+  uint64_t &scanned = m_scanned[folder];
+  if (scanned < position)
+    scanned = position;
+
+  // changes and scans below the folder are covered by this scan now
+  for (auto it = m_dirty.lower_bound(folder); it != m_dirty.end() && IsBelow(it->first, folder);)
+  {
+    if (it->second <= position)
+      it = m_dirty.erase(it);
+    else
+      ++it;
+  }
+  for (auto it = m_scanned.upper_bound(folder); it != m_scanned.end() && IsBelow(it->first, folder);)
+  {
+    if (it->second <= position)
+      it = m_scanned.erase(it);
+    else
+      ++it;
+  }
+}
+
+bool CChangeJournal::IsUnchanged(const std::string &path) const
+{
+  CSingleLock lock(m_critSection);
+  std::string folder = Normalize(path);
+
+  // find when the folder was last scanned, and whether it was watched by then
+  bool watched = false;
+  uint64_t watchedSince = 0;
+  bool scanned = false;
+  uint64_t scannedAt = 0;
+  for (size_t pos = folder.find('/'); pos != std::string::npos; pos = folder.find('/', pos + 1))
+  {
+    std::string parent = folder.substr(0, pos + 1);
+
+    auto watch = m_watched.find(parent);
+    if (watch != m_watched.end() && !watched)
+    {
+      watched = true;
+      watchedSince = watch->second;
+    }
+
+    auto scan = m_scanned.find(parent);
+    if (scan != m_scanned.end() && (!scanned || scan->second > scannedAt))
+    {
+      scanned = true;
+      scannedAt = scan->second;
+    }
+  }
+  if (!watched || !scanned || scannedAt < watchedSince)
+    return false;
+
+  for (auto it = m_dirty.lower_bound(folder); it != m_dirty.end() && IsBelow(it->first, folder); ++it)
+  {
+    if (it->second > scannedAt)
+      return false;
+  }
+  return true;
+}
+
+void CChangeJournal::MarkDirty(const std::string &path)
+{
+  CSingleLock lock(m_critSection);
+  m_dirty[Normalize(path)] = ++m_position;
+}
+
+void CChangeJournal::MarkAllDirty()
+{
+  CSingleLock lock(m_critSection);
+  CLog::Log(LOGWARNING, "CChangeJournal::%s - changes may have been missed, all folders will be hashed on the next scan", __FUNCTION__);
+  ++m_position;
+  m_scanned.clear();
+  m_dirty.clear();
+}
+
+void CChangeJournal::MarkUnwatched(const std::string &path)
+{
+  CSingleLock lock(m_critSection);
+  m_dirty[Normalize(path)] = UINT64_MAX;
+}
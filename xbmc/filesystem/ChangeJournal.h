@@ -0,0 +1,120 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <stdint.h>
+#include <string>
+
+namespace XFILE
+{
+
+class CChangeJournal;
+
+/*!
+ \brief Platform service reporting changes below local folders to a CChangeJournal
+ */
+class IDirectoryWatcher
+{
+public:
+  virtual ~IDirectoryWatcher() = default;
+
+  /*! \brief Start watching a folder and every folder below it
+   Changes are reported through CChangeJournal::MarkDirty(), folders below it
+   that can't be watched through CChangeJournal::MarkUnwatched() and lost
+   events through CChangeJournal::MarkAllDirty().
+   \param path the folder to watch, with a trailing slash
+   \return false if the folder can't be watched, e.g. as it's on a network share
+   */
+  virtual bool Watch(const std::string &path) = 0;
+};
+
+/*!
+ \brief Journal of the local folders that changed since they were last scanned
+
+ The library scanners hash every folder of a source to find out what changed,
+ which means a stat() of every file on each update. Folders watched by the
+ journal can instead be skipped as a whole, as long as they were scanned
+ completely since the watch started and no change was recorded below them.
+
+ The journal only lives as long as the application: changes made while it isn't
+ running aren't seen, so the first scan of each source after a start falls back
+ to hashing.
+ */
+class CChangeJournal
+{
+public:
+  /*! \brief Journal fed by the watcher of the platform, if there's one
+   */
+  CChangeJournal();
+  explicit CChangeJournal(std::unique_ptr<IDirectoryWatcher> watcher);
+  ~CChangeJournal();
+
+  static CChangeJournal& GetInstance();
+
+  /*! \brief Start watching local folders, if not watched already
+   \param paths the folders to watch. Network paths are ignored.
+   \return the current position of the journal, to pass to MarkScanned() once
+           the folders are scanned.
+   */
+  uint64_t Watch(const std::set<std::string> &paths);
+
+  /*! \brief Record that a folder and everything below it has been scanned
+   \param path the folder that was scanned
+   \param position the position returned by Watch() before the scan started
+   */
+  void MarkScanned(const std::string &path, uint64_t position);
+
+  /*! \brief Whether nothing below a folder changed since it was last scanned
+   \param path the folder to check
+   \return true if the folder is watched, was scanned since and had no changes
+   */
+  bool IsUnchanged(const std::string &path) const;
+
+  /*! \brief Record a change of the given folder
+   */
+  void MarkDirty(const std::string &path);
+
+  /*! \brief Forget about every scan, e.g. after the watcher lost events
+   */
+  void MarkAllDirty();
+
+  /*! \brief Record that changes below a folder can't be watched
+   The folder is considered changed on every scan from now on.
+   */
+  void MarkUnwatched(const std::string &path);
+
+private:
+  static std::string Normalize(const std::string &path);
+  static bool IsBelow(const std::string &path, const std::string &folder);
+
+  std::unique_ptr<IDirectoryWatcher> m_watcher;
+  uint64_t m_position = 0;
+  std::map<std::string, uint64_t> m_watched; ///< position at which each watch started
+  std::map<std::string, uint64_t> m_scanned; ///< position before the last complete scan of a folder
+  std::map<std::string, uint64_t> m_dirty;   ///< position of the last change of a folder
+  mutable CCriticalSection m_critSection;
+};
+
+}
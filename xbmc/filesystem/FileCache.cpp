@@ -25,6 +25,7 @@
 #include "URL.h"
 
 #include "CircularCache.h"
+#include "SparseFileCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
@@ -179,7 +180,17 @@ bool CFileCache::Open(const CURL& url)
 
   if (!m_pCache)
   {
-    if (g_advancedSettings.m_cacheMemSize == 0)
+    bool doubleBuffer = (m_flags & READ_MULTI_STREAM) != 0;
+
+    if (g_advancedSettings.m_cacheDiskSize > 0 && m_seekPossible > 0 && (m_flags & READ_AUDIO_VIDEO))
+    {
+      // Keep everything fetched on disk, so seeking back doesn't hit the source again.
+      // All fetched ranges are kept, so there is no need for double buffering either
+      m_pCache = new CSparseFileCache(static_cast<int64_t>(g_advancedSettings.m_cacheDiskSize) * 1024 * 1024);
+      m_forwardCacheSize = 0;
+      doubleBuffer = false;
+    }
+    else if (g_advancedSettings.m_cacheMemSize == 0)
     {
       // Use cache on disk
       m_pCache = new CSimpleFileCache();
@@ -211,7 +222,7 @@ bool CFileCache::Open(const CURL& url)
       m_forwardCacheSize = front;
     }
 
-    if (m_flags & READ_MULTI_STREAM)
+    if (doubleBuffer)
     {
       // If READ_MULTI_STREAM flag is set: Double buffering is required
       m_pCache = new CDoubleCache(m_pCache);
@@ -408,6 +419,21 @@ void CFileCache::Process()
 
     m_writePos += iTotalWrite;
 
+    // the cache may already hold the data that follows, fetch what comes after it
+    const int64_t cacheMaxPos = m_pCache->CachedDataEndPos();
+    if (cacheMaxPos > m_writePos)
+    {
+      cacheReachEOF = (cacheMaxPos == m_fileSize);
+      if (!cacheReachEOF && m_source.Seek(cacheMaxPos, SEEK_SET) != cacheMaxPos)
+      {
+        CLog::Log(LOGERROR, "CFileCache::Process - Error %d seeking past cached data to %" PRId64, (int)GetLastError(), cacheMaxPos);
+        break;
+      }
+      m_writePos = cacheMaxPos;
+      average.Reset(m_writePos, false);
+      limiter.Reset(m_writePos);
+    }
+
     // under estimate write rate by a second, to
     // avoid uncertainty at start of caching
     m_writeRateActual = average.Rate(m_writePos, 1000);
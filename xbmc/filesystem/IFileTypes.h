@@ -66,6 +66,12 @@ struct SCacheStatus
   float    level;    /**< cache level (0.0 - 1.0) */
 };
 
+struct SFileRange
+{
+  int64_t offset;
+  int64_t length;
+};
+
 typedef enum {
   IOCTRL_NATIVE        = 1,  /**< SNativeIoControl structure, containing what should be passed to native ioctrl */
   IOCTRL_SEEK_POSSIBLE = 2,  /**< return 0 if known not to work, 1 if it should work */
@@ -73,6 +79,7 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_FREE_RANGE    = 32, /**< SFileRange structure, release the disk space of a range of a local file, it reads back as zeros */
 } EIoControl;
 
 enum CURLOPTIONTYPE
@@ -0,0 +1,440 @@
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SparseFileCache.h"
+#include "IFile.h"
+#include "SpecialProtocol.h"
+#include "URL.h"
+#include "Util.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#if defined(TARGET_POSIX)
+#include "posix/PosixFile.h"
+#define CacheLocalFile CPosixFile
+#elif defined(TARGET_WINDOWS)
+#include "win32/Win32File.h"
+#define CacheLocalFile CWin32File
+#endif // TARGET_WINDOWS
+
+#include <algorithm>
+#include <iterator>
+
+using namespace XFILE;
+
+CSparseFileCache::CSparseFileCache(int64_t maxSize)
+  : m_cacheFileRead(new CacheLocalFile())
+  , m_cacheFileWrite(new CacheLocalFile())
+  , m_hDataAvailEvent(false)
+  , m_cachedSize(0)
+  , m_maxSize(maxSize)
+  , m_nWritePosition(0)
+  , m_nReadPosition(0)
+  , m_canFreeSpace(true)
+{
+}
+
+CSparseFileCache::~CSparseFileCache()
+{
+  Close();
+  delete m_cacheFileRead;
+  delete m_cacheFileWrite;
+}
+
+int CSparseFileCache::Open()
+{
+  Close();
+
+  m_filename = CSpecialProtocol::TranslatePath(CUtil::GetNextFilename("special://temp/filecache%03d.cache", 999));
+  if (m_filename.empty())
+  {
+    CLog::LogF(LOGERROR, "unable to generate a new filename");
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  CURL fileURL(m_filename);
+
+  if (!m_cacheFileWrite->OpenForWrite(fileURL, false))
+  {
+    CLog::LogF(LOGERROR, "failed to create file \"%s\" for writing", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  if (!m_cacheFileRead->Open(fileURL))
+  {
+    CLog::LogF(LOGERROR, "failed to open file \"%s\" for reading", m_filename.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  CSingleLock lock(m_sync);
+  m_ranges.clear();
+  m_cachedSize = 0;
+  m_nWritePosition = 0;
+  m_nReadPosition = 0;
+  m_canFreeSpace = true;
+
+  return CACHE_RC_OK;
+}
+
+void CSparseFileCache::Close()
+{
+  m_cacheFileWrite->Close();
+  m_cacheFileRead->Close();
+
+  if (!m_filename.empty() && !m_cacheFileRead->Delete(CURL(m_filename)))
+    CLog::LogF(LOGWARNING, "failed to delete temporary file \"%s\"", m_filename.c_str());
+
+  m_filename.clear();
+
+  CSingleLock lock(m_sync);
+  m_ranges.clear();
+  m_cachedSize = 0;
+}
+
+CSparseFileCache::RangeMap::iterator CSparseFileCache::FindRange(int64_t iFilePosition)
+{
+  // the last range starting at or before the position, if it reaches it
+  RangeMap::iterator it = m_ranges.upper_bound(iFilePosition);
+  if (it == m_ranges.begin())
+    return m_ranges.end();
+  --it;
+  return iFilePosition <= it->second ? it : m_ranges.end();
+}
+
+CSparseFileCache::RangeMap::const_iterator CSparseFileCache::FindRange(int64_t iFilePosition) const
+{
+  RangeMap::const_iterator it = m_ranges.upper_bound(iFilePosition);
+  if (it == m_ranges.begin())
+    return m_ranges.end();
+  --it;
+  return iFilePosition <= it->second ? it : m_ranges.end();
+}
+
+void CSparseFileCache::AddRange(int64_t start, int64_t end)
+{
+  // merge with any range overlapping or touching the new one
+  RangeMap::iterator it = m_ranges.upper_bound(start);
+  if (it != m_ranges.begin())
+  {
+    RangeMap::iterator prev = std::prev(it);
+    if (prev->second >= start)
+    {
+      start = prev->first;
+      end = std::max(end, prev->second);
+      m_cachedSize -= prev->second - prev->first;
+      it = m_ranges.erase(prev);
+    }
+  }
+  while (it != m_ranges.end() && it->first <= end)
+  {
+    end = std::max(end, it->second);
+    m_cachedSize -= it->second - it->first;
+    it = m_ranges.erase(it);
+  }
+
+  m_ranges[start] = end;
+  m_cachedSize += end - start;
+}
+
+bool CSparseFileCache::EvictRanges(int64_t space)
+{
+  while (m_cachedSize + space > m_maxSize)
+  {
+    RangeMap::iterator current = FindRange(m_nReadPosition);
+    RangeMap::iterator writing = FindRange(m_nWritePosition);
+
+    // drop the range furthest away from where we are reading
+    RangeMap::iterator victim = m_ranges.end();
+    int64_t victimDistance = -1;
+    for (RangeMap::iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+    {
+      if (it == current || it == writing)
+        continue;
+
+      int64_t distance = it->second < m_nReadPosition ? m_nReadPosition - it->second : it->first - m_nReadPosition;
+      if (distance > victimDistance)
+      {
+        victim = it;
+        victimDistance = distance;
+      }
+    }
+
+    // a partial write beats dropping another whole range
+    if (m_cachedSize < m_maxSize)
+      return true;
+
+    if (victim != m_ranges.end())
+    {
+      m_cachedSize -= victim->second - victim->first;
+      FreeRange(victim->first, victim->second);
+      m_ranges.erase(victim);
+      continue;
+    }
+
+    // only the range we are reading from is left, drop data already read
+    if (current == m_ranges.end() || current->first >= m_nReadPosition)
+      return false;
+
+    int64_t start = std::min(m_nReadPosition, current->first + (m_cachedSize + space - m_maxSize));
+    int64_t end = current->second;
+    m_cachedSize -= start - current->first;
+    FreeRange(current->first, start);
+    m_ranges.erase(current);
+    m_ranges[start] = end;
+  }
+  return true;
+}
+
+void CSparseFileCache::FreeRange(int64_t start, int64_t end)
+{
+  if (!m_canFreeSpace || end <= start)
+    return;
+
+  SFileRange range = { start, end - start };
+  if (m_cacheFileWrite->IoControl(IOCTRL_FREE_RANGE, &range) != 0)
+  {
+    CLog::LogF(LOGDEBUG, "file system can't release cached ranges, \"%s\" keeps growing until closed", m_filename.c_str());
+    m_canFreeSpace = false;
+  }
+}
+
+size_t CSparseFileCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  CSingleLock lock(m_sync);
+
+  if (m_cachedSize + static_cast<int64_t>(iRequestSize) > m_maxSize)
+    EvictRanges(iRequestSize);
+
+  if (m_cachedSize >= m_maxSize)
+    return 0;
+
+  return static_cast<size_t>(std::min(static_cast<int64_t>(iRequestSize), m_maxSize - m_cachedSize));
+}
+
+int CSparseFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  // only the cache thread writes, so the position is stable while we write
+  int64_t start = m_nWritePosition;
+  size_t toWrite = iSize;
+  {
+    // data we have already is not written again
+    CSingleLock lock(m_sync);
+    RangeMap::const_iterator next = m_ranges.upper_bound(start);
+    if (next != m_ranges.end() && start + static_cast<int64_t>(toWrite) > next->first)
+      toWrite = static_cast<size_t>(next->first - start);
+  }
+
+  size_t written = 0;
+  while (toWrite > 0)
+  {
+    const ssize_t lastWritten = m_cacheFileWrite->Write(pBuffer + written, (toWrite > SSIZE_MAX) ? SSIZE_MAX : toWrite);
+    if (lastWritten <= 0)
+    {
+      CLog::LogF(LOGERROR, "failed to write to file");
+      return CACHE_RC_ERROR;
+    }
+    toWrite -= lastWritten;
+    written += lastWritten;
+  }
+
+  {
+    CSingleLock lock(m_sync);
+    AddRange(start, start + written);
+
+    // once we reach the next cached range, continue fetching behind it. The
+    // caller sees CachedDataEndPos() move ahead and seeks the source there
+    m_nWritePosition = FindRange(start)->second;
+    if (m_nWritePosition != start + static_cast<int64_t>(written))
+      m_cacheFileWrite->Seek(m_nWritePosition, SEEK_SET);
+  }
+
+  // when reader waits for data it will wait on the event.
+  m_hDataAvailEvent.Set();
+
+  return m_nWritePosition == start + static_cast<int64_t>(written) ? written : iSize;
+}
+
+int64_t CSparseFileCache::GetAvailableRead() const
+{
+  RangeMap::const_iterator it = FindRange(m_nReadPosition);
+  if (it == m_ranges.end())
+    return 0;
+  return it->second - m_nReadPosition;
+}
+
+int CSparseFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  int64_t iAvailable;
+  {
+    CSingleLock lock(m_sync);
+    iAvailable = GetAvailableRead();
+  }
+  if (iAvailable <= 0)
+    return m_bEndOfInput ? 0 : CACHE_RC_WOULD_BLOCK;
+
+  size_t toRead = ((int64_t)iMaxSize > iAvailable) ? (size_t)iAvailable : iMaxSize;
+
+  size_t readBytes = 0;
+  while (toRead > 0)
+  {
+    const ssize_t lastRead = m_cacheFileRead->Read(pBuffer + readBytes, (toRead > SSIZE_MAX) ? SSIZE_MAX : toRead);
+    if (lastRead == 0)
+      break;
+    if (lastRead < 0)
+    {
+      CLog::LogF(LOGERROR, "failed to read from file");
+      return CACHE_RC_ERROR;
+    }
+    toRead -= lastRead;
+    readBytes += lastRead;
+  }
+
+  if (readBytes > 0)
+  {
+    {
+      CSingleLock lock(m_sync);
+      m_nReadPosition += readBytes;
+    }
+    m_space.Set();
+  }
+
+  return readBytes;
+}
+
+int64_t CSparseFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  CSingleLock lock(m_sync);
+  if (iMillis == 0 || IsEndOfInput())
+    return GetAvailableRead();
+
+  XbmcThreads::EndTime endTime(iMillis);
+  while (!IsEndOfInput())
+  {
+    int64_t iAvail = GetAvailableRead();
+    if (iAvail >= iMinAvail)
+      return iAvail;
+
+    lock.Leave();
+    bool signaled = m_hDataAvailEvent.WaitMSec(endTime.MillisLeft());
+    lock.Enter();
+    if (!signaled)
+      return CACHE_RC_TIMEOUT;
+  }
+  return GetAvailableRead();
+}
+
+int64_t CSparseFileCache::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit past what we are fetching right now, wait for the data
+  // rather than triggering a (heavy) seek on the source
+  int64_t nDiff = iFilePosition - m_nWritePosition;
+  if (nDiff > 0 && nDiff < 500000 && FindRange(m_nReadPosition) == FindRange(m_nWritePosition))
+  {
+    unsigned int minAvail = static_cast<unsigned int>(iFilePosition - m_nReadPosition);
+    lock.Leave();
+    WaitForData(minAvail, 5000);
+    lock.Enter();
+  }
+
+  if (FindRange(iFilePosition) == m_ranges.end())
+    return CACHE_RC_ERROR;
+
+  if (m_cacheFileRead->Seek(iFilePosition, SEEK_SET) != iFilePosition)
+  {
+    CLog::LogF(LOGERROR, "can't seek file");
+    return CACHE_RC_ERROR;
+  }
+  m_nReadPosition = iFilePosition;
+
+  m_space.Set();
+
+  return iFilePosition;
+}
+
+bool CSparseFileCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  bool bCompleteReset = true;
+  if (!clearAnyway && IsCachedPosition(iSourcePosition))
+  {
+    // continue fetching at the end of the range we seeked into
+    m_nWritePosition = CachedDataEndPosIfSeekTo(iSourcePosition);
+    bCompleteReset = false;
+  }
+  else
+  {
+    if (clearAnyway)
+    {
+      for (RangeMap::const_iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+        FreeRange(it->first, it->second);
+      m_ranges.clear();
+      m_cachedSize = 0;
+    }
+    m_nWritePosition = iSourcePosition;
+  }
+
+  m_nReadPosition = m_cacheFileRead->Seek(iSourcePosition, SEEK_SET);
+  m_cacheFileWrite->Seek(m_nWritePosition, SEEK_SET);
+  return bCompleteReset;
+}
+
+void CSparseFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_hDataAvailEvent.Set();
+}
+
+int64_t CSparseFileCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  RangeMap::const_iterator it = FindRange(iFilePosition);
+  if (it != m_ranges.end())
+    return it->second;
+  return iFilePosition;
+}
+
+int64_t CSparseFileCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_nWritePosition;
+}
+
+bool CSparseFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return iFilePosition == m_nWritePosition || FindRange(iFilePosition) != m_ranges.end();
+}
+
+CCacheStrategy *CSparseFileCache::CreateNew()
+{
+  return new CSparseFileCache(m_maxSize);
+}
+
+int64_t CSparseFileCache::GetCachedSize() const
+{
+  CSingleLock lock(m_sync);
+  return m_cachedSize;
+}
@@ -0,0 +1,96 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2014 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <map>
+#include <string>
+
+namespace XFILE {
+
+/*!
+ \brief Cache strategy keeping every range fetched from the source in a local file
+
+ Data is stored in a (sparse) temporary file at the same offset it has in the
+ source, and a range map keeps track of what has been fetched. Contrary to
+ CCircularCache and CSimpleFileCache, ranges outside of the current read window
+ are kept across seeks, so seeking back to already fetched data is served from
+ local disk instead of the (slow) source.
+
+ Once more than the configured size is cached, the ranges furthest away from
+ the read position are dropped from the map and their disk space is given back
+ by punching holes into the file (IOCTRL_FREE_RANGE), so the file never takes
+ much more than the configured size on disk. On file systems without sparse
+ file support the space is only released when the cache is closed.
+ */
+class CSparseFileCache : public CCacheStrategy
+{
+public:
+  explicit CSparseFileCache(int64_t maxSize);
+  ~CSparseFileCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+  void EndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+  int64_t GetCachedSize() const;
+
+protected:
+  typedef std::map<int64_t, int64_t> RangeMap; ///< start -> end (exclusive) of cached data
+
+  RangeMap::iterator FindRange(int64_t iFilePosition);
+  RangeMap::const_iterator FindRange(int64_t iFilePosition) const;
+  int64_t GetAvailableRead() const;
+  void AddRange(int64_t start, int64_t end);
+  /*! \brief Drop ranges until the given number of bytes fits into the cache */
+  bool EvictRanges(int64_t space);
+  void FreeRange(int64_t start, int64_t end);
+
+  std::string m_filename;
+  IFile*   m_cacheFileRead;
+  IFile*   m_cacheFileWrite;
+  CEvent   m_hDataAvailEvent;
+  mutable CCriticalSection m_sync;
+  RangeMap m_ranges;
+  int64_t  m_cachedSize;
+  int64_t  m_maxSize;
+  int64_t  m_nWritePosition;
+  int64_t  m_nReadPosition;
+  bool     m_canFreeSpace;
+};
+
+} // namespace XFILE
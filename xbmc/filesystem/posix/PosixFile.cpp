@@ -278,6 +278,22 @@ int CPosixFile::IoControl(EIoControl request, void* param)
         return 0; // size of file is 1 byte or more and seeking not possible
     }
   }
+  else if (request == IOCTRL_FREE_RANGE)
+  {
+    if (!param || !m_allowWrite)
+      return -1;
+    const SFileRange* range = static_cast<const SFileRange*>(param);
+#if defined(FALLOC_FL_PUNCH_HOLE)
+    return fallocate(m_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, range->offset, range->length);
+#elif defined(F_PUNCHHOLE)
+    fpunchhole_t hole = {};
+    hole.fp_offset = range->offset;
+    hole.fp_length = range->length;
+    return fcntl(m_fd, F_PUNCHHOLE, &hole);
+#else
+    return -1;
+#endif
+  }
   
   return -1;
 }
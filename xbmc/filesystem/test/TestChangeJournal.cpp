@@ -0,0 +1,106 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/ChangeJournal.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+class CFakeWatcher : public IDirectoryWatcher
+{
+public:
+  bool Watch(const std::string &path) override
+  {
+    return path.compare(0, 6, "/mnt/n") != 0; // pretend that's a network share
+  }
+};
+
+class TestChangeJournal : public ::testing::Test
+{
+protected:
+  TestChangeJournal() : journal(std::unique_ptr<IDirectoryWatcher>(new CFakeWatcher)) {}
+
+  CChangeJournal journal;
+};
+}
+
+TEST_F(TestChangeJournal, UnchangedAfterScan)
+{
+  uint64_t position = journal.Watch({ "/media/movies/" });
+  EXPECT_FALSE(journal.IsUnchanged("/media/movies/"));
+
+  journal.MarkScanned("/media/movies/", position);
+  EXPECT_TRUE(journal.IsUnchanged("/media/movies/"));
+  EXPECT_TRUE(journal.IsUnchanged("/media/movies/Alien (1979)/"));
+  EXPECT_TRUE(journal.IsUnchanged("/media/movies/Alien (1979)"));
+  EXPECT_FALSE(journal.IsUnchanged("/media/music/"));
+}
+
+TEST_F(TestChangeJournal, ChangeDirtiesParents)
+{
+  uint64_t position = journal.Watch({ "/media/movies/" });
+  journal.MarkScanned("/media/movies/", position);
+
+  journal.MarkDirty("/media/movies/Alien (1979)/");
+  EXPECT_FALSE(journal.IsUnchanged("/media/movies/"));
+  EXPECT_FALSE(journal.IsUnchanged("/media/movies/Alien (1979)/"));
+  EXPECT_TRUE(journal.IsUnchanged("/media/movies/Heat (1995)/"));
+
+  // a scan started before the change doesn't cover it
+  journal.MarkScanned("/media/movies/", position);
+  EXPECT_FALSE(journal.IsUnchanged("/media/movies/"));
+
+  position = journal.Watch({ "/media/movies/" });
+  journal.MarkScanned("/media/movies/", position);
+  EXPECT_TRUE(journal.IsUnchanged("/media/movies/"));
+}
+
+TEST_F(TestChangeJournal, ScanBeforeWatchDoesNotCount)
+{
+  uint64_t position = journal.Watch({ "/media/movies/" });
+  journal.Watch({ "/media/tvshows/" });
+  journal.MarkScanned("/media/tvshows/", position);
+  EXPECT_FALSE(journal.IsUnchanged("/media/tvshows/"));
+}
+
+TEST_F(TestChangeJournal, NetworkPathsAreHashed)
+{
+  uint64_t position = journal.Watch({ "/mnt/nas/movies/", "smb://nas/movies/" });
+  journal.MarkScanned("/mnt/nas/movies/", position);
+  journal.MarkScanned("smb://nas/movies/", position);
+  EXPECT_FALSE(journal.IsUnchanged("/mnt/nas/movies/"));
+  EXPECT_FALSE(journal.IsUnchanged("smb://nas/movies/"));
+}
+
+TEST_F(TestChangeJournal, UnwatchedAndLostEvents)
+{
+  uint64_t position = journal.Watch({ "/media/movies/" });
+  journal.MarkUnwatched("/media/movies/link/");
+  journal.MarkScanned("/media/movies/", position);
+  EXPECT_FALSE(journal.IsUnchanged("/media/movies/"));
+  EXPECT_FALSE(journal.IsUnchanged("/media/movies/link/"));
+  EXPECT_TRUE(journal.IsUnchanged("/media/movies/Heat (1995)/"));
+
+  journal.MarkAllDirty();
+  EXPECT_FALSE(journal.IsUnchanged("/media/movies/Heat (1995)/"));
+}
@@ -0,0 +1,167 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/SparseFileCache.h"
+
+#include <string.h>
+#include <vector>
+
+#if defined(TARGET_POSIX)
+#include <sys/stat.h>
+#endif
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+void Fill(CSparseFileCache &cache, int64_t position, size_t size)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<char>((position + i) & 0xff);
+
+  cache.Reset(position, false);
+  ASSERT_EQ(static_cast<int>(size), cache.WriteToCache(data.data(), size));
+}
+
+class CTestSparseFileCache : public CSparseFileCache
+{
+public:
+  using CSparseFileCache::CSparseFileCache;
+  const std::string& GetFilename() const { return m_filename; }
+};
+}
+
+TEST(TestSparseFileCache, KeepsRangesAcrossSeeks)
+{
+  CSparseFileCache cache(1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 4096);
+  Fill(cache, 100000, 4096);
+
+  EXPECT_TRUE(cache.IsCachedPosition(1000));
+  EXPECT_TRUE(cache.IsCachedPosition(102000));
+  EXPECT_FALSE(cache.IsCachedPosition(50000));
+  EXPECT_EQ(4096, cache.CachedDataEndPosIfSeekTo(1000));
+  EXPECT_EQ(104096, cache.CachedDataEndPosIfSeekTo(100000));
+  EXPECT_EQ(50000, cache.CachedDataEndPosIfSeekTo(50000));
+
+  // seeking back into the first range is served from the cache
+  ASSERT_EQ(1000, cache.Seek(1000));
+  char buf[16];
+  ASSERT_EQ(16, cache.ReadFromCache(buf, sizeof(buf)));
+  for (int i = 0; i < 16; i++)
+    EXPECT_EQ(static_cast<char>((1000 + i) & 0xff), buf[i]);
+
+  // continuing to fetch after the first range continues at its end
+  EXPECT_FALSE(cache.Reset(2000, false));
+  EXPECT_EQ(4096, cache.CachedDataEndPos());
+  EXPECT_EQ(8192, cache.GetCachedSize());
+
+  cache.Close();
+}
+
+TEST(TestSparseFileCache, MergesAdjacentRanges)
+{
+  CSparseFileCache cache(1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 8192, 4096);
+  Fill(cache, 0, 8192);
+
+  EXPECT_EQ(12288, cache.CachedDataEndPosIfSeekTo(0));
+  EXPECT_EQ(12288, cache.GetCachedSize());
+
+  cache.Close();
+}
+
+TEST(TestSparseFileCache, SkipsCachedRanges)
+{
+  CSparseFileCache cache(1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 4096);
+  Fill(cache, 8192, 4096);
+
+  // fetching on after the first range stops writing where the second one starts
+  EXPECT_FALSE(cache.Reset(1000, false));
+  EXPECT_EQ(4096, cache.CachedDataEndPos());
+  std::vector<char> data(8192, static_cast<char>(0xee));
+  EXPECT_EQ(8192, cache.WriteToCache(data.data(), data.size()));
+  EXPECT_EQ(12288, cache.CachedDataEndPos());
+  EXPECT_EQ(12288, cache.GetCachedSize());
+
+  ASSERT_EQ(8192, cache.Seek(8192));
+  char buf[16];
+  ASSERT_EQ(16, cache.ReadFromCache(buf, sizeof(buf)));
+  for (int i = 0; i < 16; i++)
+    EXPECT_EQ(static_cast<char>((8192 + i) & 0xff), buf[i]);
+
+  cache.Close();
+}
+
+TEST(TestSparseFileCache, EvictsFarRanges)
+{
+  CSparseFileCache cache(16384);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 8192);
+  Fill(cache, 1000000, 8192);
+  Fill(cache, 500000, 4096);
+
+  // the range furthest from the read position has to go first
+  EXPECT_GT(cache.GetMaxWriteSize(8192), 0u);
+  EXPECT_FALSE(cache.IsCachedPosition(1004000));
+  EXPECT_TRUE(cache.IsCachedPosition(4000));
+  EXPECT_LE(cache.GetCachedSize(), 16384);
+
+  cache.Close();
+}
+
+#if defined(TARGET_POSIX)
+TEST(TestSparseFileCache, ReleasesEvictedSpace)
+{
+  const int64_t maxSize = 64 * 1024;
+  const size_t chunk = 16 * 1024;
+  CTestSparseFileCache cache(maxSize);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // fetch far apart ranges, each one forces the oldest out of the cache
+  for (int64_t position = 0; position < 64 * 1024 * 1024; position += 1024 * 1024)
+  {
+    cache.Reset(position, false);
+    ASSERT_EQ(chunk, cache.GetMaxWriteSize(chunk));
+    std::vector<char> data(chunk, 1);
+    ASSERT_EQ(static_cast<int>(chunk), cache.WriteToCache(data.data(), chunk));
+  }
+  EXPECT_LE(cache.GetCachedSize(), maxSize);
+
+  struct stat st;
+  ASSERT_EQ(0, stat(cache.GetFilename().c_str(), &st));
+  // the file spans 63 MB, but only what is still cached takes up blocks
+  EXPECT_GT(st.st_size, 63 * 1024 * 1024);
+  EXPECT_LE(static_cast<int64_t>(st.st_blocks) * 512, 2 * maxSize);
+
+  cache.Close();
+}
+#endif
@@ -27,6 +27,7 @@
 #include "utils/auto_buffer.h"
 
 #include <Windows.h>
+#include <winioctl.h>
 
 #include <sys/stat.h>
 
@@ -379,6 +380,35 @@ void CWin32File::Flush()
   FlushFileBuffers(m_hFile);
 }
 
+int CWin32File::IoControl(EIoControl request, void* param)
+{
+  if (m_hFile == INVALID_HANDLE_VALUE)
+    return -1;
+
+#ifndef TARGET_WINDOWS_STORE
+  if (request == IOCTRL_FREE_RANGE)
+  {
+    if (!param || !m_allowWrite || m_smbFile)
+      return -1;
+    const SFileRange* range = static_cast<const SFileRange*>(param);
+
+    // zeroed ranges only give back space once the file is marked as sparse
+    DWORD bytesReturned;
+    if (!DeviceIoControl(m_hFile, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &bytesReturned, NULL))
+      return -1;
+
+    FILE_ZERO_DATA_INFORMATION zeroData;
+    zeroData.FileOffset.QuadPart = range->offset;
+    zeroData.BeyondFinalZero.QuadPart = range->offset + range->length;
+    if (!DeviceIoControl(m_hFile, FSCTL_SET_ZERO_DATA, &zeroData, sizeof(zeroData), NULL, 0, &bytesReturned, NULL))
+      return -1;
+    return 0;
+  }
+#endif
+
+  return -1;
+}
+
 bool CWin32File::Delete(const CURL& url)
 {
   assert((!m_smbFile && url.GetProtocol().empty()) || (m_smbFile && url.IsProtocol("smb"))); // function suitable only for local or SMB files
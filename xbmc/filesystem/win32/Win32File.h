@@ -43,6 +43,7 @@ namespace XFILE
     virtual int64_t GetPosition();
     virtual int64_t GetLength();
     virtual void Flush();
+    virtual int IoControl(EIoControl request, void* param);
 
     virtual bool Delete(const CURL& url);
     virtual bool Rename(const CURL& urlCurrentName, const CURL& urlNewName);
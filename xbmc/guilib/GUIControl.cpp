@@ -127,6 +127,8 @@ void CGUIControl::DynamicResourceAlloc(bool bOnOff)
 // 3. reset the animation transform
 void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
+  GUIPROFILER_PROCESS_BEGIN(this);
+
   CRect dirtyRegion = m_renderRegion;
 
   bool changed = (m_controlDirtyState & DIRTY_STATE_CONTROL) != 0 || (m_bInvalidated && IsVisible());
@@ -163,6 +165,8 @@ void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyreg
   {
     dirtyregions.push_back(CDirtyRegion(dirtyRegion));
   }
+
+  GUIPROFILER_PROCESS_END(this);
 }
 
 void CGUIControl::Process(unsigned int currentTime, CDirtyRegionList &dirtyregions)
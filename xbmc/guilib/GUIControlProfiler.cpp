@@ -26,7 +26,7 @@
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
-: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_i64VisStart(0), m_i64RenderStart(0)
+: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_processTime(0), m_renderTime(0), m_i64VisStart(0), m_i64ProcessStart(0), m_i64RenderStart(0)
 {
   if (m_pControl)
   {
@@ -53,6 +53,7 @@ void CGUIControlProfilerItem::Reset(CGUIControlProfiler *pProfiler)
   m_pControl = NULL;
 
   m_visTime = 0;
+  m_processTime = 0;
   m_renderTime = 0;
   const unsigned int dwSize = m_vecChildren.size();
   for (unsigned int i=0; i<dwSize; ++i)
@@ -72,6 +73,16 @@ void CGUIControlProfilerItem::EndVisibility(void)
   m_visTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64VisStart));
 }
 
+void CGUIControlProfilerItem::BeginProcess(void)
+{
+  m_i64ProcessStart = CurrentHostCounter();
+}
+
+void CGUIControlProfilerItem::EndProcess(void)
+{
+  m_processTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64ProcessStart));
+}
+
 void CGUIControlProfilerItem::BeginRender(void)
 {
   m_i64RenderStart = CurrentHostCounter();
@@ -177,16 +188,23 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
 
   // Note time is stored in 1/100 milliseconds but reported in ms
   unsigned int vis = m_visTime / 100;
+  unsigned int proc = m_processTime / 100;
   unsigned int rend = m_renderTime / 100;
-  if (vis || rend)
+  if (vis || proc || rend)
   {
     std::string val;
-    TiXmlElement *elem = new TiXmlElement("rendertime");
+    TiXmlElement *elem = new TiXmlElement("processtime");
     xmlControl->LinkEndChild(elem);
-    val = StringUtils::Format("%u", rend);
+    val = StringUtils::Format("%u", proc);
     TiXmlText *text = new TiXmlText(val.c_str());
     elem->LinkEndChild(text);
 
+    elem = new TiXmlElement("rendertime");
+    xmlControl->LinkEndChild(elem);
+    val = StringUtils::Format("%u", rend);
+    text = new TiXmlText(val.c_str());
+    elem->LinkEndChild(text);
+
     elem = new TiXmlElement("visibletime");
     xmlControl->LinkEndChild(elem);
     val = StringUtils::Format("%u", vis);
@@ -266,6 +284,18 @@ void CGUIControlProfiler::EndVisibility(CGUIControl *pControl)
   item->EndVisibility();
 }
 
+void CGUIControlProfiler::BeginProcess(CGUIControl *pControl)
+{
+  CGUIControlProfilerItem *item = FindOrAddControl(pControl);
+  item->BeginProcess();
+}
+
+void CGUIControlProfiler::EndProcess(CGUIControl *pControl)
+{
+  CGUIControlProfilerItem *item = FindOrAddControl(pControl);
+  item->EndProcess();
+}
+
 void CGUIControlProfiler::BeginRender(CGUIControl *pControl)
 {
   CGUIControlProfilerItem *item = FindOrAddControl(pControl);
@@ -316,6 +346,7 @@ void CGUIControlProfiler::EndFrame(void)
     {
       CGUIControlProfilerItem *p = m_ItemHead.m_vecChildren[i];
       m_ItemHead.m_visTime += p->m_visTime;
+      m_ItemHead.m_processTime += p->m_processTime;
       m_ItemHead.m_renderTime += p->m_renderTime;
     }
 
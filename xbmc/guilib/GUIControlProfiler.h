@@ -40,8 +40,10 @@ public:
   int m_controlID;
   CGUIControl::GUICONTROLTYPES m_ControlType;
   unsigned int m_visTime;
+  unsigned int m_processTime;
   unsigned int m_renderTime;
   int64_t m_i64VisStart;
+  int64_t m_i64ProcessStart;
   int64_t m_i64RenderStart;
 
   CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl);
@@ -50,10 +52,12 @@ public:
   void Reset(CGUIControlProfiler *pProfiler);
   void BeginVisibility(void);
   void EndVisibility(void);
+  void BeginProcess(void);
+  void EndProcess(void);
   void BeginRender(void);
   void EndRender(void);
   void SaveToXML(TiXmlElement *parent);
-  unsigned int GetTotalTime(void) const { return m_visTime + m_renderTime; };
+  unsigned int GetTotalTime(void) const { return m_visTime + m_processTime + m_renderTime; };
 
   CGUIControlProfilerItem *AddControl(CGUIControl *pControl);
   CGUIControlProfilerItem *FindOrAddControl(CGUIControl *pControl, bool recurse);
@@ -69,6 +73,8 @@ public:
   void EndFrame(void);
   void BeginVisibility(CGUIControl *pControl);
   void EndVisibility(CGUIControl *pControl);
+  void BeginProcess(CGUIControl *pControl);
+  void EndProcess(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
@@ -97,6 +103,8 @@ private:
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
 #define GUIPROFILER_VISIBILITY_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndVisibility(x); }
+#define GUIPROFILER_PROCESS_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginProcess(x); }
+#define GUIPROFILER_PROCESS_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndProcess(x); }
 #define GUIPROFILER_RENDER_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginRender(x); }
 #define GUIPROFILER_RENDER_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndRender(x); }
 
@@ -399,6 +399,8 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
     m_originX = x;
     m_originY = y;
 
+    CacheCharacters(text.begin(), text.end());
+
     // Check if we will really need to truncate or justify the text
     if ( alignment & XBFONT_TRUNCATED )
     {
@@ -609,15 +611,11 @@ unsigned int CGUIFontTTFBase::GetTextureLineHeight() const
   return m_cellHeight + spacing_between_characters_in_texture;
 }
 
-CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
+CGUIFontTTFBase::Character* CGUIFontTTFBase::LookupCharacter(character_t chr, int &insertPos)
 {
   wchar_t letter = (wchar_t)(chr & 0xffff);
   character_t style = (chr & 0x7000000) >> 24;
 
-  // ignore linebreaks
-  if (letter == L'\r')
-    return NULL;
-
   // quick access to ascii chars
   if (letter < 255)
   {
@@ -641,12 +639,58 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
     else
       return &m_char[mid];
   }
+  insertPos = low;
+  return NULL;
+}
+
+void CGUIFontTTFBase::CacheCharacters(vecText::const_iterator start, vecText::const_iterator end)
+{
+  // characters can't be rendered to our texture during a Begin(), End() block. Rather than
+  // interrupting the block (and re-uploading the texture) for every glyph that isn't cached yet,
+  // interrupt it once and render all missing glyphs of the text in one go.
+  unsigned int nestedBeginCount = m_nestedBeginCount;
+  bool interrupted = false;
+  for (; start != end; ++start)
+  {
+    int low;
+    if ((*start & 0xffff) == L'\r' || LookupCharacter(*start, low))
+      continue;
+
+    if (!interrupted && nestedBeginCount)
+    {
+      m_nestedBeginCount = 1;
+      End();
+      interrupted = true;
+    }
+    GetCharacter(*start);
+  }
+  if (interrupted)
+  {
+    Begin();
+    m_nestedBeginCount = nestedBeginCount;
+  }
+}
+
+CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
+{
+  wchar_t letter = (wchar_t)(chr & 0xffff);
+  character_t style = (chr & 0x7000000) >> 24;
+
+  // ignore linebreaks
+  if (letter == L'\r')
+    return NULL;
+
+  int low = 0;
+  Character *cached = LookupCharacter(chr, low);
+  if (cached)
+    return cached;
   // if we get to here, then low is where we should insert the new character
 
   // increase the size of the buffer if we need it
   if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
+  { // need to increase the size of the buffer, geometrically so large (CJK) sets don't copy it over and over
+    int growBy = std::max(CHAR_CHUNK, m_maxChars / 2);
+    Character *newTable = new Character[m_maxChars + growBy];
     if (m_char)
     {
       memcpy(newTable, m_char, low * sizeof(Character));
@@ -654,7 +698,7 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
       delete[] m_char;
     }
     m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
+    m_maxChars += growBy;
 
   }
   else
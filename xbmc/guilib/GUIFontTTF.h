@@ -130,6 +130,8 @@ protected:
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
+  Character *LookupCharacter(character_t letter, int &insertPos);
+  void CacheCharacters(vecText::const_iterator start, vecText::const_iterator end);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
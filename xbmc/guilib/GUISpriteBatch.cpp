@@ -0,0 +1,82 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUISpriteBatch.h"
+#include "utils/TimeUtils.h"
+
+bool CGUISpriteBatch::State::operator==(const State &right) const
+{
+  return texture == right.texture &&
+         diffuse == right.diffuse &&
+         shader == right.shader &&
+         blend == right.blend &&
+         color == right.color;
+}
+
+CGUISpriteBatch::CGUISpriteBatch(SubmitFunc submit)
+  : m_submit(std::move(submit))
+{
+  m_perfScale = 1000.0f / CurrentHostFrequency();
+}
+
+void CGUISpriteBatch::Add(const State &state, const Vertex *quad)
+{
+  if (!m_vertices.empty() &&
+      (state != m_state || m_vertices.size() >= MAX_QUADS * 4))
+    Flush();
+
+  m_state = state;
+  m_vertices.insert(m_vertices.end(), quad, quad + 4);
+
+  // the index pattern only depends on the quad number, so it is built once and reused
+  if (m_vertices.size() / 4 > m_indices.size() / 6)
+  {
+    uint16_t i = static_cast<uint16_t>(m_vertices.size() - 4);
+    m_indices.push_back(i+0);
+    m_indices.push_back(i+1);
+    m_indices.push_back(i+2);
+    m_indices.push_back(i+2);
+    m_indices.push_back(i+3);
+    m_indices.push_back(i+0);
+  }
+}
+
+void CGUISpriteBatch::Flush()
+{
+  if (m_vertices.empty() || m_flushing)
+    return;
+
+  m_flushing = true;
+  unsigned int quads = m_vertices.size() / 4;
+  int64_t start = CurrentHostCounter();
+  m_submit(m_state, m_vertices.data(), m_indices.data(), quads);
+  m_frame.submitTime += m_perfScale * (CurrentHostCounter() - start);
+  m_frame.drawCalls++;
+  m_frame.quads += quads;
+  m_vertices.clear();
+  m_flushing = false;
+}
+
+void CGUISpriteBatch::EndFrame()
+{
+  Flush();
+  m_lastFrame = m_frame;
+  m_frame = Stats();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Collects textured GUI quads across controls and submits them in as few draw calls as possible.
+
+ Consecutive quads that share the same render state (textures, shader, blending and color) are
+ merged into a single indexed draw. The batch is submitted whenever the state changes, when the
+ index range is exhausted, or when Flush() is called because some other piece of code is about to
+ touch the GPU state (shaders, scissors, transforms, ...). Quads are never reordered, so the
+ painter's order of the GUI is preserved.
+
+ The batch itself does not talk to the GPU; the backend supplies a submit callback.
+ */
+class CGUISpriteBatch
+{
+public:
+  struct Vertex
+  {
+    float x, y, z;
+    float u1, v1;
+    float u2, v2;
+  };
+
+  struct State
+  {
+    unsigned int texture = 0; ///< backend texture object bound to unit 0
+    unsigned int diffuse = 0; ///< backend texture object bound to unit 1, 0 if there is no diffuse texture
+    int shader = 0;
+    bool blend = false;
+    uint32_t color = 0;
+
+    bool operator==(const State &right) const;
+    bool operator!=(const State &right) const { return !(*this == right); }
+  };
+
+  struct Stats
+  {
+    unsigned int drawCalls = 0;
+    unsigned int quads = 0;
+    float submitTime = 0.0f; ///< time spent in the submit callback, in milliseconds
+  };
+
+  /*! \brief Submit callback, called with the state and the quads to draw.
+   The index buffer holds two triangles per quad and is valid for the given number of quads.
+   */
+  typedef std::function<void(const State &state, const Vertex *vertices, const uint16_t *indices, unsigned int quads)> SubmitFunc;
+
+  explicit CGUISpriteBatch(SubmitFunc submit);
+
+  /*! \brief Queue a quad of 4 vertices (top left, top right, bottom right, bottom left)
+   Pending quads are submitted first if they cannot be merged with this one.
+   */
+  void Add(const State &state, const Vertex *quad);
+
+  /*! \brief Submit all pending quads. Reentrant calls made from within the submit callback are ignored.
+   */
+  void Flush();
+
+  /*! \brief Submit all pending quads and latch the statistics of the frame that just ended.
+   */
+  void EndFrame();
+
+  bool IsEmpty() const { return m_vertices.empty(); }
+  const Stats& GetFrameStats() const { return m_lastFrame; }
+
+  static const unsigned int MAX_QUADS = 16384; ///< quads addressable by 16 bit indices
+
+private:
+  SubmitFunc m_submit;
+  State m_state;
+  std::vector<Vertex> m_vertices;
+  std::vector<uint16_t> m_indices;
+  bool m_flushing = false;
+
+  Stats m_frame;
+  Stats m_lastFrame;
+  float m_perfScale;
+};
@@ -136,6 +136,12 @@ void CGUITextureD3D::Draw(float *x, float *y, float *z, const CRect &texture, co
   pGUIShader->DrawQuad(verts[0], verts[1], verts[2], verts[3]);
 }
 
+const CGUISpriteBatch::Stats& CGUITextureD3D::GetBatchStats()
+{
+  static CGUISpriteBatch::Stats stats;
+  return stats;
+}
+
 void CGUITextureD3D::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
   unsigned numViews = 0;
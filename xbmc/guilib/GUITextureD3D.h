@@ -29,6 +29,7 @@
  */
 
 #include "GUITexture.h"
+#include "GUISpriteBatch.h"
 
 class CGUITextureD3D : public CGUITextureBase
 {
@@ -37,6 +38,11 @@ public:
   ~CGUITextureD3D();
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
 
+  // textures are drawn immediately, there is nothing to batch
+  static void FlushBatch() {}
+  static void EndBatchFrame() {}
+  static const CGUISpriteBatch::Stats& GetBatchStats();
+
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
@@ -32,10 +32,30 @@
 CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo &texture)
 : CGUITextureBase(posX, posY, width, height, texture)
 {
-  memset(m_col, 0, sizeof(m_col));
   m_renderSystem = dynamic_cast<CRenderSystemGL*>(&CServiceBroker::GetRenderSystem());
 }
 
+CGUISpriteBatch& CGUITextureGL::GetBatch()
+{
+  static CGUISpriteBatch batch(SubmitBatch);
+  return batch;
+}
+
+void CGUITextureGL::FlushBatch()
+{
+  GetBatch().Flush();
+}
+
+void CGUITextureGL::EndBatchFrame()
+{
+  GetBatch().EndFrame();
+}
+
+const CGUISpriteBatch::Stats& CGUITextureGL::GetBatchStats()
+{
+  return GetBatch().GetFrameStats();
+}
+
 void CGUITextureGL::Begin(color_t color)
 {
   CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
@@ -43,51 +63,59 @@ void CGUITextureGL::Begin(color_t color)
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(0);
-
   // Setup Colors
-  m_col[0] = (GLubyte)GET_R(color);
-  m_col[1] = (GLubyte)GET_G(color);
-  m_col[2] = (GLubyte)GET_B(color);
-  m_col[3] = (GLubyte)GET_A(color);
+  GLubyte col[4];
+  col[0] = (GLubyte)GET_R(color);
+  col[1] = (GLubyte)GET_G(color);
+  col[2] = (GLubyte)GET_B(color);
+  col[3] = (GLubyte)GET_A(color);
 
   if (CServiceBroker::GetWinSystem().UseLimitedColor())
   {
-    m_col[0] = (235 - 16) * m_col[0] / 255 + 16.0f / 255.0f;
-    m_col[1] = (235 - 16) * m_col[1] / 255 + 16.0f / 255.0f;
-    m_col[2] = (235 - 16) * m_col[2] / 255 + 16.0f / 255.0f;
+    col[0] = (235 - 16) * col[0] / 255 + 16.0f / 255.0f;
+    col[1] = (235 - 16) * col[1] / 255 + 16.0f / 255.0f;
+    col[2] = (235 - 16) * col[2] / 255 + 16.0f / 255.0f;
   }
 
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
+  bool hasAlpha = texture->HasAlpha() || col[3] < 255;
+  bool opaqueColor = col[0] == 255 && col[1] == 255 && col[2] == 255 && col[3] == 255;
 
+  // the quads are only queued here, the shader and textures are set up when the batch is submitted
+  m_batchState.texture = static_cast<CGLTexture*>(texture)->GetTextureObject();
+  m_batchState.color = (col[3] << 24) | (col[0] << 16) | (col[1] << 8) | col[2];
   if (m_diffuse.size())
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
-    {
-      m_renderSystem->EnableShader(SM_MULTI);
-    }
-    else
-    {
-      m_renderSystem->EnableShader(SM_MULTI_BLENDCOLOR);
-    }
-
+    m_batchState.shader = opaqueColor ? SM_MULTI : SM_MULTI_BLENDCOLOR;
+    m_batchState.diffuse = static_cast<CGLTexture*>(m_diffuse.m_textures[0])->GetTextureObject();
     hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
-
-    m_diffuse.m_textures[0]->BindToUnit(1);
   }
   else
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
-    {
-      m_renderSystem->EnableShader(SM_TEXTURE_NOBLEND);
-    }
-    else
-    {
-      m_renderSystem->EnableShader(SM_TEXTURE);
-    }
+    m_batchState.shader = opaqueColor ? SM_TEXTURE_NOBLEND : SM_TEXTURE;
+    m_batchState.diffuse = 0;
   }
+  m_batchState.blend = hasAlpha;
+}
 
-  if (hasAlpha)
+void CGUITextureGL::SubmitBatch(const CGUISpriteBatch::State &state, const CGUISpriteBatch::Vertex *vertices, const uint16_t *indices, unsigned int quads)
+{
+  typedef CGUISpriteBatch::Vertex PackedVertex;
+  CRenderSystemGL *renderSystem = dynamic_cast<CRenderSystemGL*>(&CServiceBroker::GetRenderSystem());
+
+  // the batch is usually flushed by code that is about to draw something itself and
+  // may already have bound its textures and set up blending through the render system,
+  // which are restored from the state it tracks once the batch is drawn
+  if (state.diffuse)
+  {
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, state.diffuse);
+  }
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, state.texture);
+
+  renderSystem->EnableShader(static_cast<ESHADERMETHOD>(state.shader));
+
+  if (state.blend)
   {
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
     glEnable(GL_BLEND);
@@ -96,70 +124,60 @@ void CGUITextureGL::Begin(color_t color)
   {
     glDisable(GL_BLEND);
   }
-  m_packedVertices.clear();
-  m_idx.clear();
-}
 
-void CGUITextureGL::End()
-{
-  if (m_packedVertices.size())
-  {
-    GLint posLoc  = m_renderSystem->ShaderGetPos();
-    GLint tex0Loc = m_renderSystem->ShaderGetCoord0();
-    GLint tex1Loc = m_renderSystem->ShaderGetCoord1();
-    GLint uniColLoc = m_renderSystem->ShaderGetUniCol();
+  GLint posLoc  = renderSystem->ShaderGetPos();
+  GLint tex0Loc = renderSystem->ShaderGetCoord0();
+  GLint tex1Loc = renderSystem->ShaderGetCoord1();
+  GLint uniColLoc = renderSystem->ShaderGetUniCol();
 
-    GLuint VertexVBO;
-    GLuint IndexVBO;
+  GLuint VertexVBO;
+  GLuint IndexVBO;
 
-    glGenBuffers(1, &VertexVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex)*m_packedVertices.size(), &m_packedVertices[0], GL_STATIC_DRAW);
+  glGenBuffers(1, &VertexVBO);
+  glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex)*quads*4, vertices, GL_STATIC_DRAW);
 
-    if (uniColLoc >= 0)
-    {
-      glUniform4f(uniColLoc,(m_col[0] / 255.0f), (m_col[1] / 255.0f), (m_col[2] / 255.0f), (m_col[3] / 255.0f));
-    }
+  if (uniColLoc >= 0)
+  {
+    glUniform4f(uniColLoc, (GET_R(state.color) / 255.0f), (GET_G(state.color) / 255.0f), (GET_B(state.color) / 255.0f), (GET_A(state.color) / 255.0f));
+  }
 
-    if (m_diffuse.size())
-    {
-      glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u2)));
-      glEnableVertexAttribArray(tex1Loc);
-    }
+  if (state.diffuse)
+  {
+    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u2)));
+    glEnableVertexAttribArray(tex1Loc);
+  }
 
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, x)));
-    glEnableVertexAttribArray(posLoc);
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u1)));
-    glEnableVertexAttribArray(tex0Loc);
+  glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, x)));
+  glEnableVertexAttribArray(posLoc);
+  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u1)));
+  glEnableVertexAttribArray(tex0Loc);
 
-    glGenBuffers(1, &IndexVBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexVBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort)*m_idx.size(), m_idx.data(), GL_STATIC_DRAW);
+  glGenBuffers(1, &IndexVBO);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexVBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16_t)*quads*6, indices, GL_STATIC_DRAW);
 
-    glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, 0);
+  glDrawElements(GL_TRIANGLES, quads*6, GL_UNSIGNED_SHORT, 0);
 
-    if (m_diffuse.size())
-      glDisableVertexAttribArray(tex1Loc);
+  if (state.diffuse)
+    glDisableVertexAttribArray(tex1Loc);
 
-    glDisableVertexAttribArray(posLoc);
-    glDisableVertexAttribArray(tex0Loc);
+  glDisableVertexAttribArray(posLoc);
+  glDisableVertexAttribArray(tex0Loc);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glDeleteBuffers(1, &VertexVBO);
-    glDeleteBuffers(1, &IndexVBO);
-  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  glDeleteBuffers(1, &VertexVBO);
+  glDeleteBuffers(1, &IndexVBO);
 
-  if (m_diffuse.size())
-    glActiveTexture(GL_TEXTURE0);
-  glEnable(GL_BLEND);
+  renderSystem->DisableShader();
 
-  m_renderSystem->DisableShader();
+  renderSystem->RestoreTrackedState();
 }
 
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
-  PackedVertex vertices[4];
+  CGUISpriteBatch::Vertex vertices[4] = {};
 
   // Setup texture coordinates
   // TopLeft
@@ -234,32 +252,22 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
     vertices[i].x = x[i];
     vertices[i].y = y[i];
     vertices[i].z = z[i];
-    m_packedVertices.push_back(vertices[i]);
   }
 
-  if ((m_packedVertices.size() / 4) > (m_idx.size() / 6))
-  {
-    size_t i = m_packedVertices.size() - 4;
-    m_idx.push_back(i+0);
-    m_idx.push_back(i+1);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+3);
-    m_idx.push_back(i+0);
-  }
+  GetBatch().Add(m_batchState, vertices);
 }
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
   CRenderSystemGL *renderSystem = dynamic_cast<CRenderSystemGL*>(&CServiceBroker::GetRenderSystem());
+  FlushBatch();
   if (texture)
   {
     texture->LoadToGPU();
     texture->BindToUnit(0);
   }
 
-  glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-  glEnable(GL_BLEND);          // Turn Blending On
+  renderSystem->SetBlend(true);
 
   VerifyGLState();
 
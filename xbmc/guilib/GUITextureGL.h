@@ -23,6 +23,7 @@
 #include "system_gl.h"
 
 #include "GUITexture.h"
+#include "GUISpriteBatch.h"
 
 class CRenderSystemGL;
 
@@ -32,23 +33,22 @@ public:
   CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
 
+  /*! \brief Submit the quads queued by all GUI textures so far.
+   Must be called before anything else changes GL state the pending quads depend on.
+   */
+  static void FlushBatch();
+  static void EndBatchFrame();
+  static const CGUISpriteBatch::Stats& GetBatchStats();
+
 protected:
   void Begin(color_t color) override;
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation) override;
-  void End() override;
 
 private:
-  GLubyte m_col[4];
-
-  struct PackedVertex
-  {
-    float x, y, z;
-    float u1, v1;
-    float u2, v2;
-  };
+  static CGUISpriteBatch& GetBatch();
+  static void SubmitBatch(const CGUISpriteBatch::State &state, const CGUISpriteBatch::Vertex *vertices, const uint16_t *indices, unsigned int quads);
 
-  std::vector<PackedVertex> m_packedVertices;
-  std::vector<GLushort> m_idx;
+  CGUISpriteBatch::State m_batchState;
   CRenderSystemGL *m_renderSystem;
 };
 
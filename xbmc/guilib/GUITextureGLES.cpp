@@ -36,6 +36,27 @@ CGUITextureGLES::CGUITextureGLES(float posX, float posY, float width, float heig
   m_renderSystem = dynamic_cast<CRenderSystemGLES*>(&CServiceBroker::GetRenderSystem());
 }
 
+CGUISpriteBatch& CGUITextureGLES::GetBatch()
+{
+  static CGUISpriteBatch batch(SubmitBatch);
+  return batch;
+}
+
+void CGUITextureGLES::FlushBatch()
+{
+  GetBatch().Flush();
+}
+
+void CGUITextureGLES::EndBatchFrame()
+{
+  GetBatch().EndFrame();
+}
+
+const CGUISpriteBatch::Stats& CGUITextureGLES::GetBatchStats()
+{
+  return GetBatch().GetFrameStats();
+}
+
 void CGUITextureGLES::Begin(color_t color)
 {
   CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
@@ -43,98 +64,90 @@ void CGUITextureGLES::Begin(color_t color)
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(0);
-
-  // Setup Colors
-  m_col[0] = (GLubyte)GET_R(color);
-  m_col[1] = (GLubyte)GET_G(color);
-  m_col[2] = (GLubyte)GET_B(color);
-  m_col[3] = (GLubyte)GET_A(color);
-
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
+  bool hasAlpha = texture->HasAlpha() || GET_A(color) < 255;
+  bool opaqueColor = color == 0xffffffff;
 
+  // the quads are only queued here, the shader and textures are set up when the batch is submitted
+  m_batchState.texture = static_cast<CGLTexture*>(texture)->GetTextureObject();
+  m_batchState.color = color;
   if (m_diffuse.size())
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
-    {
-      m_renderSystem->EnableGUIShader(SM_MULTI);
-    }
-    else
-    {
-      m_renderSystem->EnableGUIShader(SM_MULTI_BLENDCOLOR);
-    }
-
+    m_batchState.shader = opaqueColor ? SM_MULTI : SM_MULTI_BLENDCOLOR;
+    m_batchState.diffuse = static_cast<CGLTexture*>(m_diffuse.m_textures[0])->GetTextureObject();
     hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
-
-    m_diffuse.m_textures[0]->BindToUnit(1);
-
   }
   else
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
-    {
-      m_renderSystem->EnableGUIShader(SM_TEXTURE_NOBLEND);
-    }
-    else
-    {
-      m_renderSystem->EnableGUIShader(SM_TEXTURE);
-    }
+    m_batchState.shader = opaqueColor ? SM_TEXTURE_NOBLEND : SM_TEXTURE;
+    m_batchState.diffuse = 0;
   }
+  m_batchState.blend = hasAlpha;
+}
+
+void CGUITextureGLES::SubmitBatch(const CGUISpriteBatch::State &state, const CGUISpriteBatch::Vertex *vertices, const uint16_t *indices, unsigned int quads)
+{
+  typedef CGUISpriteBatch::Vertex PackedVertex;
+  CRenderSystemGLES *renderSystem = dynamic_cast<CRenderSystemGLES*>(&CServiceBroker::GetRenderSystem());
+
+  // the batch is usually flushed by code that is about to draw something itself and
+  // may already have bound its textures and set up blending through the render system,
+  // which are restored from the state it tracks once the batch is drawn
+  if (state.diffuse)
+  {
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, state.diffuse);
+  }
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, state.texture);
 
-  if ( hasAlpha )
+  renderSystem->EnableGUIShader(static_cast<ESHADERMETHOD>(state.shader));
+
+  if (state.blend)
   {
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
-    glEnable( GL_BLEND );
+    glEnable(GL_BLEND);
   }
   else
   {
     glDisable(GL_BLEND);
   }
-  m_packedVertices.clear();
-}
 
-void CGUITextureGLES::End()
-{
-  if (m_packedVertices.size())
+  GLint posLoc  = renderSystem->GUIShaderGetPos();
+  GLint tex0Loc = renderSystem->GUIShaderGetCoord0();
+  GLint tex1Loc = renderSystem->GUIShaderGetCoord1();
+  GLint uniColLoc = renderSystem->GUIShaderGetUniCol();
+
+  if(uniColLoc >= 0)
   {
-    GLint posLoc  = m_renderSystem->GUIShaderGetPos();
-    GLint tex0Loc = m_renderSystem->GUIShaderGetCoord0();
-    GLint tex1Loc = m_renderSystem->GUIShaderGetCoord1();
-    GLint uniColLoc = m_renderSystem->GUIShaderGetUniCol();
+    glUniform4f(uniColLoc, (GET_R(state.color) / 255.0f), (GET_G(state.color) / 255.0f), (GET_B(state.color) / 255.0f), (GET_A(state.color) / 255.0f));
+  }
 
-    if(uniColLoc >= 0)
-    {
-      glUniform4f(uniColLoc,(m_col[0] / 255.0f), (m_col[1] / 255.0f), (m_col[2] / 255.0f), (m_col[3] / 255.0f));
-    }
+  if(state.diffuse)
+  {
+    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (const char*)vertices + offsetof(PackedVertex, u2));
+    glEnableVertexAttribArray(tex1Loc);
+  }
+  glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), (const char*)vertices + offsetof(PackedVertex, x));
+  glEnableVertexAttribArray(posLoc);
+  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (const char*)vertices + offsetof(PackedVertex, u1));
+  glEnableVertexAttribArray(tex0Loc);
 
-    if(m_diffuse.size())
-    {
-      glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u2));
-      glEnableVertexAttribArray(tex1Loc);
-    }
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, x));
-    glEnableVertexAttribArray(posLoc);
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u1));
-    glEnableVertexAttribArray(tex0Loc);
+  glDrawElements(GL_TRIANGLES, quads*6, GL_UNSIGNED_SHORT, indices);
 
-    glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_idx.data());
+  if (state.diffuse)
+    glDisableVertexAttribArray(tex1Loc);
 
-    if (m_diffuse.size())
-      glDisableVertexAttribArray(tex1Loc);
+  glDisableVertexAttribArray(posLoc);
+  glDisableVertexAttribArray(tex0Loc);
 
-    glDisableVertexAttribArray(posLoc);
-    glDisableVertexAttribArray(tex0Loc);
-  }
+  renderSystem->DisableGUIShader();
 
-  if (m_diffuse.size())
-    glActiveTexture(GL_TEXTURE0);
-  glEnable(GL_BLEND);
-  m_renderSystem->DisableGUIShader();
+  renderSystem->RestoreTrackedState();
 }
 
 void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
-  PackedVertex vertices[4];
+  CGUISpriteBatch::Vertex vertices[4] = {};
 
   // Setup texture coordinates
   //TopLeft
@@ -203,32 +216,22 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
     vertices[i].x = x[i];
     vertices[i].y = y[i];
     vertices[i].z = z[i];
-    m_packedVertices.push_back(vertices[i]);
   }
 
-  if ((m_packedVertices.size() / 4) > (m_idx.size() / 6))
-  {
-    size_t i = m_packedVertices.size() - 4;
-    m_idx.push_back(i+0);
-    m_idx.push_back(i+1);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+3);
-    m_idx.push_back(i+0);
-  }
+  GetBatch().Add(m_batchState, vertices);
 }
 
 void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
   CRenderSystemGLES *renderSystem = dynamic_cast<CRenderSystemGLES*>(&CServiceBroker::GetRenderSystem());
+  FlushBatch();
   if (texture)
   {
     texture->LoadToGPU();
     texture->BindToUnit(0);
   }
 
-  glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-  glEnable(GL_BLEND);          // Turn Blending On
+  renderSystem->SetBlend(true);
 
   VerifyGLState();
 
@@ -21,17 +21,9 @@
  */
 
 #include "GUITexture.h"
+#include "GUISpriteBatch.h"
 
 #include "system_gl.h"
-#include <vector>
-
-struct PackedVertex
-{
-  float x, y, z;
-  float u1, v1;
-  float u2, v2;
-};
-typedef std::vector<PackedVertex> PackedVertices;
 
 class CRenderSystemGLES;
 
@@ -40,15 +32,21 @@ class CGUITextureGLES : public CGUITextureBase
 public:
   CGUITextureGLES(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+
+  /*! \brief Submit the quads queued by all GUI textures so far.
+   Must be called before anything else changes GL state the pending quads depend on.
+   */
+  static void FlushBatch();
+  static void EndBatchFrame();
+  static const CGUISpriteBatch::Stats& GetBatchStats();
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
-  void End();
 
-  GLubyte m_col[4];
+  static CGUISpriteBatch& GetBatch();
+  static void SubmitBatch(const CGUISpriteBatch::State &state, const CGUISpriteBatch::Vertex *vertices, const uint16_t *indices, unsigned int quads);
 
-  PackedVertices m_packedVertices;
-  std::vector<GLushort> m_idx;
+  CGUISpriteBatch::State m_batchState;
   CRenderSystemGLES *m_renderSystem;
 };
 
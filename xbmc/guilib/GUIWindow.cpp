@@ -24,7 +24,6 @@
 #include "input/Key.h"
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
-#include "GUIControlProfiler.h"
 
 #include "addons/Skin.h"
 #include "GUIInfoManager.h"
@@ -363,8 +362,6 @@ void CGUIWindow::DoRender()
   g_graphicsContext.AddGUITransform();
   CGUIControlGroup::DoRender();
   g_graphicsContext.RemoveTransform();
-
-  if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndFrame();
 }
 
 void CGUIWindow::AfterRender()
@@ -21,6 +21,7 @@
 #include "GUIWindowManager.h"
 #include "GUIAudioManager.h"
 #include "GUIDialog.h"
+#include "GUIControlProfiler.h"
 #include "Application.h"
 #include "messaging/ApplicationMessenger.h"
 #include "messaging/helpers/DialogHelper.h"
@@ -1127,6 +1128,11 @@ void CGUIWindowManager::Process(unsigned int currentTime)
 
   for (CDirtyRegionList::iterator itr = m_dirtyregions.begin(); itr != m_dirtyregions.end(); ++itr)
     m_tracker.MarkDirtyRegion(*itr);
+
+  // every frame is processed, but only dirty ones get rendered, so frames
+  // are counted here rather than per rendered window
+  if (CGUIControlProfiler::IsRunning())
+    CGUIControlProfiler::Instance().EndFrame();
 }
 
 void CGUIWindowManager::MarkDirty()
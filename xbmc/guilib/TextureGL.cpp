@@ -21,9 +21,15 @@
 #include "ServiceBroker.h"
 #include "Texture.h"
 #include "rendering/RenderSystem.h"
+#if defined(HAS_GL)
+#include "rendering/gl/RenderSystemGL.h"
+#elif defined(HAS_GLES)
+#include "rendering/gles/RenderSystemGLES.h"
+#endif
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "guilib/TextureManager.h"
+#include "guilib/GUITexture.h"
 #include "settings/AdvancedSettings.h"
 #ifdef TARGET_POSIX
 #include "platform/linux/XMemUtils.h"
@@ -65,6 +71,9 @@ void CGLTexture::LoadToGPU()
     // nothing to load - probably same image (no change)
     return;
   }
+  // queued GUI quads may still sample the previous contents
+  if (m_texture != 0)
+    CGUITexture::FlushBatch();
   if (m_texture == 0)
   {
     // Have OpenGL generate a texture object handle for us
@@ -224,7 +233,10 @@ void CGLTexture::LoadToGPU()
 
 void CGLTexture::BindToUnit(unsigned int unit)
 {
-  glActiveTexture(GL_TEXTURE0 + unit);
-  glBindTexture(GL_TEXTURE_2D, m_texture);
+#if defined(HAS_GL)
+  dynamic_cast<CRenderSystemGL&>(CServiceBroker::GetRenderSystem()).BindTexture(unit, m_texture);
+#else
+  dynamic_cast<CRenderSystemGLES&>(CServiceBroker::GetRenderSystem()).BindTexture(unit, m_texture);
+#endif
 }
 
@@ -26,6 +26,7 @@
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "GraphicContext.h"
+#include "GUITexture.h"
 #include "Texture.h"
 #include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
@@ -37,10 +38,15 @@
 #ifdef _DEBUG_TEXTURES
 #include "utils/TimeUtils.h"
 #endif
-#if defined(TARGET_DARWIN_IOS)
 #include "ServiceBroker.h"
+#if defined(TARGET_DARWIN_IOS)
 #include "windowing/osx/WinSystemIOS.h" // for g_Windowing in CGUITextureManager::FreeUnusedTextures
 #endif
+#if defined(HAS_GL)
+#include "rendering/gl/RenderSystemGL.h"
+#elif defined(HAS_GLES)
+#include "rendering/gles/RenderSystemGLES.h"
+#endif
 #include "FFmpegImage.h"
 
 /************************************************************************/
@@ -511,8 +517,15 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
   }
 
 #if defined(HAS_GL) || defined(HAS_GLES)
+  if (!m_unusedHwTextures.empty())
+    CGUITexture::FlushBatch();
   for (unsigned int i = 0; i < m_unusedHwTextures.size(); ++i)
   {
+#if defined(HAS_GL)
+    dynamic_cast<CRenderSystemGL&>(CServiceBroker::GetRenderSystem()).ForgetTexture(m_unusedHwTextures[i]);
+#else
+    dynamic_cast<CRenderSystemGLES&>(CServiceBroker::GetRenderSystem()).ForgetTexture(m_unusedHwTextures[i]);
+#endif
   // on ios the hw textures might be deleted from the os
   // when XBMC is backgrounded (e.x. for backgrounded music playback)
   // sanity check before delete in that case.
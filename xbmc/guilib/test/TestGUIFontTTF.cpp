@@ -0,0 +1,245 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "Application.h"
+#include "ServiceManager.h"
+#include "guilib/GUIFontTTF.h"
+#include "guilib/Texture.h"
+#include "guilib/TextureFormats.h"
+#include "rendering/RenderSystem.h"
+#include "test/TestUtils.h"
+#include "windowing/WinSystem.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+
+namespace
+{
+// the skins don't bundle a CJK font, this is the one with the most glyphs
+const char* TEST_FONT = "/addons/skin.estuary/fonts/NotoSans-Regular.ttf";
+
+/*!
+ \brief Render system without a GPU, only answers the queries textures make on allocation.
+ */
+class CTestRenderSystem : public CRenderSystemBase
+{
+public:
+  CTestRenderSystem() { m_maxTextureSize = 8192; }
+
+  bool InitRenderSystem() override { return true; }
+  bool DestroyRenderSystem() override { return true; }
+  bool ResetRenderSystem(int width, int height) override { return true; }
+  bool BeginRender() override { return true; }
+  bool EndRender() override { return true; }
+  void PresentRender(bool rendered, bool videoLayer) override {}
+  bool ClearBuffers(color_t color) override { return true; }
+  bool IsExtSupported(const char* extension) const override { return false; }
+  void SetViewPort(const CRect& viewPort) override {}
+  void GetViewPort(CRect& viewPort) override {}
+  void SetScissors(const CRect &rect) override {}
+  void ResetScissors() override {}
+  void CaptureStateBlock() override {}
+  void ApplyStateBlock() override {}
+  void SetCameraPosition(const CPoint &camera, int screenWidth, int screenHeight, float stereoFactor = 0.f) override {}
+  void ApplyHardwareTransform(const TransformMatrix &matrix) override {}
+  void RestoreHardwareTransform() override {}
+  bool TestRender() override { return true; }
+};
+
+class CTestWinSystem : public CWinSystemBase
+{
+public:
+  CRenderSystemBase* GetRenderSystem() override { return &m_renderSystem; }
+
+  bool CreateNewWindow(const std::string& name, bool fullScreen, RESOLUTION_INFO& res) override { return false; }
+  bool ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop) override { return false; }
+  bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays) override { return false; }
+  void Register(IDispResource *resource) override {}
+  void Unregister(IDispResource *resource) override {}
+
+private:
+  CTestRenderSystem m_renderSystem;
+};
+
+class CTestFontTexture : public CBaseTexture
+{
+public:
+  CTestFontTexture(unsigned int width, unsigned int height)
+    : CBaseTexture(width, height, XB_FMT_A8)
+  {
+  }
+
+  void CreateTextureObject() override {}
+  void DestroyTextureObject() override {}
+  void LoadToGPU() override {}
+  void BindToUnit(unsigned int unit) override {}
+};
+
+/*!
+ \brief Font that keeps its glyph texture in memory only and counts the
+ Begin()/End() blocks that reach the renderer.
+ */
+class CTestFontTTF : public CGUIFontTTFBase
+{
+public:
+  CTestFontTTF() : CGUIFontTTFBase("test") {}
+
+  ~CTestFontTTF() override
+  {
+    m_dynamicCache.Flush();
+  }
+
+  void Cache(const vecText &text) { CacheCharacters(text.begin(), text.end()); }
+
+  //! every character of the basic multilingual plane the font has a glyph for
+  vecText GetAllCharacters() const
+  {
+    vecText text;
+    for (character_t letter = 0x21; letter < 0xfffe; letter++)
+    {
+      if (FT_Get_Char_Index(m_face, letter))
+        text.push_back(letter);
+    }
+    return text;
+  }
+
+  int GetCachedCount() const { return m_numChars; }
+
+  unsigned int m_firstBegins = 0;
+  unsigned int m_lastEnds = 0;
+
+protected:
+  CBaseTexture* ReallocTexture(unsigned int& newHeight) override
+  {
+    newHeight = CBaseTexture::PadPow2(newHeight);
+    CBaseTexture* texture = new CTestFontTexture(m_textureWidth, newHeight);
+    m_textureHeight = texture->GetHeight();
+    m_textureScaleY = 1.0f / m_textureHeight;
+    m_textureWidth = texture->GetWidth();
+    m_textureScaleX = 1.0f / m_textureWidth;
+
+    memset(texture->GetPixels(), 0, m_textureHeight * texture->GetPitch());
+    if (m_texture)
+    {
+      for (unsigned int y = 0; y < m_texture->GetHeight(); y++)
+        memcpy(texture->GetPixels() + y * texture->GetPitch(),
+               m_texture->GetPixels() + y * m_texture->GetPitch(), m_texture->GetPitch());
+      delete m_texture;
+    }
+    return texture;
+  }
+
+  bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override
+  {
+    const unsigned char* source = bitGlyph->bitmap.buffer;
+    unsigned char* target = m_texture->GetPixels() + y1 * m_texture->GetPitch() + x1;
+    for (unsigned int y = y1; y < y2; y++)
+    {
+      memcpy(target, source, x2 - x1);
+      source += bitGlyph->bitmap.width;
+      target += m_texture->GetPitch();
+    }
+    return true;
+  }
+
+  void DeleteHardwareTexture() override {}
+
+private:
+  bool FirstBegin() override
+  {
+    m_firstBegins++;
+    return true;
+  }
+  void LastEnd() override { m_lastEnds++; }
+};
+
+class TestGUIFontTTF : public testing::Test
+{
+protected:
+  TestGUIFontTTF()
+  {
+    g_application.m_ServiceManager->SetWinSystem(std::unique_ptr<CWinSystemBase>(new CTestWinSystem));
+  }
+
+  ~TestGUIFontTTF() override
+  {
+    g_application.m_ServiceManager->SetWinSystem(nullptr);
+  }
+};
+}
+
+TEST_F(TestGUIFontTTF, CacheCharactersInterruptsBlockOnce)
+{
+  CTestFontTTF font;
+  ASSERT_TRUE(font.Load(XBMC_REF_FILE_PATH(TEST_FONT), 30.0f));
+
+  vecText text = font.GetAllCharacters();
+  ASSERT_GT(text.size(), 100u);
+  text.resize(100);
+
+  font.Begin();
+  EXPECT_EQ(1u, font.m_firstBegins);
+
+  // glyphs are written to the texture outside of the block, but only once for all of them
+  font.Cache(text);
+  EXPECT_EQ(2u, font.m_firstBegins);
+  EXPECT_EQ(1u, font.m_lastEnds);
+  EXPECT_LE(100, font.GetCachedCount());
+
+  // cached glyphs don't interrupt the block at all
+  font.Cache(text);
+  EXPECT_EQ(2u, font.m_firstBegins);
+  EXPECT_EQ(1u, font.m_lastEnds);
+
+  font.End();
+  EXPECT_EQ(2u, font.m_lastEnds);
+}
+
+TEST_F(TestGUIFontTTF, DISABLED_CacheCharactersBenchmark)
+{
+  // first display of text made of glyphs that aren't cached yet, e.g. a CJK
+  // label, rasterizing every glyph of the font as a worst case
+  const int runs = 5;
+  double elapsed = 0;
+  size_t glyphs = 0;
+  for (int i = 0; i < runs; i++)
+  {
+    CTestFontTTF font;
+    ASSERT_TRUE(font.Load(XBMC_REF_FILE_PATH(TEST_FONT), 30.0f));
+    vecText text = font.GetAllCharacters();
+    glyphs = text.size();
+
+    auto start = std::chrono::steady_clock::now();
+    font.Begin();
+    font.Cache(text);
+    font.End();
+    elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  std::cout << glyphs << " glyphs: " << elapsed * 1000 / runs << " ms, "
+            << glyphs * runs / elapsed << " glyphs/s" << std::endl;
+}
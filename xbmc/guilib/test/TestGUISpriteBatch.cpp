@@ -0,0 +1,144 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "guilib/GUISpriteBatch.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+struct Submission
+{
+  CGUISpriteBatch::State state;
+  std::vector<CGUISpriteBatch::Vertex> vertices;
+  std::vector<uint16_t> indices;
+};
+
+class TestGUISpriteBatch : public testing::Test
+{
+protected:
+  TestGUISpriteBatch()
+    : batch([this](const CGUISpriteBatch::State &state, const CGUISpriteBatch::Vertex *vertices,
+                   const uint16_t *indices, unsigned int quads)
+            {
+              Submission submission;
+              submission.state = state;
+              submission.vertices.assign(vertices, vertices + quads * 4);
+              submission.indices.assign(indices, indices + quads * 6);
+              submissions.push_back(submission);
+              if (reenter)
+                batch.Flush();
+            })
+  {
+  }
+
+  void AddQuad(const CGUISpriteBatch::State &state, float x)
+  {
+    CGUISpriteBatch::Vertex quad[4] = {};
+    for (int i = 0; i < 4; i++)
+      quad[i].x = x;
+    batch.Add(state, quad);
+  }
+
+  static CGUISpriteBatch::State MakeState(unsigned int texture, uint32_t color = 0xffffffff)
+  {
+    CGUISpriteBatch::State state;
+    state.texture = texture;
+    state.color = color;
+    return state;
+  }
+
+  std::vector<Submission> submissions;
+  bool reenter = false;
+  CGUISpriteBatch batch;
+};
+}
+
+TEST_F(TestGUISpriteBatch, MergesEqualState)
+{
+  AddQuad(MakeState(1), 0.0f);
+  AddQuad(MakeState(1), 1.0f);
+  AddQuad(MakeState(1), 2.0f);
+  EXPECT_TRUE(submissions.empty());
+
+  batch.Flush();
+  ASSERT_EQ(1u, submissions.size());
+  EXPECT_EQ(12u, submissions[0].vertices.size());
+  EXPECT_EQ(2.0f, submissions[0].vertices[8].x);
+
+  const uint16_t expected[] = { 0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4, 8, 9, 10, 10, 11, 8 };
+  EXPECT_EQ(std::vector<uint16_t>(expected, expected + 18), submissions[0].indices);
+  EXPECT_TRUE(batch.IsEmpty());
+}
+
+TEST_F(TestGUISpriteBatch, KeepsOrderAcrossStateChanges)
+{
+  AddQuad(MakeState(1), 0.0f);
+  AddQuad(MakeState(2), 1.0f);
+  AddQuad(MakeState(2, 0x80ffffff), 2.0f);
+  AddQuad(MakeState(1), 3.0f);
+  batch.Flush();
+
+  ASSERT_EQ(4u, submissions.size());
+  for (unsigned int i = 0; i < submissions.size(); i++)
+  {
+    ASSERT_EQ(4u, submissions[i].vertices.size());
+    EXPECT_EQ(static_cast<float>(i), submissions[i].vertices[0].x);
+    // every submission starts at the beginning of the shared index pattern
+    EXPECT_EQ(0u, submissions[i].indices[0]);
+  }
+  EXPECT_EQ(0x80ffffffu, submissions[2].state.color);
+}
+
+TEST_F(TestGUISpriteBatch, SplitsAtIndexLimit)
+{
+  for (unsigned int i = 0; i < CGUISpriteBatch::MAX_QUADS + 1; i++)
+    AddQuad(MakeState(1), 0.0f);
+  batch.Flush();
+
+  ASSERT_EQ(2u, submissions.size());
+  EXPECT_EQ(CGUISpriteBatch::MAX_QUADS * 4, submissions[0].vertices.size());
+  EXPECT_EQ(65535u, submissions[0].indices[CGUISpriteBatch::MAX_QUADS * 6 - 2]);
+  EXPECT_EQ(4u, submissions[1].vertices.size());
+}
+
+TEST_F(TestGUISpriteBatch, IgnoresReentrantFlush)
+{
+  reenter = true;
+  AddQuad(MakeState(1), 0.0f);
+  batch.Flush();
+  batch.Flush();
+  EXPECT_EQ(1u, submissions.size());
+}
+
+TEST_F(TestGUISpriteBatch, FrameStats)
+{
+  AddQuad(MakeState(1), 0.0f);
+  AddQuad(MakeState(1), 0.0f);
+  AddQuad(MakeState(2), 0.0f);
+  EXPECT_EQ(0u, batch.GetFrameStats().drawCalls);
+
+  batch.EndFrame();
+  EXPECT_EQ(2u, batch.GetFrameStats().drawCalls);
+  EXPECT_EQ(3u, batch.GetFrameStats().quads);
+
+  batch.EndFrame();
+  EXPECT_EQ(0u, batch.GetFrameStats().drawCalls);
+  EXPECT_EQ(0u, batch.GetFrameStats().quads);
+}
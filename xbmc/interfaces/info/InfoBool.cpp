@@ -23,13 +23,24 @@
 
 namespace INFO
 {
-  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
+  void InfoRefresh::Invalidate(unsigned int dependencies)
+  {
+    m_counter++;
+    for (unsigned int i = 0; i < DEPENDENCY_BITS; i++)
+    {
+      if (dependencies & (1 << i))
+        m_changed[i] = m_counter;
+    }
+  }
+
+  InfoBool::InfoBool(const std::string &expression, int context, InfoRefresh &refresh)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
+      m_dependencies(DEPENDENCY_VOLATILE),
       m_expression(expression),
       m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_refresh(refresh)
   {
     StringUtils::ToLower(m_expression);
   }
@@ -27,6 +27,65 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief Data an info bool depends on, it is only refreshed once one of these changed
+ */
+enum InfoDependency
+{
+  DEPENDENCY_NONE     = 0x00,  ///< constant for the lifetime of the skin
+  DEPENDENCY_SKIN     = 0x01,  ///< skin settings
+  DEPENDENCY_LIBRARY  = 0x02,  ///< library content
+  DEPENDENCY_PLAYER   = 0x04,  ///< player state, not its position
+  DEPENDENCY_TIME     = 0x08,  ///< wall clock, at minute resolution
+  DEPENDENCY_VOLATILE = 0x10,  ///< anything else, refreshed every frame
+  DEPENDENCY_ALL      = 0x1f
+};
+
+/*!
+ \ingroup info
+ \brief Keeps track of when each kind of dependency last changed
+ */
+class InfoRefresh
+{
+public:
+  /*! \brief Mark all info bools depending on any of the given dependencies dirty
+   \param dependencies mask of InfoDependency values
+   */
+  void Invalidate(unsigned int dependencies);
+
+  /*! \brief Check if any of the given dependencies changed
+   \param dependencies mask of InfoDependency values
+   \param since counter the value was last refreshed at, 0 if never
+   */
+  inline bool HasChanged(unsigned int dependencies, unsigned int since) const
+  {
+    if (since == 0)
+      return true;
+    if (since == m_counter)
+      return false;
+    for (unsigned int i = 0; dependencies; i++, dependencies >>= 1)
+    {
+      if ((dependencies & 1) && m_changed[i] > since)
+        return true;
+    }
+    return false;
+  }
+
+  unsigned int GetCounter() const { return m_counter; }
+
+  void CountEvaluation() { m_evaluations++; }
+  unsigned int GetEvaluations() const { return m_evaluations; }
+  void ResetEvaluations() { m_evaluations = 0; }
+
+private:
+  static const unsigned int DEPENDENCY_BITS = 5;
+
+  unsigned int m_counter = 1;
+  unsigned int m_changed[DEPENDENCY_BITS] = {};
+  unsigned int m_evaluations = 0;
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -34,7 +93,7 @@ namespace INFO
 class InfoBool
 {
 public:
-  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter);
+  InfoBool(const std::string &expression, int context, InfoRefresh &refresh);
   virtual ~InfoBool() = default;
 
   virtual void Initialize() {};
@@ -46,11 +105,15 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
+    {
       Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+      m_refresh.CountEvaluation();
+    }
+    else if (m_refresh.HasChanged(m_dependencies, m_refreshCounter))
     {
       Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      m_refresh.CountEvaluation();
+      m_refreshCounter = m_refresh.GetCounter();
     }
     return m_value;
   }
@@ -78,16 +141,18 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  unsigned int GetDependencies() const { return m_dependencies; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_dependencies; ///< InfoDependency mask, refresh only if one of these changed
   std::string  m_expression;   ///< original expression
 
 private:
   unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  InfoRefresh &m_refresh;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
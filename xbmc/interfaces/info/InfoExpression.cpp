@@ -22,6 +22,7 @@
 #include <stack>
 #include "utils/log.h"
 #include "GUIInfoManager.h"
+#include <iterator>
 #include <list>
 #include <memory>
 
@@ -30,6 +31,7 @@ using namespace INFO;
 void InfoSingle::Initialize()
 {
   m_condition = g_infoManager.TranslateSingleString(m_expression, m_listItemDependent);
+  m_dependencies = g_infoManager.GetDependencies(m_condition, m_listItemDependent);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -39,26 +41,35 @@ void InfoSingle::Update(const CGUIListItem *item)
 
 void InfoExpression::Initialize()
 {
-  if (!Parse(m_expression))
+  // collected from the operands while parsing
+  m_dependencies = DEPENDENCY_NONE;
+  InfoSubexpressionPtr tree;
+  if (!Parse(m_expression, tree))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(g_infoManager.Register("false", 0), false);
+    tree = std::make_shared<InfoLeaf>(RegisterOperand("false"), false);
+    m_dependencies = DEPENDENCY_NONE;
   }
+  Compile(tree);
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  m_value = Execute(item);
+}
+
+InfoPtr InfoExpression::RegisterOperand(const std::string &operand)
+{
+  return g_infoManager.Register(operand, m_context);
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
- * formation of groups of associative nodes. These groups are then reordered at
- * evaluation time such that nodes whose value renders the evaluation of the
- * remainder of the group unnecessary tend to be evaluated first (these are
- * true nodes for OR subexpressions, or false nodes for AND subexpressions).
- * The end effect is to minimise the number of leaf nodes that need to be
- * evaluated in order to determine the value of the expression. The runtime
- * adaptability has the advantage of not being customised for any particular skin.
+ * formation of groups of associative nodes. The evaluation of a group stops
+ * at the first node whose value renders the evaluation of the remainder of the
+ * group unnecessary (true nodes for OR subexpressions, or false nodes for AND
+ * subexpressions). Evaluating the tree directly also reorders the group such
+ * that these nodes tend to be evaluated first; the compiled program keeps the
+ * parsed order, its operands are cached info bools which are cheap to fetch.
  *
  * The modifications to the expression at parse time fall into two groups:
  * 1) Moving logical NOTs so that they are only applied to leaf nodes.
@@ -205,7 +216,7 @@ void InfoExpression::OperatorPop(std::stack<operator_t> &operator_stack, bool &i
   }
 }
 
-bool InfoExpression::Parse(const std::string &expression)
+bool InfoExpression::Parse(const std::string &expression, InfoSubexpressionPtr &tree)
 {
   const char *s = expression.c_str();
   std::string operand;
@@ -240,14 +251,15 @@ bool InfoExpression::Parse(const std::string &expression)
       }
       if (!operand.empty())
       {
-        InfoPtr info = g_infoManager.Register(operand, m_context);
+        InfoPtr info = RegisterOperand(operand);
         if (!info)
         {
           CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
           return false;
         }
-        /* Propagate any listItem dependency from the operand to the expression */
+        /* Propagate any listItem and data dependencies from the operand to the expression */
         m_listItemDependent |= info->ListItemDependent();
+        m_dependencies |= info->GetDependencies();
         nodes.push(std::make_shared<InfoLeaf>(info, invert));
         /* Reuse operand string for next operand */
         operand.clear();
@@ -291,19 +303,131 @@ bool InfoExpression::Parse(const std::string &expression)
   }
   if (!operand.empty())
   {
-    InfoPtr info = g_infoManager.Register(operand, m_context);
+    InfoPtr info = RegisterOperand(operand);
     if (!info)
     {
       CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
       return false;
     }
-    /* Propagate any listItem dependency from the operand to the expression */
+    /* Propagate any listItem and data dependencies from the operand to the expression */
     m_listItemDependent |= info->ListItemDependent();
+    m_dependencies |= info->GetDependencies();
     nodes.push(std::make_shared<InfoLeaf>(info, invert));
   }
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  tree = nodes.top();
   return true;
 }
+
+/* The tree is compiled into a flat program for a machine with a single
+ * boolean register. Leaves load their (possibly inverted) value into it, a
+ * group evaluates its children in order with a conditional jump after each
+ * but the last one, skipping the rest of the group once its value is known.
+ * For example A+[B|!C]+D becomes
+ *
+ *   0: INFO A
+ *   1: JUMP_IF_FALSE 7
+ *   2: INFO B
+ *   3: JUMP_IF_TRUE 5
+ *   4: NOT_INFO C
+ *   5: JUMP_IF_FALSE 7
+ *   6: INFO D
+ *
+ * after which jumps landing on other jumps are threaded through to their
+ * final destination. The jump at 3 is only taken with B true, in which case
+ * the one at 5 falls through, so it becomes JUMP_IF_TRUE 6. Evaluation then
+ * only walks an array, without virtual calls, recursion or reference counting.
+ */
+
+void InfoExpression::InfoLeaf::Compile(InfoExpression &expression) const
+{
+  Instruction instruction;
+  instruction.opcode = m_invert ? OPCODE_NOT_INFO : OPCODE_INFO;
+  instruction.arg = expression.AddOperand(m_info);
+  expression.m_program.push_back(instruction);
+}
+
+void InfoExpression::InfoAssociativeGroup::Compile(InfoExpression &expression) const
+{
+  std::vector<Instruction> &program = expression.m_program;
+  std::vector<size_t> jumps;
+  for (auto it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    (*it)->Compile(expression);
+    if (std::next(it) == m_children.end())
+      break;
+
+    Instruction instruction;
+    instruction.opcode = m_type == NODE_AND ? OPCODE_JUMP_IF_FALSE : OPCODE_JUMP_IF_TRUE;
+    instruction.arg = 0;
+    jumps.push_back(program.size());
+    program.push_back(instruction);
+  }
+
+  for (size_t jump : jumps)
+    program[jump].arg = static_cast<unsigned int>(program.size());
+}
+
+unsigned int InfoExpression::AddOperand(const InfoPtr &info)
+{
+  for (size_t i = 0; i < m_operands.size(); i++)
+  {
+    if (m_operands[i] == info)
+      return static_cast<unsigned int>(i);
+  }
+  m_operands.push_back(info);
+  return static_cast<unsigned int>(m_operands.size() - 1);
+}
+
+void InfoExpression::Compile(const InfoSubexpressionPtr &tree)
+{
+  m_program.clear();
+  m_operands.clear();
+  tree->Compile(*this);
+
+  // a jump is only taken with a known register value, so a jump it lands on
+  // is either taken as well or falls through
+  const size_t size = m_program.size();
+  for (auto &instruction : m_program)
+  {
+    if (instruction.opcode != OPCODE_JUMP_IF_TRUE && instruction.opcode != OPCODE_JUMP_IF_FALSE)
+      continue;
+
+    size_t target = instruction.arg;
+    while (target < size &&
+           (m_program[target].opcode == OPCODE_JUMP_IF_TRUE || m_program[target].opcode == OPCODE_JUMP_IF_FALSE))
+    {
+      if (m_program[target].opcode == instruction.opcode)
+        target = m_program[target].arg;
+      else
+        target++;
+    }
+    instruction.arg = static_cast<unsigned int>(target);
+  }
+
+  m_program.shrink_to_fit();
+  m_operands.shrink_to_fit();
+}
+
+bool InfoExpression::Execute(const CGUIListItem *item) const
+{
+  bool result = false;
+  const size_t size = m_program.size();
+  size_t pc = 0;
+  while (pc < size)
+  {
+    const Instruction &instruction = m_program[pc];
+    if (instruction.opcode <= OPCODE_NOT_INFO)
+    {
+      result = (instruction.opcode == OPCODE_NOT_INFO) ^ m_operands[instruction.arg]->Get(item);
+      pc++;
+    }
+    else if (result == (instruction.opcode == OPCODE_JUMP_IF_TRUE))
+      pc = instruction.arg;
+    else
+      pc++;
+  }
+  return result;
+}
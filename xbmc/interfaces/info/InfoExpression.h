@@ -34,8 +34,8 @@ namespace INFO
 class InfoSingle : public InfoBool
 {
 public:
-  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoSingle(const std::string &expression, int context, InfoRefresh &refresh)
+    : InfoBool(expression, context, refresh) {};
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
@@ -44,18 +44,21 @@ private:
 };
 
 /*! \brief Class to wrap active boolean expressions
+
+ The expression is parsed into a tree, which is then compiled into a flat
+ program of operand loads and short-circuit jumps, see Compile().
  */
 class InfoExpression : public InfoBool
 {
 public:
-  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoExpression(const std::string &expression, int context, InfoRefresh &refresh)
+    : InfoBool(expression, context, refresh) {};
   ~InfoExpression() override = default;
 
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
-private:
+protected:
   typedef enum
   {
     OPERATOR_NONE  = 0,
@@ -73,12 +76,27 @@ private:
     NODE_OR,
   } node_type_t;
 
+  typedef enum
+  {
+    OPCODE_INFO,          // load operand
+    OPCODE_NOT_INFO,      // load inverted operand
+    OPCODE_JUMP_IF_TRUE,  // skip the rest of an OR group
+    OPCODE_JUMP_IF_FALSE, // skip the rest of an AND group
+  } opcode_t;
+
+  struct Instruction
+  {
+    opcode_t opcode;
+    unsigned int arg;     // operand index or jump target
+  };
+
   // An abstract base class for nodes in the expression tree
   class InfoSubexpression
   {
   public:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
     virtual bool Evaluate(const CGUIListItem *item) = 0;
+    virtual void Compile(InfoExpression &expression) const = 0;
     virtual node_type_t Type() const=0;
   };
 
@@ -90,6 +108,7 @@ private:
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
     bool Evaluate(const CGUIListItem *item) override;
+    void Compile(InfoExpression &expression) const override;
     node_type_t Type() const override { return NODE_LEAF; };
   private:
     InfoPtr m_info;
@@ -104,16 +123,25 @@ private:
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
     bool Evaluate(const CGUIListItem *item) override;
+    void Compile(InfoExpression &expression) const override;
     node_type_t Type() const override { return m_type; };
   private:
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
   };
 
+  virtual InfoPtr RegisterOperand(const std::string &operand);
+  bool Parse(const std::string &expression, InfoSubexpressionPtr &tree);
+  void Compile(const InfoSubexpressionPtr &tree);
+  bool Execute(const CGUIListItem *item) const;
+
+  std::vector<Instruction> m_program;
+  std::vector<InfoPtr> m_operands; ///< each distinct operand once, indexed by the program
+
+private:
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
-  bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  unsigned int AddOperand(const InfoPtr &info);
 };
 
 };
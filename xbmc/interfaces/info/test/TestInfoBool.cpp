@@ -0,0 +1,97 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "interfaces/info/InfoBool.h"
+
+#include "gtest/gtest.h"
+
+using namespace INFO;
+
+namespace
+{
+class CountingInfoBool : public InfoBool
+{
+public:
+  CountingInfoBool(unsigned int dependencies, InfoRefresh &refresh)
+    : InfoBool("test", 0, refresh)
+  {
+    m_dependencies = dependencies;
+  }
+
+  void Update(const CGUIListItem *item) override
+  {
+    m_updates++;
+    m_value = !m_value;
+  }
+
+  int m_updates = 0;
+};
+}
+
+TEST(TestInfoBool, Constant)
+{
+  InfoRefresh refresh;
+  CountingInfoBool info(DEPENDENCY_NONE, refresh);
+
+  EXPECT_TRUE(info.Get());
+  refresh.Invalidate(DEPENDENCY_VOLATILE | DEPENDENCY_PLAYER);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ(1, info.m_updates);
+
+  refresh.Invalidate(DEPENDENCY_ALL);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ(1, info.m_updates);
+}
+
+TEST(TestInfoBool, Dependencies)
+{
+  InfoRefresh refresh;
+  CountingInfoBool skin(DEPENDENCY_SKIN, refresh);
+  CountingInfoBool playerTime(DEPENDENCY_PLAYER | DEPENDENCY_TIME, refresh);
+  CountingInfoBool volatileBool(DEPENDENCY_VOLATILE, refresh);
+
+  skin.Get();
+  playerTime.Get();
+  volatileBool.Get();
+  EXPECT_EQ(3U, refresh.GetEvaluations());
+
+  // a frame passes without events
+  refresh.ResetEvaluations();
+  refresh.Invalidate(DEPENDENCY_VOLATILE);
+  skin.Get();
+  playerTime.Get();
+  volatileBool.Get();
+  EXPECT_EQ(1, skin.m_updates);
+  EXPECT_EQ(1, playerTime.m_updates);
+  EXPECT_EQ(2, volatileBool.m_updates);
+  EXPECT_EQ(1U, refresh.GetEvaluations());
+
+  refresh.Invalidate(DEPENDENCY_TIME);
+  skin.Get();
+  playerTime.Get();
+  EXPECT_EQ(1, skin.m_updates);
+  EXPECT_EQ(2, playerTime.m_updates);
+
+  refresh.Invalidate(DEPENDENCY_SKIN);
+  refresh.Invalidate(DEPENDENCY_LIBRARY);
+  skin.Get();
+  playerTime.Get();
+  EXPECT_EQ(2, skin.m_updates);
+  EXPECT_EQ(2, playerTime.m_updates);
+}
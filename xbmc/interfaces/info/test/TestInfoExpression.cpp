@@ -0,0 +1,229 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "interfaces/info/InfoExpression.h"
+#include "test/TestUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace INFO;
+
+namespace
+{
+class TestOperand : public InfoBool
+{
+public:
+  TestOperand(const std::string &expression, InfoRefresh &refresh)
+    : InfoBool(expression, 0, refresh) {}
+
+  void Update(const CGUIListItem *item) override
+  {
+    m_updates++;
+    m_value = m_state;
+  }
+
+  bool m_state = false;
+  int m_updates = 0;
+};
+
+class TestOperands
+{
+public:
+  std::shared_ptr<TestOperand> Get(const std::string &name)
+  {
+    auto &operand = m_operands[name];
+    if (!operand)
+      operand = std::make_shared<TestOperand>(name, m_refresh);
+    return operand;
+  }
+
+  void Set(const std::string &name, bool state)
+  {
+    Get(name)->m_state = state;
+  }
+
+  void Refresh()
+  {
+    m_refresh.Invalidate(DEPENDENCY_ALL);
+  }
+
+  InfoRefresh m_refresh;
+  std::map<std::string, std::shared_ptr<TestOperand>> m_operands;
+};
+
+class TestExpression : public InfoExpression
+{
+public:
+  TestExpression(const std::string &expression, TestOperands &operands)
+    : InfoExpression(expression, 0, operands.m_refresh),
+      m_testOperands(operands)
+  {
+    Initialize();
+    Parse(m_expression, m_tree);
+  }
+
+  bool EvaluateTree() { return m_tree->Evaluate(nullptr); }
+  bool EvaluateProgram() const { return Execute(nullptr); }
+  size_t GetOperandCount() const { return m_operands.size(); }
+  size_t GetProgramSize() const { return m_program.size(); }
+
+protected:
+  InfoPtr RegisterOperand(const std::string &operand) override
+  {
+    return m_testOperands.Get(operand);
+  }
+
+private:
+  TestOperands &m_testOperands;
+  InfoSubexpressionPtr m_tree;
+};
+
+void CollectConditions(const TiXmlElement *element, std::vector<std::string> &conditions)
+{
+  for (; element; element = element->NextSiblingElement())
+  {
+    const std::string name = element->ValueStr();
+    if ((name == "visible" || name == "enable" || name == "selected" ||
+         name == "usealttexture" || name == "expression") &&
+        element->FirstChild())
+      conditions.push_back(element->FirstChild()->ValueStr());
+
+    const char *condition = element->Attribute("condition");
+    if (condition)
+      conditions.push_back(condition);
+
+    CollectConditions(element->FirstChildElement(), conditions);
+  }
+}
+}
+
+TEST(TestInfoExpression, MatchesTree)
+{
+  const std::vector<std::string> names = { "a", "b", "c", "d", "e" };
+  const std::vector<std::string> expressions = {
+    "a", "!a", "a+b", "a|b", "!![a]", "![a+b]|c", "a+[b|!c]+d",
+    "[a|b]+[c|d]", "a|[b+[c|!d]]|e", "[a|b]|[c|d+[[e|a]|b]]",
+    "!a+!b+![c|[d+!e]]", "[[a+b]|[c+d]]+[e|!a]"
+  };
+
+  TestOperands operands;
+  for (const auto &expression : expressions)
+  {
+    TestExpression test(expression, operands);
+    for (unsigned int state = 0; state < (1u << names.size()); state++)
+    {
+      for (size_t i = 0; i < names.size(); i++)
+        operands.Set(names[i], (state >> i) & 1);
+      operands.Refresh();
+      EXPECT_EQ(test.EvaluateTree(), test.EvaluateProgram()) << expression << " state " << state;
+    }
+  }
+}
+
+TEST(TestInfoExpression, Operands)
+{
+  TestOperands operands;
+  TestExpression test("a+[!a|b]+a", operands);
+  EXPECT_EQ(2U, test.GetOperandCount());
+  EXPECT_EQ(7U, test.GetProgramSize());
+}
+
+TEST(TestInfoExpression, ShortCircuit)
+{
+  TestOperands operands;
+  TestExpression test("a+[b|c]", operands);
+
+  operands.Set("a", false);
+  operands.Refresh();
+  EXPECT_FALSE(test.EvaluateProgram());
+  EXPECT_EQ(0, operands.Get("b")->m_updates);
+  EXPECT_EQ(0, operands.Get("c")->m_updates);
+
+  operands.Set("a", true);
+  operands.Set("b", true);
+  operands.Refresh();
+  EXPECT_TRUE(test.EvaluateProgram());
+  EXPECT_EQ(1, operands.Get("b")->m_updates);
+  EXPECT_EQ(0, operands.Get("c")->m_updates);
+}
+
+TEST(TestInfoExpression, DISABLED_Benchmark)
+{
+  std::vector<std::string> conditions;
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(XBMC_REF_FILE_PATH("addons/skin.estuary/xml/"), items, ".xml"));
+  for (const auto &item : items)
+  {
+    CXBMCTinyXML doc;
+    if (doc.LoadFile(item->GetPath()))
+      CollectConditions(doc.RootElement(), conditions);
+  }
+
+  TestOperands operands;
+  std::vector<std::unique_ptr<TestExpression>> expressions;
+  for (const auto &condition : conditions)
+  {
+    // skin variables and include parameters are only resolved by the skin loader
+    if (condition.find('$') == std::string::npos &&
+        condition.find_first_of("|+[]!") != std::string::npos)
+      expressions.emplace_back(new TestExpression(condition, operands));
+  }
+  ASSERT_FALSE(expressions.empty());
+
+  // mix of true and false operands, so both short-circuit directions are taken
+  unsigned int seed = 1;
+  for (auto &operand : operands.m_operands)
+  {
+    seed = seed * 1103515245 + 12345;
+    operand.second->m_state = (seed >> 16) & 1;
+  }
+
+  const int frames = 1000;
+  size_t trueCount = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++)
+  {
+    operands.Refresh();
+    for (auto &expression : expressions)
+      trueCount += expression->EvaluateTree();
+  }
+  auto tree = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++)
+  {
+    operands.Refresh();
+    for (auto &expression : expressions)
+      trueCount -= expression->EvaluateProgram();
+  }
+  auto program = std::chrono::steady_clock::now();
+
+  EXPECT_EQ(0U, trueCount);
+  const double count = static_cast<double>(frames) * expressions.size();
+  std::cout << expressions.size() << " expressions, "
+            << "tree: " << std::chrono::duration<double, std::nano>(tree - begin).count() / count << " ns, "
+            << "bytecode: " << std::chrono::duration<double, std::nano>(program - tree).count() / count << " ns" << std::endl;
+}
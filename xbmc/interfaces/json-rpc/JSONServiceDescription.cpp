@@ -62,6 +62,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "Player.GetActivePlayers",                      CPlayerOperations::GetActivePlayers },
   { "Player.GetPlayers",                            CPlayerOperations::GetPlayers },
   { "Player.GetProperties",                         CPlayerOperations::GetProperties },
+  { "Player.GetAudioEngineStats",                   CPlayerOperations::GetAudioEngineStats },
   { "Player.GetItem",                               CPlayerOperations::GetItem },
 
   { "Player.PlayPause",                             CPlayerOperations::PlayPause },
@@ -39,6 +39,7 @@
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/recordings/PVRRecordings.h"
+#include "cores/DataCacheCore.h"
 #include "cores/IPlayer.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "SeekHandler.h"
@@ -262,6 +263,54 @@ JSONRPC_STATUS CPlayerOperations::GetItem(const std::string &method, ITransportL
   return OK;
 }
 
+JSONRPC_STATUS CPlayerOperations::GetAudioEngineStats(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  AELatencyStats stats = CServiceBroker::GetDataCacheCore().GetAudioEngineStats();
+
+  result = CVariant(CVariant::VariantTypeObject);
+  result["stages"] = CVariant(CVariant::VariantTypeObject);
+  for (int i = 0; i < AE_STAGE_MAX; i++)
+  {
+    const CAELatencyHistogram &histogram = stats.stages[i];
+    CVariant stage = CVariant(CVariant::VariantTypeObject);
+    stage["count"] = histogram.GetCount();
+    stage["total"] = histogram.GetTotal();
+    stage["max"] = histogram.GetMax();
+    stage["p50"] = histogram.GetPercentile(50);
+    stage["p90"] = histogram.GetPercentile(90);
+    stage["p99"] = histogram.GetPercentile(99);
+    stage["buckets"] = CVariant(CVariant::VariantTypeArray);
+    for (int bucket = 0; bucket < CAELatencyHistogram::BUCKETS; bucket++)
+      stage["buckets"].push_back(histogram.GetBucket(bucket));
+    result["stages"][AELatencyStats::GetStageName(static_cast<AEStage>(i))] = stage;
+  }
+
+  result["enginebuffered"] = stats.engineBufferedTime;
+  result["sinkdelay"] = stats.sinkDelay;
+  result["sinkcache"] = stats.sinkCacheTotal;
+  result["underruns"] = CVariant(CVariant::VariantTypeObject);
+  result["underruns"]["stream"] = stats.streamUnderruns;
+  result["underruns"]["sink"] = stats.sinkUnderruns;
+
+  static const char *syncStates[] = { "off", "insync", "start", "mute", "adjust" };
+  result["streams"] = CVariant(CVariant::VariantTypeArray);
+  for (const auto &str : stats.streams)
+  {
+    CVariant stream = CVariant(CVariant::VariantTypeObject);
+    stream["id"] = str.id;
+    stream["buffered"] = str.bufferedTime;
+    stream["syncerror"] = str.syncError;
+    stream["resampleratio"] = str.resampleRatio;
+    if (str.syncState >= 0 && str.syncState < static_cast<int>(sizeof(syncStates) / sizeof(syncStates[0])))
+      stream["syncstate"] = syncStates[str.syncState];
+    else
+      stream["syncstate"] = "off";
+    result["streams"].push_back(stream);
+  }
+
+  return OK;
+}
+
 JSONRPC_STATUS CPlayerOperations::PlayPause(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CGUIWindowSlideShow *slideshow = NULL;
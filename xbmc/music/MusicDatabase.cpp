@@ -49,6 +49,7 @@
 #include "network/cddb.h"
 #include "network/Network.h"
 #include "playlists/SmartPlayList.h"
+#include "playlists/SmartPlaylistIndex.h"
 #include "profiles/ProfilesManager.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -530,19 +531,24 @@ int CMusicDatabase::AddSong(const int idAlbum,
     URIUtils::Split(strPathAndFileName, strPath, strFileName);
     int idPath = AddPath(strPath);
 
+    bool found;
     if (!strMusicBrainzTrackID.empty())
-      strSQL = PrepareSQL("SELECT idSong FROM song WHERE idAlbum = %i AND iTrack=%i AND strMusicBrainzTrackID = '%s'",
-                          idAlbum, 
-                          iTrack,
-                          strMusicBrainzTrackID.c_str());
+    {
+      strSQL = "SELECT idSong FROM song WHERE idAlbum = ? AND iTrack=? AND strMusicBrainzTrackID = ?";
+      found = m_pDS->query(strSQL, {dbiplus::field_value(idAlbum),
+                                    dbiplus::field_value(iTrack),
+                                    dbiplus::field_value(strMusicBrainzTrackID)});
+    }
     else
-      strSQL = PrepareSQL("SELECT idSong FROM song WHERE idAlbum=%i AND strFileName='%s' AND strTitle='%s' AND iTrack=%i AND strMusicBrainzTrackID IS NULL",
-                          idAlbum,
-                          strFileName.c_str(),
-                          strTitle.c_str(),
-                          iTrack);
+    {
+      strSQL = "SELECT idSong FROM song WHERE idAlbum=? AND strFileName=? AND strTitle=? AND iTrack=? AND strMusicBrainzTrackID IS NULL";
+      found = m_pDS->query(strSQL, {dbiplus::field_value(idAlbum),
+                                    dbiplus::field_value(strFileName),
+                                    dbiplus::field_value(strTitle),
+                                    dbiplus::field_value(iTrack)});
+    }
 
-    if (!m_pDS->query(strSQL))
+    if (!found)
       return -1;
 
     if (m_pDS->num_rows() == 0)
@@ -1042,8 +1048,8 @@ int CMusicDatabase::AddGenre(std::string& strGenre)
       return it->second;
 
 
-    strSQL=PrepareSQL("SELECT idGenre, strGenre FROM genre WHERE strGenre LIKE '%s'", strGenre.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "SELECT idGenre, strGenre FROM genre WHERE strGenre LIKE ?";
+    m_pDS->query(strSQL, {dbiplus::field_value(strGenre)});
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
@@ -1945,8 +1951,8 @@ int CMusicDatabase::AddPath(const std::string& strPath1)
     if (it != m_pathCache.end())
       return it->second;
 
-    strSQL=PrepareSQL( "select * from path where strPath='%s'", strPath.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "select * from path where strPath=?";
+    m_pDS->query(strSQL, {dbiplus::field_value(strPath)});
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
@@ -2251,9 +2257,10 @@ int CMusicDatabase::GetAlbumIdByPath(const std::string& strPath)
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    std::string strSQL = PrepareSQL("SELECT DISTINCT idAlbum FROM song JOIN path ON song.idPath = path.idPath WHERE path.strPath='%s'", strPath.c_str());
     // run query
-    if (!m_pDS->query(strSQL)) return false;
+    if (!m_pDS->query("SELECT DISTINCT idAlbum FROM song JOIN path ON song.idPath = path.idPath WHERE path.strPath=?",
+                      {dbiplus::field_value(strPath)}))
+      return false;
     int iRowsFound = m_pDS->num_rows();
 
     int idAlbum = -1; // If no album is found, or more than one album is found then -1 is returned
@@ -4411,13 +4418,23 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     else
       strSQL = "SELECT songview.* FROM songview " + strSQLExtra;
 
+    // Avoid sorting with limits when have join with songartistview 
+    // Limit when SortByNone already applied in SQL, 
+    // apply sort later to fileitems list rather than dataset
+    sorting = sortDescription;
+    if (artistData && sortDescription.sortBy != SortByNone)
+      sorting.sortBy = SortByNone;
+
+    // Without sorting of the dataset the rows are used in the returned order,
+    // so they can be streamed rather than held in memory all at once
+    const bool streamed = sorting.sortBy == SortByNone;
+
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
     // run query
-    if (!m_pDS->query(strSQL))
+    if (!(streamed ? m_pDS->query_stream(strSQL) : m_pDS->query(strSQL)))
       return false;
 
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound == 0)
+    if (m_pDS->eof())
     {
       m_pDS->close();
       return true;
@@ -4426,63 +4443,68 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     // Store the total number of songs as a property
     items.SetProperty("total", total);
 
-    DatabaseResults results;
-    results.reserve(iRowsFound);
-    // Avoid sorting with limits when have join with songartistview 
-    // Limit when SortByNone already applied in SQL, 
-    // apply sort later to fileitems list rather than dataset
-    sorting = sortDescription;
-    if (artistData && sortDescription.sortBy != SortByNone)
-      sorting.sortBy = SortByNone;
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
-      return false;
-
     // Get songs from returned rows. If join songartistview then there is a row for every artist
     items.Reserve(total);
     int songArtistOffset = song_enumCount;
     int songId = -1;
     VECARTISTCREDITS artistCredits;
-    const dbiplus::query_data &data = m_pDS->get_result_set().records;
     int count = 0;
-    for (const auto &i : results)
+    auto addRecord = [&](const dbiplus::sql_record* const record)
     {
-      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
-      
-      try
-      {
-        if (songId != record->at(song_idSong).get_asInt())
-        { //New song
-          if (songId > 0 && !artistCredits.empty())
-          {
-            //Store artist credits for previous song
-            GetFileItemFromArtistCredits(artistCredits, items[items.Size()-1].get());
-            artistCredits.clear();
-          }
-          songId = record->at(song_idSong).get_asInt();
-          CFileItemPtr item(new CFileItem);
-          GetFileItemFromDataset(record, item.get(), musicUrl);
-          // HACK for sorting by database returned order
-          item->m_iprogramCount = ++count;
-          items.Add(item);
-        }
-        // Get song artist credits and contributors
-        if (artistData)
+      if (songId != record->at(song_idSong).get_asInt())
+      { //New song
+        if (songId > 0 && !artistCredits.empty())
         {
-          int idSongArtistRole = record->at(songArtistOffset + artistCredit_idRole).get_asInt();
-          if (idSongArtistRole == ROLE_ARTIST)
-            artistCredits.push_back(GetArtistCreditFromDataset(record, songArtistOffset));
-          else
-            items[items.Size() - 1]->GetMusicInfoTag()->AppendArtistRole(GetArtistRoleFromDataset(record, songArtistOffset));
+          //Store artist credits for previous song
+          GetFileItemFromArtistCredits(artistCredits, items[items.Size()-1].get());
+          artistCredits.clear();
         }
+        songId = record->at(song_idSong).get_asInt();
+        CFileItemPtr item(new CFileItem);
+        GetFileItemFromDataset(record, item.get(), musicUrl);
+        // HACK for sorting by database returned order
+        item->m_iprogramCount = ++count;
+        items.Add(item);
       }
-      catch (...)
+      // Get song artist credits and contributors
+      if (artistData)
       {
-        m_pDS->close();
-        CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, filter.where.c_str());
-        return (items.Size() > 0);
+        int idSongArtistRole = record->at(songArtistOffset + artistCredit_idRole).get_asInt();
+        if (idSongArtistRole == ROLE_ARTIST)
+          artistCredits.push_back(GetArtistCreditFromDataset(record, songArtistOffset));
+        else
+          items[items.Size() - 1]->GetMusicInfoTag()->AppendArtistRole(GetArtistRoleFromDataset(record, songArtistOffset));
+      }
+    };
+
+    try
+    {
+      if (streamed)
+      {
+        for (; !m_pDS->eof(); m_pDS->next())
+          addRecord(m_pDS->get_sql_record());
+      }
+      else
+      {
+        DatabaseResults results;
+        results.reserve(m_pDS->num_rows());
+        if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
+          return false;
+
+        const dbiplus::query_data &data = m_pDS->get_result_set().records;
+        for (const auto &i : results)
+        {
+          unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
+          addRecord(data.at(targetRow));
+        }
       }
     }
+    catch (...)
+    {
+      m_pDS->close();
+      CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, filter.where.c_str());
+      return (items.Size() > 0);
+    }
     if (!artistCredits.empty())
     {
       //Store artist credits for final song
@@ -6309,8 +6331,9 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
     URIUtils::Split(filePath, strPath, strFileName);
     URIUtils::AddSlashAtEnd(strPath);
 
-    std::string sql = PrepareSQL("select idSong from song join path on song.idPath = path.idPath where song.strFileName='%s' and path.strPath='%s'", strFileName.c_str(), strPath.c_str());
-    if (!m_pDS->query(sql)) return -1;
+    if (!m_pDS->query("select idSong from song join path on song.idPath = path.idPath where song.strFileName=? and path.strPath=?",
+                      {dbiplus::field_value(strFileName), dbiplus::field_value(strPath)}))
+      return -1;
 
     if (m_pDS->num_rows() == 0)
     {
@@ -7330,7 +7353,10 @@ bool CMusicDatabase::GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription
 
     std::set<std::string> playlists;
     std::string xspWhere;
-    xspWhere = xsp.GetWhereClause(*this, playlists);
+    // rules the library index can evaluate are turned into a list of song ids
+    if (!g_advancedSettings.m_useLibraryIndex || xsp.GetType() != type ||
+        !CSmartPlaylistIndex::GetInstance().GetWhereClause(xsp, xspWhere))
+      xspWhere = xsp.GetWhereClause(*this, playlists);
     hasRoleRules = xsp.GetType() == "artists" && xspWhere.find("song_artist.idRole = role.idRole") != xspWhere.npos;
 
     // check if the filter playlist matches the item type
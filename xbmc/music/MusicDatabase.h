@@ -106,6 +106,7 @@ class CMusicDatabase : public CDatabase
 {
   friend class DatabaseUtils;
   friend class TestDatabaseUtilsHelper;
+  friend class CSmartPlaylistIndex;
 
 public:
   CMusicDatabase(void);
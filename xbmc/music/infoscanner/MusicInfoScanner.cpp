@@ -21,6 +21,7 @@
 #include "MusicInfoScanner.h"
 
 #include <algorithm>
+#include <atomic>
 #include <utility>
 
 #include "ServiceBroker.h"
@@ -55,10 +56,12 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "TextureCache.h"
+#include "threads/Event.h"
 #include "threads/SystemClock.h"
 #include "Util.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -71,6 +74,60 @@ using namespace MUSIC_GRABBER;
 using namespace ADDON;
 using KODI::UTILITY::CDigest;
 
+namespace
+{
+// number of jobs reading tags of a folder in parallel, reading tags is
+// mostly bound by the I/O latency of the storage rather than by cpu
+const unsigned int TAG_READER_JOBS = 4;
+
+void LoadTag(CFileItem &item)
+{
+  CMusicInfoTag& tag = *item.GetMusicInfoTag();
+  if (!tag.Loaded())
+  {
+    std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(item));
+    if (NULL != pLoader.get())
+      pLoader->Load(item.GetPath(), tag);
+  }
+}
+
+/*!
+ \brief Job loading the tags of every n-th item of a list.
+ Completion is signalled on destruction, so that a job that is cancelled by
+ the job manager before it ran does not leave the scanner waiting.
+ */
+class CTagLoaderJob : public CJob
+{
+public:
+  CTagLoaderJob(const std::vector<CFileItemPtr> &items, size_t first, size_t step,
+                const bool &stop, std::atomic<unsigned int> &remaining, CEvent &done)
+    : m_items(items), m_first(first), m_step(step), m_stop(stop), m_remaining(remaining), m_done(done)
+  {
+  }
+
+  ~CTagLoaderJob() override
+  {
+    if (--m_remaining == 0)
+      m_done.Set();
+  }
+
+  bool DoWork() override
+  {
+    for (size_t i = m_first; i < m_items.size() && !m_stop; i += m_step)
+      LoadTag(*m_items[i]);
+    return true;
+  }
+
+private:
+  const std::vector<CFileItemPtr> &m_items;
+  size_t m_first;
+  size_t m_step;
+  const bool &m_stop;
+  std::atomic<unsigned int> &m_remaining;
+  CEvent &m_done;
+};
+}
+
 CMusicInfoScanner::CMusicInfoScanner()
 : m_needsCleanup(false),
   m_scanType(0),
@@ -122,6 +179,10 @@ void CMusicInfoScanner::Process()
       // Reset progress vars
       m_currentItem=0;
       m_itemCount=-1;
+      m_enumerateStage = StageStats();
+      m_tagStage = StageStats();
+      m_databaseStage = StageStats();
+      WatchPaths(m_pathsToScan);
 
       // Create the thread to count all files to be scanned
       if (m_handle)
@@ -152,6 +213,7 @@ void CMusicInfoScanner::Process()
         bool scancomplete = DoScan(*it);
         if (scancomplete)
         { 
+          MarkScanned(*it);
           if (m_albumsAdded.size() > 0)
           {
             if (m_flags & SCAN_ONLINE)
@@ -195,6 +257,10 @@ void CMusicInfoScanner::Process()
       
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "My Music: Scanning for music info using worker thread, operation took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "My Music: Listed %u folders in %u ms (%.1f/s), read %u tags in %u ms (%.1f/s), stored %u songs in %u ms (%.1f/s)",
+                m_enumerateStage.items, m_enumerateStage.millis, m_enumerateStage.GetRate(),
+                m_tagStage.items, m_tagStage.millis, m_tagStage.GetRate(),
+                m_databaseStage.items, m_databaseStage.millis, m_databaseStage.GetRate());
     }
     if (m_scanType == 1) // load album info
     {
@@ -472,9 +538,21 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   if (IsExcluded(strDirectory, regexps))
     return true;
 
+  std::string dbHash;
+  if (!(m_flags & SCAN_RESCAN) && IsUnchanged(strDirectory) &&
+      m_musicDatabase.GetPathHash(strDirectory, dbHash) && !dbHash.empty())
+  { // no change was seen below the folder since it was scanned - no need to list it
+    CLog::Log(LOGDEBUG, "%s Skipping dir '%s' and its subfolders as no change was recorded", __FUNCTION__, CURL::GetRedacted(strDirectory).c_str());
+    if (m_handle)
+      OnDirectoryScanned(strDirectory);
+    return true;
+  }
+
   // load subfolder
+  unsigned int tick = XbmcThreads::SystemClockMillis();
   CFileItemList items;
   CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg");
+  m_enumerateStage.Add(1, XbmcThreads::SystemClockMillis() - tick);
 
   // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
   // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
@@ -484,13 +562,13 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   GetPathHash(items, hash);
 
   // check whether we need to rescan or not
-  std::string dbHash;
   if ((m_flags & SCAN_RESCAN) || !m_musicDatabase.GetPathHash(strDirectory, dbHash) || !StringUtils::EqualsNoCase(dbHash, hash))
   { // path has changed - rescan
     if (dbHash.empty())
       CLog::Log(LOGDEBUG, "%s Scanning dir '%s' as not in the database", __FUNCTION__, CURL::GetRedacted(strDirectory).c_str());
     else
       CLog::Log(LOGDEBUG, "%s Rescanning dir '%s' due to change", __FUNCTION__, CURL::GetRedacted(strDirectory).c_str());
+    MarkChanged(strDirectory);
 
     // filter items in the sub dir (for .cue sheet support)
     items.FilterCueItems();
@@ -545,11 +623,10 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
 {
   std::vector<std::string> regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
+  // collect the files we need tags for
+  std::vector<CFileItemPtr> songs;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -558,15 +635,22 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
+    songs.push_back(pItem);
+  }
+
+  // read the tags in parallel, the results are processed in folder order below
+  unsigned int tick = XbmcThreads::SystemClockMillis();
+  LoadTags(songs);
+  m_tagStage.Add(songs.size(), XbmcThreads::SystemClockMillis() - tick);
+
+  for (const auto &pItem : songs)
+  {
+    if (m_bStop)
+      return INFO_CANCELLED;
+
     m_currentItem++;
 
     CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
-    {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (NULL != pLoader.get())
-        pLoader->Load(pItem->GetPath(), tag);
-    }
 
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
@@ -587,7 +671,52 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     else
       scannedItems.Add(pItem);
   }
-  return INFO_ADDED;
+  return m_bStop ? INFO_CANCELLED : INFO_ADDED;
+}
+
+void CMusicInfoScanner::LoadTags(const std::vector<CFileItemPtr>& items)
+{
+  unsigned int jobs = std::min<size_t>(TAG_READER_JOBS, items.size());
+  if (jobs < 2)
+  {
+    for (const auto &item : items)
+    {
+      if (m_bStop)
+        break;
+      LoadTag(*item);
+    }
+    return;
+  }
+
+  std::atomic<unsigned int> remaining(jobs);
+  CEvent done;
+  std::vector<unsigned int> jobIDs;
+  for (unsigned int i = 0; i < jobs; i++)
+  {
+    CTagLoaderJob *job = new CTagLoaderJob(items, i, jobs, m_bStop, remaining, done);
+    unsigned int jobID = CJobManager::GetInstance().AddJob(job, nullptr, CJob::PRIORITY_NORMAL);
+    if (jobID)
+      jobIDs.push_back(jobID);
+    else
+    {
+      // job manager is shutting down, do the work ourselves
+      job->DoWork();
+      delete job;
+    }
+  }
+
+  while (!done.WaitMSec(100))
+  {
+    if (m_bStop)
+    {
+      // drop the jobs that didn't start yet, the running ones bail out after their current tag
+      for (unsigned int jobID : jobIDs)
+        CJobManager::GetInstance().CancelJob(jobID);
+      break;
+    }
+  }
+  // the jobs reference our stack, so wait for them even if we are stopped
+  done.Wait();
 }
 
 static bool SortSongsByTrack(const CSong& song, const CSong& song2)
@@ -841,8 +970,10 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
   MAPSONGS songsMap;
 
   // get all information for all files in current directory from database, and remove them
+  unsigned int tick = XbmcThreads::SystemClockMillis();
   if (m_musicDatabase.RemoveSongsFromPath(strDirectory, songsMap))
     m_needsCleanup = true;
+  m_databaseStage.Add(0, XbmcThreads::SystemClockMillis() - tick);
 
   CFileItemList scannedItems;
   if (ScanTags(items, scannedItems) == INFO_CANCELLED || scannedItems.Size() == 0)
@@ -865,6 +996,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
   */
 
   int numAdded = 0;
+  tick = XbmcThreads::SystemClockMillis();
 
   // Add all albums to the library, and hence any new song or album artists or other contributors
   for (VECALBUMS::iterator album = albums.begin(); album != albums.end(); ++album)
@@ -912,6 +1044,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
  
     numAdded += album->songs.size();
   }
+  m_databaseStage.Add(numAdded, XbmcThreads::SystemClockMillis() - tick);
 
   if (m_handle)
     m_handle->SetTitle(g_localizeStrings.Get(505));
@@ -183,6 +183,15 @@ protected:
    \param scannedItems [in] list to populate with the scannedItems
    */
   INFO_RET ScanTags(const CFileItemList& items, CFileItemList& scannedItems);
+
+  /*! \brief Load the tags of the given files
+   The tags are read by several jobs in parallel to hide the latency of the storage.
+   Returns once all jobs are finished. After Stop() was called the jobs that didn't start yet
+   are cancelled and the running ones return after the tag they are reading, so tags of the
+   remaining files are left unloaded.
+   \param items [in/out] list of FileItems to load the tags for
+   */
+  void LoadTags(const std::vector<CFileItemPtr>& items);
   int GetPathHash(const CFileItemList &items, std::string &hash);
   void GetAlbumArtwork(long id, const CAlbum &artist);
 
@@ -213,6 +222,9 @@ protected:
 
   std::set<std::string> m_seenPaths;
   int m_flags;
+  StageStats m_enumerateStage; ///< folders listed
+  StageStats m_tagStage;       ///< files whose tags were read
+  StageStats m_databaseStage;  ///< songs stored
   CThread m_fileCountReader;
 };
 }
@@ -851,8 +851,7 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t c
     pTexture->LoadToGPU();
     pTexture->BindToUnit(0);
 
-    glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_BLEND);          // Turn Blending On
+    renderSystem->SetBlend(true);
 
     renderSystem->EnableShader(SM_TEXTURE);
   }
@@ -956,8 +955,7 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t c
     pTexture->LoadToGPU();
     pTexture->BindToUnit(0);
 
-    glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_BLEND);          // Turn Blending On
+    renderSystem->SetBlend(true);
 
     renderSystem->EnableGUIShader(SM_TEXTURE);
   }
@@ -0,0 +1,209 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "InotifyWatcher.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+namespace
+{
+const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO |
+                            IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+bool IsNetworkFileSystem(const std::string &path)
+{
+  struct statfs fs;
+  if (statfs(path.c_str(), &fs) != 0)
+    return true;
+
+  switch (static_cast<uint32_t>(fs.f_type))
+  {
+  case 0x6969:     // NFS
+  case 0x517B:     // SMB
+  case 0xFF534D42: // CIFS
+  case 0xFE534D42: // SMB2
+  case 0x65735546: // FUSE (sshfs, ...)
+  case 0x01021997: // 9P
+  case 0x5346414F: // AFS
+  case 0x73757245: // CODA
+    return true;
+  default:
+    return false;
+  }
+}
+}
+
+CInotifyWatcher::CInotifyWatcher(XFILE::CChangeJournal &journal)
+  : CThread("InotifyWatcher"),
+    m_journal(journal)
+{
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0)
+    CLog::Log(LOGERROR, "CInotifyWatcher::%s - inotify_init1 failed (%s)", __FUNCTION__, strerror(errno));
+}
+
+CInotifyWatcher::~CInotifyWatcher()
+{
+  StopThread();
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+bool CInotifyWatcher::Watch(const std::string &path)
+{
+  if (m_fd < 0)
+    return false;
+
+  if (IsNetworkFileSystem(path))
+  {
+    CLog::Log(LOGDEBUG, "CInotifyWatcher::%s - not watching %s, it isn't on a local file system", __FUNCTION__, path.c_str());
+    return false;
+  }
+
+  std::vector<std::string> unwatched;
+  {
+    CSingleLock lock(m_critSection);
+    int wd = inotify_add_watch(m_fd, path.c_str(), WATCH_MASK);
+    if (wd < 0)
+    {
+      CLog::Log(LOGWARNING, "CInotifyWatcher::%s - unable to watch %s (%s)", __FUNCTION__, path.c_str(), strerror(errno));
+      return false;
+    }
+    m_folders[wd] = path;
+    AddWatches(path, unwatched);
+  }
+
+  for (const auto &folder : unwatched)
+    m_journal.MarkUnwatched(folder);
+
+  if (!IsRunning())
+    Create();
+  return true;
+}
+
+void CInotifyWatcher::AddWatches(const std::string &path, std::vector<std::string> &unwatched)
+{
+  DIR *dir = opendir(path.c_str());
+  if (!dir)
+  {
+    unwatched.push_back(path);
+    return;
+  }
+
+  while (struct dirent *entry = readdir(dir))
+  {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+      continue;
+
+    std::string folder = path + entry->d_name + "/";
+    if (entry->d_type == DT_LNK)
+    { // don't follow links, they may loop
+      unwatched.push_back(folder);
+      continue;
+    }
+    if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN)
+      continue;
+
+    int wd = inotify_add_watch(m_fd, folder.c_str(), WATCH_MASK);
+    if (wd < 0)
+    {
+      if (errno != ENOTDIR)
+      {
+        CLog::Log(LOGWARNING, "CInotifyWatcher::%s - unable to watch %s (%s)", __FUNCTION__, folder.c_str(), strerror(errno));
+        unwatched.push_back(folder);
+      }
+      continue;
+    }
+    m_folders[wd] = folder;
+    AddWatches(folder, unwatched);
+  }
+  closedir(dir);
+}
+
+void CInotifyWatcher::Process()
+{
+  char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+  while (!m_bStop)
+  {
+    struct pollfd pfd = { m_fd, POLLIN, 0 };
+    if (poll(&pfd, 1, 500) <= 0)
+      continue;
+
+    ssize_t len = read(m_fd, buffer, sizeof(buffer));
+    if (len <= 0)
+      continue;
+
+    for (char *ptr = buffer; ptr < buffer + len; )
+    {
+      const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(ptr);
+      HandleEvent(event);
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+}
+
+void CInotifyWatcher::HandleEvent(const struct inotify_event *event)
+{
+  if (event->mask & IN_Q_OVERFLOW)
+  {
+    m_journal.MarkAllDirty();
+    return;
+  }
+
+  std::string folder;
+  std::vector<std::string> unwatched;
+  {
+    CSingleLock lock(m_critSection);
+    std::map<int, std::string>::iterator it = m_folders.find(event->wd);
+    if (it == m_folders.end())
+      return;
+    folder = it->second;
+
+    if (event->mask & IN_IGNORED)
+      m_folders.erase(it);
+    else if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)) && event->len > 0)
+    { // watch new folders, and anything moved in with them
+      std::string subfolder = folder + event->name + "/";
+      int wd = inotify_add_watch(m_fd, subfolder.c_str(), WATCH_MASK);
+      if (wd < 0)
+        unwatched.push_back(subfolder);
+      else
+      {
+        m_folders[wd] = subfolder;
+        AddWatches(subfolder, unwatched);
+      }
+    }
+  }
+
+  m_journal.MarkDirty(folder);
+  if ((event->mask & IN_ISDIR) && event->len > 0)
+    m_journal.MarkDirty(folder + event->name + "/");
+  for (const auto &path : unwatched)
+    m_journal.MarkUnwatched(path);
+}
@@ -0,0 +1,58 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/ChangeJournal.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+struct inotify_event;
+
+/*!
+ \brief Watch local folders with inotify and report their changes to a CChangeJournal
+
+ Every folder below a watched folder gets its own inotify watch, including
+ folders created later on. Folders on network file systems are refused as
+ inotify doesn't see changes made by other hosts.
+ */
+class CInotifyWatcher : public XFILE::IDirectoryWatcher, private CThread
+{
+public:
+  explicit CInotifyWatcher(XFILE::CChangeJournal &journal);
+  ~CInotifyWatcher() override;
+
+  bool Watch(const std::string &path) override;
+
+protected:
+  void Process() override;
+
+private:
+  void AddWatches(const std::string &path, std::vector<std::string> &unwatched);
+  void HandleEvent(const struct inotify_event *event);
+
+  XFILE::CChangeJournal &m_journal;
+  int m_fd;
+  std::map<int, std::string> m_folders; ///< watched folder of each watch descriptor
+  CCriticalSection m_critSection;
+};
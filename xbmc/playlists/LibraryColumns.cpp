@@ -0,0 +1,337 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LibraryColumns.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+typedef CDatabaseQueryRule DQR;
+
+namespace
+{
+
+bool ParseNumber(const std::string &parameter, double &value)
+{
+  // the rule SQL interprets empty parameters as 0
+  if (parameter.empty())
+  {
+    value = 0.0;
+    return true;
+  }
+
+  std::istringstream stream(parameter);
+  stream.imbue(std::locale::classic());
+  stream >> value;
+  return !stream.fail() && stream.eof();
+}
+
+// ASCII case-insensitive comparison, which is what LIKE does in sqlite
+inline bool EqualsNoCase(const char *a, const char *b, size_t length)
+{
+  for (size_t i = 0; i < length; ++i)
+  {
+    char ca = a[i], cb = b[i];
+    if (ca >= 'A' && ca <= 'Z')
+      ca += 'a' - 'A';
+    if (cb >= 'A' && cb <= 'Z')
+      cb += 'a' - 'A';
+    if (ca != cb)
+      return false;
+  }
+  return true;
+}
+
+bool Like(const std::string &value, const std::string &parameter, DQR::SEARCH_OPERATOR op)
+{
+  if (parameter.size() > value.size())
+    return false;
+
+  switch (op)
+  {
+  case DQR::OPERATOR_CONTAINS:
+  case DQR::OPERATOR_DOES_NOT_CONTAIN:
+    for (size_t i = 0; i + parameter.size() <= value.size(); ++i)
+    {
+      if (EqualsNoCase(value.c_str() + i, parameter.c_str(), parameter.size()))
+        return true;
+    }
+    return false;
+  case DQR::OPERATOR_EQUALS:
+  case DQR::OPERATOR_DOES_NOT_EQUAL:
+    return value.size() == parameter.size() && EqualsNoCase(value.c_str(), parameter.c_str(), parameter.size());
+  case DQR::OPERATOR_STARTS_WITH:
+    return EqualsNoCase(value.c_str(), parameter.c_str(), parameter.size());
+  case DQR::OPERATOR_ENDS_WITH:
+    return EqualsNoCase(value.c_str() + value.size() - parameter.size(), parameter.c_str(), parameter.size());
+  default:
+    return false;
+  }
+}
+
+} // anonymous namespace
+
+CLibraryColumns::Item::Item()
+  : id(-1)
+{
+  std::fill(numbers, numbers + NumberColumnCount, std::numeric_limits<double>::quiet_NaN());
+}
+
+void CLibraryColumns::Clear()
+{
+  *this = CLibraryColumns();
+}
+
+void CLibraryColumns::Add(const Item &item)
+{
+  Remove(item.id);
+
+  uint32_t row = static_cast<uint32_t>(m_ids.size());
+  m_ids.push_back(item.id);
+  m_live.push_back(1);
+  m_index[item.id] = row;
+
+  for (int column = 0; column < NumberColumnCount; ++column)
+    m_numbers[column].push_back(item.numbers[column]);
+
+  for (int column = 0; column < TextColumnCount; ++column)
+  {
+    Dictionary &dictionary = m_texts[column];
+    for (const auto &value : item.texts[column])
+    {
+      auto it = dictionary.codes.find(value);
+      if (it == dictionary.codes.end())
+      {
+        it = dictionary.codes.insert(std::make_pair(value, static_cast<uint32_t>(dictionary.values.size()))).first;
+        dictionary.values.push_back(value);
+      }
+      dictionary.rows.push_back(it->second);
+    }
+    dictionary.offsets.push_back(static_cast<uint32_t>(dictionary.rows.size()));
+  }
+}
+
+void CLibraryColumns::Remove(int id)
+{
+  auto it = m_index.find(id);
+  if (it == m_index.end())
+    return;
+
+  m_live[it->second] = 0;
+  m_index.erase(it);
+}
+
+CLibraryColumns::Item CLibraryColumns::GetItem(uint32_t row) const
+{
+  Item item;
+  item.id = m_ids[row];
+  for (int column = 0; column < NumberColumnCount; ++column)
+    item.numbers[column] = m_numbers[column][row];
+  for (int column = 0; column < TextColumnCount; ++column)
+  {
+    const Dictionary &dictionary = m_texts[column];
+    for (uint32_t i = dictionary.offsets[row]; i < dictionary.offsets[row + 1]; ++i)
+      item.texts[column].push_back(dictionary.values[dictionary.rows[i]]);
+  }
+  return item;
+}
+
+void CLibraryColumns::Compact()
+{
+  CLibraryColumns compacted;
+  for (uint32_t row = 0; row < m_ids.size(); ++row)
+  {
+    if (m_live[row])
+      compacted.Add(GetItem(row));
+  }
+  *this = std::move(compacted);
+}
+
+CLibraryColumns::Mask CLibraryColumns::All() const
+{
+  return m_live;
+}
+
+bool CLibraryColumns::Match(NumberColumn column, DQR::SEARCH_OPERATOR op,
+                            const std::vector<std::string> &parameters, bool nullMatches, Mask &mask) const
+{
+  std::vector<double> values;
+  for (const auto &parameter : parameters)
+  {
+    double value;
+    if (!ParseNumber(parameter, value))
+      return false;
+    values.push_back(value);
+  }
+
+  if (op == DQR::OPERATOR_BETWEEN && values.size() != 2)
+    return false;
+  if (op != DQR::OPERATOR_EQUALS && op != DQR::OPERATOR_DOES_NOT_EQUAL &&
+      op != DQR::OPERATOR_GREATER_THAN && op != DQR::OPERATOR_LESS_THAN &&
+      op != DQR::OPERATOR_BETWEEN)
+    return false;
+
+  const std::vector<double> &numbers = m_numbers[column];
+  mask.assign(m_ids.size(), 0);
+  for (size_t row = 0; row < numbers.size(); ++row)
+  {
+    if (!m_live[row])
+      continue;
+
+    const double number = numbers[row];
+    bool match = false;
+    if (std::isnan(number))
+      match = nullMatches;
+    else if (op == DQR::OPERATOR_BETWEEN)
+      match = number >= values[0] && number <= values[1];
+    else
+    {
+      for (double value : values)
+      {
+        switch (op)
+        {
+        case DQR::OPERATOR_EQUALS:        match = number == value; break;
+        case DQR::OPERATOR_DOES_NOT_EQUAL: match = number != value; break;
+        case DQR::OPERATOR_GREATER_THAN:  match = number > value; break;
+        default:                          match = number < value; break;
+        }
+        if (match)
+          break;
+      }
+    }
+    mask[row] = match ? 1 : 0;
+  }
+  return true;
+}
+
+bool CLibraryColumns::Match(TextColumn column, DQR::SEARCH_OPERATOR op,
+                            const std::vector<std::string> &parameters, Mask &mask) const
+{
+  bool negate = false;
+  switch (op)
+  {
+  case DQR::OPERATOR_DOES_NOT_CONTAIN:
+  case DQR::OPERATOR_DOES_NOT_EQUAL:
+    negate = true;
+    break;
+  case DQR::OPERATOR_CONTAINS:
+  case DQR::OPERATOR_EQUALS:
+  case DQR::OPERATOR_STARTS_WITH:
+  case DQR::OPERATOR_ENDS_WITH:
+    break;
+  default:
+    return false;
+  }
+
+  // wildcards and escapes inside a parameter would need a real LIKE implementation
+  for (const auto &parameter : parameters)
+  {
+    if (parameter.find_first_of("%_\\") != std::string::npos)
+      return false;
+  }
+
+  // evaluate the condition once per distinct value instead of once per row
+  const Dictionary &dictionary = m_texts[column];
+  std::vector<uint8_t> matches(dictionary.values.size(), 0);
+  for (size_t code = 0; code < dictionary.values.size(); ++code)
+  {
+    for (const auto &parameter : parameters)
+    {
+      if (Like(dictionary.values[code], parameter, op))
+      {
+        matches[code] = 1;
+        break;
+      }
+    }
+  }
+
+  mask.assign(m_ids.size(), 0);
+  for (size_t row = 0; row < m_ids.size(); ++row)
+  {
+    if (!m_live[row])
+      continue;
+
+    bool any = false;
+    for (uint32_t i = dictionary.offsets[row]; i < dictionary.offsets[row + 1] && !any; ++i)
+      any = matches[dictionary.rows[i]] != 0;
+    mask[row] = any != negate ? 1 : 0;
+  }
+  return true;
+}
+
+int CLibraryColumns::CountDistinct(TextColumn column, const Mask &mask, bool ignoreEmpty /* = false */) const
+{
+  const Dictionary &dictionary = m_texts[column];
+  std::vector<uint8_t> seen(dictionary.values.size(), 0);
+  if (ignoreEmpty)
+  {
+    auto empty = dictionary.codes.find("");
+    if (empty != dictionary.codes.end())
+      seen[empty->second] = 1;
+  }
+
+  int count = 0;
+  for (size_t row = 0; row < mask.size(); ++row)
+  {
+    if (!mask[row])
+      continue;
+
+    for (uint32_t i = dictionary.offsets[row]; i < dictionary.offsets[row + 1]; ++i)
+    {
+      uint8_t &flag = seen[dictionary.rows[i]];
+      if (!flag)
+      {
+        flag = 1;
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+int CLibraryColumns::Count(const Mask &mask) const
+{
+  return static_cast<int>(std::count(mask.begin(), mask.end(), 1));
+}
+
+void CLibraryColumns::GetIds(const Mask &mask, std::vector<int> &ids) const
+{
+  ids.clear();
+  for (size_t row = 0; row < mask.size(); ++row)
+  {
+    if (mask[row])
+      ids.push_back(m_ids[row]);
+  }
+}
+
+void CLibraryColumns::And(Mask &mask, const Mask &other)
+{
+  for (size_t i = 0; i < mask.size(); ++i)
+    mask[i] &= other[i];
+}
+
+void CLibraryColumns::Or(Mask &mask, const Mask &other)
+{
+  for (size_t i = 0; i < mask.size(); ++i)
+    mask[i] |= other[i];
+}
@@ -0,0 +1,127 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dbwrappers/DatabaseQuery.h"
+
+/*!
+ \brief Columnar in-memory snapshot of the items of one library media type.
+
+ Number columns hold one value per item with NaN standing in for NULL, so
+ comparisons behave like their SQL counterparts. Text columns are dictionary
+ encoded and may hold several values per item (e.g. the genres of a song).
+ Conditions are evaluated as scans over whole columns into a row mask.
+ */
+class CLibraryColumns
+{
+public:
+  enum NumberColumn
+  {
+    ColumnYear = 0,
+    ColumnRating,
+    ColumnUserRating,
+    ColumnPlaycount,
+    NumberColumnCount
+  };
+
+  enum TextColumn
+  {
+    ColumnGenre = 0,
+    ColumnArtist,
+    TextColumnCount
+  };
+
+  struct Item
+  {
+    Item();
+
+    int id;
+    double numbers[NumberColumnCount];
+    std::vector<std::string> texts[TextColumnCount];
+  };
+
+  typedef std::vector<uint8_t> Mask;
+
+  CLibraryColumns() = default;
+
+  void Clear();
+
+  /*! \brief Add an item, replacing any earlier item with the same id */
+  void Add(const Item &item);
+  void Remove(int id);
+
+  /*! \brief Number of items held */
+  size_t Size() const { return m_index.size(); }
+  /*! \brief Whether enough rows were replaced or removed to make Compact() worthwhile */
+  bool IsFragmented() const { return m_ids.size() > 1024 && m_index.size() < m_ids.size() * 3 / 4; }
+  /*! \brief Drop replaced and removed rows and unused dictionary values */
+  void Compact();
+
+  /*! \brief Mask selecting all current items */
+  Mask All() const;
+  /*! \brief Mask selecting nothing */
+  Mask None() const { return Mask(m_ids.size(), 0); }
+
+  /*! \brief Evaluate a rule on a number column.
+   \param nullMatches whether NULL values match as well
+   \return false if the rule can't be evaluated the way SQL would
+   */
+  bool Match(NumberColumn column, CDatabaseQueryRule::SEARCH_OPERATOR op,
+             const std::vector<std::string> &parameters, bool nullMatches, Mask &mask) const;
+  /*! \brief Evaluate a rule on a text column, matching SQL LIKE semantics.
+   An item matches if any of its values matches, negated operators match
+   items none of whose values match.
+   \return false if the rule can't be evaluated the way SQL would
+   */
+  bool Match(TextColumn column, CDatabaseQueryRule::SEARCH_OPERATOR op,
+             const std::vector<std::string> &parameters, Mask &mask) const;
+
+  /*! \brief Number of distinct values of a text column over the masked items
+   \param ignoreEmpty whether empty values are left out of the count
+   */
+  int CountDistinct(TextColumn column, const Mask &mask, bool ignoreEmpty = false) const;
+  int Count(const Mask &mask) const;
+  void GetIds(const Mask &mask, std::vector<int> &ids) const;
+
+  static void And(Mask &mask, const Mask &other);
+  static void Or(Mask &mask, const Mask &other);
+
+private:
+  Item GetItem(uint32_t row) const;
+
+  struct Dictionary
+  {
+    std::vector<std::string> values;
+    std::unordered_map<std::string, uint32_t> codes;
+    std::vector<uint32_t> offsets = std::vector<uint32_t>(1, 0); // per row into codes
+    std::vector<uint32_t> rows;                                // codes of all rows
+  };
+
+  std::vector<int> m_ids;
+  std::vector<uint8_t> m_live;
+  std::unordered_map<int, uint32_t> m_index; // id -> row
+  std::vector<double> m_numbers[NumberColumnCount];
+  Dictionary m_texts[TextColumnCount];
+};
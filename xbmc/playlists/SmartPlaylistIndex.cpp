@@ -0,0 +1,504 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SmartPlaylistIndex.h"
+
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+#include "GUIPassword.h"
+#include "ServiceBroker.h"
+#include "SmartPlayList.h"
+#include "dbwrappers/dataset.h"
+#include "interfaces/AnnouncementManager.h"
+#include "media/MediaType.h"
+#include "music/MusicDatabase.h"
+#include "profiles/ProfilesManager.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+
+// reloading more items than this one by one is slower than a full reload
+#define MAX_PENDING_ITEMS 500
+// longer id lists are left to the smart playlist SQL
+#define MAX_WHERE_IDS 20000
+
+namespace
+{
+
+struct TextQuery
+{
+  CLibraryColumns::TextColumn column;
+  const char *sql;
+  const char *idField;
+};
+
+std::string GetIdFilter(const char *idField, const std::set<int> &ids)
+{
+  if (ids.empty())
+    return "";
+
+  std::vector<std::string> values;
+  values.reserve(ids.size());
+  for (int id : ids)
+    values.push_back(StringUtils::Format("%i", id));
+  return StringUtils::Format(" WHERE %s IN (%s)", idField, StringUtils::Join(values, ",").c_str());
+}
+
+/*!
+ \brief Load all items or the given items from the database.
+ The first query returns the id of an item followed by one value per number
+ column, every text query returns pairs of item id and value.
+ */
+bool LoadItems(dbiplus::Database &db, const char *numbers, const char *idField,
+               const std::vector<TextQuery> &texts, const std::set<int> &ids,
+               std::vector<CLibraryColumns::Item> &items)
+{
+  std::unordered_map<int, size_t> rows;
+
+  std::unique_ptr<dbiplus::Dataset> ds(db.CreateDataset());
+  if (ds == nullptr)
+    return false;
+
+  try
+  {
+    if (!ds->query_stream(numbers + GetIdFilter(idField, ids)))
+      return false;
+    while (!ds->eof())
+    {
+      CLibraryColumns::Item item;
+      item.id = ds->fv(0).get_asInt();
+      for (int column = 0; column < CLibraryColumns::NumberColumnCount; ++column)
+      {
+        const dbiplus::field_value &value = ds->fv(column + 1);
+        if (!value.get_isNull())
+          item.numbers[column] = value.get_asDouble();
+      }
+      rows[item.id] = items.size();
+      items.push_back(std::move(item));
+      ds->next();
+    }
+    ds->close();
+
+    for (const auto &text : texts)
+    {
+      if (!ds->query_stream(text.sql + GetIdFilter(text.idField, ids)))
+        return false;
+      while (!ds->eof())
+      {
+        auto row = rows.find(ds->fv(0).get_asInt());
+        if (row != rows.end())
+          items[row->second].texts[text.column].push_back(ds->fv(1).get_asString());
+        ds->next();
+      }
+      ds->close();
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    return false;
+  }
+
+  return true;
+}
+
+/*!
+ \brief Put loaded items into the columns.
+ \param ids the items that were loaded, all items if empty
+ */
+void ApplyItems(const std::set<int> &ids, const std::vector<CLibraryColumns::Item> &items, CLibraryColumns &columns)
+{
+  if (ids.empty())
+    columns.Clear();
+  else
+  {
+    // items that are gone from the database aren't returned at all
+    for (int id : ids)
+      columns.Remove(id);
+  }
+
+  for (const auto &item : items)
+    columns.Add(item);
+  if (columns.IsFragmented())
+    columns.Compact();
+}
+
+} // anonymous namespace
+
+CSmartPlaylistIndex& CSmartPlaylistIndex::GetInstance()
+{
+  static CSmartPlaylistIndex sIndex;
+  return sIndex;
+}
+
+bool CSmartPlaylistIndex::CountDistinct(const CSmartPlaylist &filter, const std::string &baseDir, Field field, int &count)
+{
+  const std::string &type = filter.GetType();
+  if ((type != "songs" || baseDir != "musicdb://songs/") &&
+      (type != "movies" || baseDir != "videodb://movies/titles/"))
+    return false;
+
+  // locked video sources are filtered by path which isn't part of the index
+  if (type == "movies" &&
+      CServiceBroker::GetProfileManager().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE &&
+      !g_passwordManager.bMasterUser)
+    return false;
+
+  CLibraryColumns::TextColumn column;
+  if (field == FieldGenre)
+    column = CLibraryColumns::ColumnGenre;
+  else if (field == FieldArtist && type == "songs")
+    column = CLibraryColumns::ColumnArtist;
+  else
+    return false;
+
+  // without any conditions the database lists all values, even unused ones
+  if (filter.m_ruleCombination.empty())
+    return false;
+
+  CSingleLock lock(m_section);
+  Table *table = GetTable(type);
+  if (table == nullptr || !Prepare(type, *table))
+    return false;
+
+  CLibraryColumns::Mask mask;
+  if (!Evaluate(table->columns, type, filter.m_ruleCombination, mask))
+    return false;
+
+  // music listings skip empty values, video listings count them
+  count = table->columns.CountDistinct(column, mask, type == "songs");
+  return true;
+}
+
+bool CSmartPlaylistIndex::GetWhereClause(const CSmartPlaylist &playlist, std::string &where)
+{
+  const std::string &type = playlist.GetType();
+  if (type != "songs" && type != "movies")
+    return false;
+
+  if (playlist.m_ruleCombination.empty())
+    return false;
+
+  std::vector<int> ids;
+  {
+    CSingleLock lock(m_section);
+    Table *table = GetTable(type);
+    if (!Prepare(type, *table))
+      return false;
+
+    CLibraryColumns::Mask mask;
+    if (!Evaluate(table->columns, type, playlist.m_ruleCombination, mask))
+      return false;
+
+    // the condition would get too long for the database to parse
+    if (table->columns.Count(mask) > MAX_WHERE_IDS)
+      return false;
+    table->columns.GetIds(mask, ids);
+  }
+
+  if (ids.empty())
+  {
+    where = "1 = 0";
+    return true;
+  }
+
+  std::vector<std::string> values;
+  values.reserve(ids.size());
+  for (int id : ids)
+    values.push_back(StringUtils::Format("%i", id));
+  where = DatabaseUtils::GetField(FieldId, type == "songs" ? MediaTypeSong : MediaTypeMovie, DatabaseQueryPartWhere) +
+          " IN (" + StringUtils::Join(values, ",") + ")";
+  return true;
+}
+
+void CSmartPlaylistIndex::Deinitialize()
+{
+  CSingleLock lock(m_section);
+  if (m_isAnnounced)
+  {
+    ANNOUNCEMENT::CAnnouncementManager::GetInstance().RemoveAnnouncer(this);
+    m_isAnnounced = false;
+  }
+
+  Invalidate(m_songs);
+  Invalidate(m_movies);
+}
+
+void CSmartPlaylistIndex::Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+{
+  if ((flag & (ANNOUNCEMENT::VideoLibrary | ANNOUNCEMENT::AudioLibrary)) == 0)
+    return;
+
+  CSingleLock lock(m_section);
+  Table &table = (flag & ANNOUNCEMENT::AudioLibrary) ? m_songs : m_movies;
+  if (!table.loaded && table.loading == 0)
+    return;
+
+  // anything changed in bulk is simply reloaded on the next query
+  if (strcmp(message, "OnScanFinished") == 0 ||
+      strcmp(message, "OnCleanFinished") == 0 ||
+      (data.isMember("transaction") && data["transaction"].asBoolean()))
+  {
+    Invalidate(table);
+    return;
+  }
+
+  const CVariant &item = data.isMember("item") ? data["item"] : data;
+  if (!item.isMember("type") || !item.isMember("id"))
+    return;
+
+  const std::string itemType = item["type"].asString();
+  const int id = static_cast<int>(item["id"].asInteger());
+  const char *tableType = &table == &m_songs ? MediaTypeSong : MediaTypeMovie;
+  if (itemType != tableType)
+  {
+    // artist and album changes may touch the values of any song
+    if (&table == &m_songs && (itemType == MediaTypeArtist || itemType == MediaTypeAlbum))
+      Invalidate(table);
+    return;
+  }
+
+  if (strcmp(message, "OnRemove") == 0)
+  {
+    table.updates++;
+    table.columns.Remove(id);
+    // a running load may still return the item
+    if (table.loading > 0)
+      table.pending.insert(id);
+    else
+      table.pending.erase(id);
+  }
+  else if (strcmp(message, "OnUpdate") == 0)
+  {
+    table.updates++;
+    table.pending.insert(id);
+    if (table.pending.size() > MAX_PENDING_ITEMS)
+      Invalidate(table);
+  }
+}
+
+CSmartPlaylistIndex::Table* CSmartPlaylistIndex::GetTable(const std::string &type)
+{
+  if (type == "songs")
+    return &m_songs;
+  if (type == "movies")
+    return &m_movies;
+  return nullptr;
+}
+
+void CSmartPlaylistIndex::Invalidate(Table &table)
+{
+  table.columns.Clear();
+  table.pending.clear();
+  table.loaded = false;
+  table.generation++;
+}
+
+bool CSmartPlaylistIndex::Prepare(const std::string &type, Table &table)
+{
+  if (!m_isAnnounced)
+  {
+    ANNOUNCEMENT::CAnnouncementManager::GetInstance().AddAnnouncer(this);
+    m_isAnnounced = true;
+  }
+
+  const int profileId = CServiceBroker::GetProfileManager().GetCurrentProfileId();
+  if (table.loaded && table.profileId != profileId)
+    Invalidate(table);
+
+  if (table.loaded && table.pending.empty())
+    return true;
+
+  const std::set<int> ids = table.loaded ? table.pending : std::set<int>();
+  const unsigned int generation = table.generation;
+  const unsigned int updates = table.updates;
+  std::vector<CLibraryColumns::Item> items;
+  bool loaded = false;
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  table.loading++;
+  {
+    // don't block announcements and other queries on the database
+    CSingleExit exit(m_section);
+    if (type == "songs")
+    {
+      CMusicDatabase db;
+      loaded = db.Open() && LoadSongs(*db.m_pDB, ids, items);
+    }
+    else
+    {
+      CVideoDatabase db;
+      loaded = db.Open() && LoadMovies(*db.m_pDB, ids, items);
+    }
+  }
+  table.loading--;
+
+  // the snapshot was dropped while loading, the result may be stale
+  if (table.generation != generation)
+    return false;
+
+  if (!loaded)
+  {
+    Invalidate(table);
+    return false;
+  }
+
+  ApplyItems(ids, items, table.columns);
+
+  if (ids.empty())
+    CLog::Log(LOGDEBUG, "%s loaded %u %s in %u ms", __FUNCTION__,
+              static_cast<unsigned int>(table.columns.Size()), type.c_str(),
+              XbmcThreads::SystemClockMillis() - start);
+
+  table.loaded = true;
+  table.profileId = profileId;
+  // items changed while loading may have been read before the change
+  if (table.updates == updates)
+    table.pending.clear();
+  return true;
+}
+
+bool CSmartPlaylistIndex::LoadSongs(dbiplus::Database &db, const std::set<int> &ids, std::vector<CLibraryColumns::Item> &items)
+{
+  // the values have to be what the smart playlist rules compare against
+  static const std::vector<TextQuery> texts = {
+    { CLibraryColumns::ColumnGenre,
+      "SELECT song_genre.idSong, genre.strGenre FROM song_genre JOIN genre ON genre.idGenre = song_genre.idGenre",
+      "song_genre.idSong" },
+    { CLibraryColumns::ColumnArtist,
+      "SELECT song_artist.idSong, artist.strArtist FROM song_artist JOIN artist ON artist.idArtist = song_artist.idArtist",
+      "song_artist.idSong" }
+  };
+
+  return LoadItems(db, "SELECT songview.idSong, CAST(songview.iYear as DECIMAL(5,1)), songview.rating, songview.userrating, "
+                       "CAST(songview.iTimesPlayed as DECIMAL(5,1)) FROM songview",
+                   "songview.idSong", texts, ids, items);
+}
+
+bool CSmartPlaylistIndex::LoadMovies(dbiplus::Database &db, const std::set<int> &ids, std::vector<CLibraryColumns::Item> &items)
+{
+  // the values have to be what the smart playlist rules compare against
+  static const std::vector<TextQuery> texts = {
+    { CLibraryColumns::ColumnGenre,
+      "SELECT genre_link.media_id, genre.name FROM genre_link JOIN genre ON genre.genre_id = genre_link.genre_id AND genre_link.media_type = 'movie'",
+      "genre_link.media_id" }
+  };
+
+  return LoadItems(db, "SELECT movie_view.idMovie, CAST(movie_view.premiered as DECIMAL(5,1)), movie_view.rating, movie_view.userrating, "
+                       "CAST(movie_view.playCount as DECIMAL(5,1)) FROM movie_view",
+                   "movie_view.idMovie", texts, ids, items);
+}
+
+bool CSmartPlaylistIndex::Evaluate(const CLibraryColumns &columns, const std::string &type,
+                                   const CDatabaseQueryRuleCombination &combination, CLibraryColumns::Mask &mask)
+{
+  const bool matchAll = combination.GetType() == CDatabaseQueryRuleCombination::CombinationAnd;
+  mask = matchAll ? columns.All() : columns.None();
+
+  bool empty = true;
+  CLibraryColumns::Mask current;
+  for (const auto &child : combination.m_combinations)
+  {
+    if (!Evaluate(columns, type, *child, current))
+      return false;
+    if (matchAll)
+      CLibraryColumns::And(mask, current);
+    else
+      CLibraryColumns::Or(mask, current);
+    empty = false;
+  }
+
+  for (const auto &rule : combination.m_rules)
+  {
+    // virtual folders aren't part of the query
+    if (rule->m_field == FieldVirtualFolder)
+      continue;
+
+    empty = false;
+    // rules without a condition don't restrict anything
+    if (rule->m_parameter.empty() ||
+        (rule->m_operator == CDatabaseQueryRule::OPERATOR_BETWEEN && rule->m_parameter.size() != 2))
+      continue;
+
+    if (!Evaluate(columns, type, *rule, current))
+      return false;
+    if (matchAll)
+      CLibraryColumns::And(mask, current);
+    else
+      CLibraryColumns::Or(mask, current);
+  }
+
+  // the database wouldn't accept an empty condition either
+  return !empty;
+}
+
+bool CSmartPlaylistIndex::Evaluate(const CLibraryColumns &columns, const std::string &type,
+                                   const CDatabaseQueryRule &rule, CLibraryColumns::Mask &mask)
+{
+  switch (rule.m_field)
+  {
+  case FieldGenre:
+    return columns.Match(CLibraryColumns::ColumnGenre, rule.m_operator, rule.m_parameter, mask);
+  case FieldArtist:
+    return type == "songs" && columns.Match(CLibraryColumns::ColumnArtist, rule.m_operator, rule.m_parameter, mask);
+  case FieldYear:
+  case FieldRating:
+  case FieldUserRating:
+  case FieldPlaycount:
+    break;
+  default:
+    return false;
+  }
+
+  CLibraryColumns::NumberColumn column = CLibraryColumns::ColumnYear;
+  if (rule.m_field == FieldRating)
+    column = CLibraryColumns::ColumnRating;
+  else if (rule.m_field == FieldUserRating)
+    column = CLibraryColumns::ColumnUserRating;
+  else if (rule.m_field == FieldPlaycount)
+    column = CLibraryColumns::ColumnPlaycount;
+
+  if (rule.m_operator == CDatabaseQueryRule::OPERATOR_BETWEEN)
+    return columns.Match(column, rule.m_operator, rule.m_parameter, false, mask);
+
+  // every parameter is a separate condition as NULL handling depends on its value
+  mask = columns.None();
+  CLibraryColumns::Mask current;
+  for (const auto &parameter : rule.m_parameter)
+  {
+    // empty parameters match NULL as well
+    bool nullMatches = parameter.empty();
+    // the video database stores unplayed items with a NULL playcount
+    if (rule.m_field == FieldPlaycount && type == "movies")
+      nullMatches = nullMatches ||
+                    (rule.m_operator == CDatabaseQueryRule::OPERATOR_EQUALS && parameter == "0") ||
+                    (rule.m_operator == CDatabaseQueryRule::OPERATOR_DOES_NOT_EQUAL && parameter != "0") ||
+                    rule.m_operator == CDatabaseQueryRule::OPERATOR_LESS_THAN;
+
+    if (!columns.Match(column, rule.m_operator, std::vector<std::string>(1, parameter), nullMatches, current))
+      return false;
+    CLibraryColumns::Or(mask, current);
+  }
+  return true;
+}
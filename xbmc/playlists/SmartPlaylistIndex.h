@@ -0,0 +1,109 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "LibraryColumns.h"
+#include "interfaces/IAnnouncer.h"
+#include "threads/CriticalSection.h"
+#include "utils/DatabaseUtils.h"
+
+class CDatabaseQueryRuleCombination;
+class CSmartPlaylist;
+
+namespace dbiplus
+{
+  class Database;
+}
+
+/*!
+ \brief In-memory columnar index answering filter queries without SQL.
+
+ Keeps a CLibraryColumns snapshot of the songs and movies in the library
+ which is loaded on first use and kept up to date through library
+ announcements. Only the fields held in CLibraryColumns and the operators
+ it supports can be evaluated, every other filter has to be run through
+ the database as usual.
+ */
+class CSmartPlaylistIndex : public ANNOUNCEMENT::IAnnouncer
+{
+public:
+  static CSmartPlaylistIndex& GetInstance();
+
+  /*!
+   \brief Count the distinct values of a field over the items matching a filter.
+   \param filter the filter to apply
+   \param baseDir the library path the filter is applied to
+   \param field the field whose values to count
+   \param count the number of distinct values
+   \return false if the filter can't be evaluated from the index
+   */
+  bool CountDistinct(const CSmartPlaylist &filter, const std::string &baseDir, Field field, int &count);
+
+  /*!
+   \brief Evaluate the rules of a smart playlist into a condition on item ids.
+   The condition replaces the one built by CSmartPlaylist::GetWhereClause().
+   \param playlist the smart playlist whose rules to evaluate
+   \param where the condition selecting the matching items
+   \return false if the rules can't be evaluated from the index
+   */
+  bool GetWhereClause(const CSmartPlaylist &playlist, std::string &where);
+
+  /*! \brief Stop listening to library announcements and drop the snapshots */
+  void Deinitialize();
+
+  void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override;
+
+private:
+  CSmartPlaylistIndex() = default;
+  CSmartPlaylistIndex(const CSmartPlaylistIndex&) = delete;
+  CSmartPlaylistIndex& operator=(const CSmartPlaylistIndex&) = delete;
+
+  struct Table
+  {
+    CLibraryColumns columns;
+    bool loaded = false;
+    int profileId = -1;
+    std::set<int> pending;      // items to reload before the next query
+    unsigned int generation = 0; // bumped whenever the snapshot is dropped
+    unsigned int updates = 0;    // bumped on every item change
+    int loading = 0;             // loads running outside the lock
+  };
+
+  Table* GetTable(const std::string &type);
+  bool Prepare(const std::string &type, Table &table);
+  static void Invalidate(Table &table);
+
+  static bool Evaluate(const CLibraryColumns &columns, const std::string &type,
+                       const CDatabaseQueryRuleCombination &combination, CLibraryColumns::Mask &mask);
+  static bool Evaluate(const CLibraryColumns &columns, const std::string &type,
+                       const CDatabaseQueryRule &rule, CLibraryColumns::Mask &mask);
+
+  static bool LoadSongs(dbiplus::Database &db, const std::set<int> &ids, std::vector<CLibraryColumns::Item> &items);
+  static bool LoadMovies(dbiplus::Database &db, const std::set<int> &ids, std::vector<CLibraryColumns::Item> &items);
+
+  CCriticalSection m_section;
+  bool m_isAnnounced = false;
+  Table m_songs;
+  Table m_movies;
+};
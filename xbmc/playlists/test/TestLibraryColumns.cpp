@@ -0,0 +1,145 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "playlists/LibraryColumns.h"
+
+#include <limits>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+typedef CDatabaseQueryRule DQR;
+
+CLibraryColumns::Item MakeItem(int id, double year, double playcount, const std::vector<std::string> &genres)
+{
+  CLibraryColumns::Item item;
+  item.id = id;
+  item.numbers[CLibraryColumns::ColumnYear] = year;
+  item.numbers[CLibraryColumns::ColumnPlaycount] = playcount;
+  item.texts[CLibraryColumns::ColumnGenre] = genres;
+  return item;
+}
+
+std::vector<int> Ids(const CLibraryColumns &columns, const CLibraryColumns::Mask &mask)
+{
+  std::vector<int> ids;
+  columns.GetIds(mask, ids);
+  return ids;
+}
+
+class TestLibraryColumns : public testing::Test
+{
+protected:
+  TestLibraryColumns()
+  {
+    const double null = std::numeric_limits<double>::quiet_NaN();
+    columns.Add(MakeItem(1, 1999, 0, { "Rock", "Pop" }));
+    columns.Add(MakeItem(2, 2005, 3, { "Jazz" }));
+    columns.Add(MakeItem(3, 2010, null, { "Pop Rock" }));
+    columns.Add(MakeItem(4, 2015, 1, { }));
+  }
+
+  CLibraryColumns columns;
+};
+
+} // anonymous namespace
+
+TEST_F(TestLibraryColumns, MatchNumbers)
+{
+  CLibraryColumns::Mask mask;
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnYear, DQR::OPERATOR_GREATER_THAN, { "2005" }, false, mask));
+  EXPECT_EQ(std::vector<int>({ 3, 4 }), Ids(columns, mask));
+
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnYear, DQR::OPERATOR_EQUALS, { "1999", "2015" }, false, mask));
+  EXPECT_EQ(std::vector<int>({ 1, 4 }), Ids(columns, mask));
+
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnYear, DQR::OPERATOR_BETWEEN, { "2000", "2010" }, false, mask));
+  EXPECT_EQ(std::vector<int>({ 2, 3 }), Ids(columns, mask));
+
+  EXPECT_FALSE(columns.Match(CLibraryColumns::ColumnYear, DQR::OPERATOR_EQUALS, { "abc" }, false, mask));
+  EXPECT_FALSE(columns.Match(CLibraryColumns::ColumnYear, DQR::OPERATOR_CONTAINS, { "2" }, false, mask));
+}
+
+TEST_F(TestLibraryColumns, MatchNull)
+{
+  CLibraryColumns::Mask mask;
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnPlaycount, DQR::OPERATOR_LESS_THAN, { "2" }, false, mask));
+  EXPECT_EQ(std::vector<int>({ 1, 4 }), Ids(columns, mask));
+
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnPlaycount, DQR::OPERATOR_LESS_THAN, { "2" }, true, mask));
+  EXPECT_EQ(std::vector<int>({ 1, 3, 4 }), Ids(columns, mask));
+
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnPlaycount, DQR::OPERATOR_DOES_NOT_EQUAL, { "0" }, false, mask));
+  EXPECT_EQ(std::vector<int>({ 2, 4 }), Ids(columns, mask));
+}
+
+TEST_F(TestLibraryColumns, MatchTexts)
+{
+  CLibraryColumns::Mask mask;
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnGenre, DQR::OPERATOR_CONTAINS, { "rock" }, mask));
+  EXPECT_EQ(std::vector<int>({ 1, 3 }), Ids(columns, mask));
+
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnGenre, DQR::OPERATOR_EQUALS, { "POP" }, mask));
+  EXPECT_EQ(std::vector<int>({ 1 }), Ids(columns, mask));
+
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnGenre, DQR::OPERATOR_STARTS_WITH, { "pop", "jazz" }, mask));
+  EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), Ids(columns, mask));
+
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnGenre, DQR::OPERATOR_ENDS_WITH, { "rock" }, mask));
+  EXPECT_EQ(std::vector<int>({ 1, 3 }), Ids(columns, mask));
+
+  // negated conditions match items without any values as well
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnGenre, DQR::OPERATOR_DOES_NOT_CONTAIN, { "rock" }, mask));
+  EXPECT_EQ(std::vector<int>({ 2, 4 }), Ids(columns, mask));
+
+  EXPECT_FALSE(columns.Match(CLibraryColumns::ColumnGenre, DQR::OPERATOR_CONTAINS, { "r%k" }, mask));
+}
+
+TEST_F(TestLibraryColumns, CountDistinct)
+{
+  CLibraryColumns::Mask mask = columns.All();
+  EXPECT_EQ(4, columns.CountDistinct(CLibraryColumns::ColumnGenre, mask));
+
+  CLibraryColumns::Mask years;
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnYear, DQR::OPERATOR_LESS_THAN, { "2010" }, false, years));
+  CLibraryColumns::And(mask, years);
+  EXPECT_EQ(3, columns.CountDistinct(CLibraryColumns::ColumnGenre, mask));
+  EXPECT_EQ(2, columns.Count(mask));
+}
+
+TEST_F(TestLibraryColumns, ReplaceAndRemove)
+{
+  columns.Add(MakeItem(2, 2005, 3, { "Blues" }));
+  columns.Remove(1);
+  EXPECT_EQ(3U, columns.Size());
+
+  CLibraryColumns::Mask mask;
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnGenre, DQR::OPERATOR_CONTAINS, { "" }, mask));
+  EXPECT_EQ(std::vector<int>({ 3, 2 }), Ids(columns, mask));
+  EXPECT_EQ(2, columns.CountDistinct(CLibraryColumns::ColumnGenre, mask));
+
+  columns.Compact();
+  EXPECT_EQ(3U, columns.Size());
+  EXPECT_TRUE(columns.Match(CLibraryColumns::ColumnGenre, DQR::OPERATOR_EQUALS, { "blues" }, mask));
+  EXPECT_EQ(std::vector<int>({ 2 }), Ids(columns, mask));
+  EXPECT_EQ(2, columns.CountDistinct(CLibraryColumns::ColumnGenre, columns.All()));
+}
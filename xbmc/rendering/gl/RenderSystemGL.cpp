@@ -21,6 +21,7 @@
 #include "RenderSystemGL.h"
 #include "filesystem/File.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUITextureGL.h"
 #include "settings/AdvancedSettings.h"
 #include "guilib/MatrixGLES.h"
 #include "settings/DisplaySettings.h"
@@ -220,6 +221,8 @@ bool CRenderSystemGL::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureGL::EndBatchFrame();
+
   return true;
 }
 
@@ -228,6 +231,8 @@ bool CRenderSystemGL::ClearBuffers(color_t color)
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureGL::FlushBatch();
+
   /* clear is not affected by stipple pattern, so we can only clear on first frame */
   if(m_stereoMode == RENDER_STEREO_MODE_INTERLACED && m_stereoView == RENDER_STEREO_VIEW_RIGHT)
     return true;
@@ -280,6 +285,7 @@ void CRenderSystemGL::PresentRender(bool rendered, bool videoLayer)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
   PresentRenderImpl(rendered);
 
   if (!rendered)
@@ -310,6 +316,8 @@ void CRenderSystemGL::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -323,6 +331,8 @@ void CRenderSystemGL::ApplyStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   glBindVertexArray(m_vertexArray);
 
   glViewport(m_viewPort[0], m_viewPort[1], m_viewPort[2], m_viewPort[3]);
@@ -341,6 +351,8 @@ void CRenderSystemGL::SetCameraPosition(const CPoint &camera, int screenWidth, i
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
 
 
@@ -391,6 +403,8 @@ void CRenderSystemGL::ApplyHardwareTransform(const TransformMatrix &finalMatrix)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   glMatrixModview.Push();
   GLfloat matrix[4][4];
 
@@ -412,6 +426,8 @@ void CRenderSystemGL::RestoreHardwareTransform()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   glMatrixModview.PopLoad();
 }
 
@@ -477,6 +493,8 @@ void CRenderSystemGL::SetViewPort(const CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -511,6 +529,9 @@ void CRenderSystemGL::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  CGUITextureGL::FlushBatch();
+
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -580,6 +601,8 @@ static const GLubyte stipple_3d[] = {
 
 void CRenderSystemGL::SetStereoMode(RENDER_STEREO_MODE mode, RENDER_STEREO_VIEW view)
 {
+  CGUITextureGL::FlushBatch();
+
   CRenderSystemBase::SetStereoMode(mode, view);
 
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
@@ -711,6 +734,8 @@ void CRenderSystemGL::InitialiseShader()
 
 void CRenderSystemGL::EnableShader(ESHADERMETHOD method)
 {
+  CGUITextureGL::FlushBatch();
+
   m_method = method;
   if (m_pShader[m_method])
   {
@@ -731,6 +756,56 @@ void CRenderSystemGL::DisableShader()
   m_method = SM_DEFAULT;
 }
 
+void CRenderSystemGL::BindTexture(unsigned int unit, GLuint texture)
+{
+  if (unit < 2)
+    m_boundTextures[unit] = texture;
+
+  glActiveTexture(GL_TEXTURE0 + unit);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  if (unit != 0)
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void CRenderSystemGL::SetBlend(bool enable, GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+  m_blendEnabled = enable;
+  if (enable)
+  {
+    m_blendFunc[0] = srcRGB;
+    m_blendFunc[1] = dstRGB;
+    m_blendFunc[2] = srcAlpha;
+    m_blendFunc[3] = dstAlpha;
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    glEnable(GL_BLEND);
+  }
+  else
+    glDisable(GL_BLEND);
+}
+
+void CRenderSystemGL::ForgetTexture(GLuint texture)
+{
+  for (GLuint &bound : m_boundTextures)
+  {
+    if (bound == texture)
+      bound = 0;
+  }
+}
+
+void CRenderSystemGL::RestoreTrackedState()
+{
+  glBlendFuncSeparate(m_blendFunc[0], m_blendFunc[1], m_blendFunc[2], m_blendFunc[3]);
+  if (m_blendEnabled)
+    glEnable(GL_BLEND);
+  else
+    glDisable(GL_BLEND);
+
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, m_boundTextures[1]);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, m_boundTextures[0]);
+}
+
 GLint CRenderSystemGL::ShaderGetPos()
 {
   if (m_pShader[m_method])
@@ -93,6 +93,16 @@ public:
   GLint ShaderGetUniCol();
   GLint ShaderGetModel();
 
+  // texture bindings and blending of the GUI shaders, tracked so that
+  // drawing the GUI sprite batch can restore them without querying GL
+  void BindTexture(unsigned int unit, GLuint texture);
+  void SetBlend(bool enable, GLenum srcRGB = GL_SRC_ALPHA, GLenum dstRGB = GL_ONE_MINUS_SRC_ALPHA,
+                GLenum srcAlpha = GL_SRC_ALPHA, GLenum dstAlpha = GL_ONE_MINUS_SRC_ALPHA);
+  /*! \brief Reapply the tracked texture bindings and blending, leaving texture unit 0 active */
+  void RestoreTrackedState();
+  /*! \brief Drop a texture that is about to be deleted from the tracked bindings, GL unbinds it as well */
+  void ForgetTexture(GLuint texture);
+
 protected:
   virtual void SetVSyncImpl(bool enable) = 0;
   virtual void PresentRenderImpl(bool rendered) = 0;
@@ -114,4 +124,8 @@ protected:
   std::unique_ptr<CGLShader*[]> m_pShader;
   ESHADERMETHOD m_method = SM_DEFAULT;
   GLuint m_vertexArray = GL_NONE;
+
+  GLuint m_boundTextures[2] = {}; // per texture unit, as set by BindTexture()
+  bool m_blendEnabled = false;
+  GLenum m_blendFunc[4] = { GL_ONE, GL_ZERO, GL_ONE, GL_ZERO };
 };
@@ -21,6 +21,7 @@
 #include "guilib/GraphicContext.h"
 #include "settings/AdvancedSettings.h"
 #include "RenderSystemGLES.h"
+#include "guilib/GUITextureGLES.h"
 #include "guilib/MatrixGLES.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -156,6 +157,8 @@ bool CRenderSystemGLES::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureGLES::EndBatchFrame();
+
   return true;
 }
 
@@ -164,6 +167,8 @@ bool CRenderSystemGLES::ClearBuffers(color_t color)
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureGLES::FlushBatch();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -214,6 +219,7 @@ void CRenderSystemGLES::PresentRender(bool rendered, bool videoLayer)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
   PresentRenderImpl(rendered);
 
   // if video is rendered to a separate layer, we should not block this thread
@@ -255,6 +261,8 @@ void CRenderSystemGLES::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -270,6 +278,8 @@ void CRenderSystemGLES::ApplyStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   glMatrixProject.PopLoad();
   glMatrixModview.PopLoad();
   glMatrixTexture.PopLoad();
@@ -284,6 +294,8 @@ void CRenderSystemGLES::SetCameraPosition(const CPoint &camera, int screenWidth,
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
 
   float w = (float)m_viewPort[2]*0.5f;
@@ -360,6 +372,8 @@ void CRenderSystemGLES::ApplyHardwareTransform(const TransformMatrix &finalMatri
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   glMatrixModview.Push();
   GLfloat matrix[4][4];
 
@@ -381,6 +395,8 @@ void CRenderSystemGLES::RestoreHardwareTransform()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   glMatrixModview.PopLoad();
 }
 
@@ -406,6 +422,8 @@ void CRenderSystemGLES::SetViewPort(const CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGLES::FlushBatch();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -440,6 +458,9 @@ void CRenderSystemGLES::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  CGUITextureGLES::FlushBatch();
+
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -565,6 +586,8 @@ void CRenderSystemGLES::InitialiseShader()
 
 void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
 {
+  CGUITextureGLES::FlushBatch();
+
   m_method = method;
   if (m_pShader[m_method])
   {
@@ -585,6 +608,56 @@ void CRenderSystemGLES::DisableGUIShader()
   m_method = SM_DEFAULT;
 }
 
+void CRenderSystemGLES::BindTexture(unsigned int unit, GLuint texture)
+{
+  if (unit < 2)
+    m_boundTextures[unit] = texture;
+
+  glActiveTexture(GL_TEXTURE0 + unit);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  if (unit != 0)
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void CRenderSystemGLES::SetBlend(bool enable, GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+  m_blendEnabled = enable;
+  if (enable)
+  {
+    m_blendFunc[0] = srcRGB;
+    m_blendFunc[1] = dstRGB;
+    m_blendFunc[2] = srcAlpha;
+    m_blendFunc[3] = dstAlpha;
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    glEnable(GL_BLEND);
+  }
+  else
+    glDisable(GL_BLEND);
+}
+
+void CRenderSystemGLES::ForgetTexture(GLuint texture)
+{
+  for (GLuint &bound : m_boundTextures)
+  {
+    if (bound == texture)
+      bound = 0;
+  }
+}
+
+void CRenderSystemGLES::RestoreTrackedState()
+{
+  glBlendFuncSeparate(m_blendFunc[0], m_blendFunc[1], m_blendFunc[2], m_blendFunc[3]);
+  if (m_blendEnabled)
+    glEnable(GL_BLEND);
+  else
+    glDisable(GL_BLEND);
+
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, m_boundTextures[1]);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, m_boundTextures[0]);
+}
+
 GLint CRenderSystemGLES::GUIShaderGetPos()
 {
   if (m_pShader[m_method])
@@ -183,6 +183,8 @@ void CAdvancedSettings::Initialize()
   m_addSourceOnTop = false;
 
   m_handleMounting = g_application.IsStandAlone();
+  m_useChangeJournal = false;
+  m_useLibraryIndex = false;
 
   m_fullScreenOnMovieStart = true;
   m_cachePath = "special://temp/";
@@ -294,6 +296,7 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
+  m_iVideoScannerScraperJobs = 4;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
   m_iEpgUpdateCheckInterval = 300; /* check if tables need to be updated every 5 minutes */
@@ -358,6 +361,7 @@ void CAdvancedSettings::Initialize()
   m_iPVRNumericChannelSwitchTimeout = 2000;
 
   m_cacheMemSize = 1024 * 1024 * 20;
+  m_cacheDiskSize = 0;
   m_cacheBufferMode = CACHE_BUFFER_MODE_INTERNET; // Default (buffer all internet streams/filesystems)
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
@@ -767,6 +771,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetUInt(pElement, "scraperjobs", m_iVideoScannerScraperJobs, 1, 16);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -796,6 +801,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
+    XMLUtils::GetUInt(pElement, "disksize", m_cacheDiskSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
   }
@@ -849,6 +855,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetInt(pRootElement,     "airplayport", m_airPlayPort);  
 
   XMLUtils::GetBoolean(pRootElement, "handlemounting", m_handleMounting);
+  XMLUtils::GetBoolean(pRootElement, "usechangejournal", m_useChangeJournal);
+  XMLUtils::GetBoolean(pRootElement, "uselibraryindex", m_useLibraryIndex);
 
 #if defined(HAS_SDL) || defined(TARGET_WINDOWS)
   XMLUtils::GetBoolean(pRootElement, "fullscreen", m_startFullScreen);
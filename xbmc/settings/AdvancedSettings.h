@@ -212,6 +212,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_airPlayPort;
 
     bool m_handleMounting;
+    bool m_useChangeJournal; ///< skip library folders a watcher saw no change in, instead of hashing them
+    bool m_useLibraryIndex; ///< evaluate smart playlists and media filter counts from an in-memory index of the library
 
     bool m_fullScreenOnMovieStart;
     std::string m_cachePath;
@@ -274,6 +276,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bVideoLibraryImportResumePoint;
 
     bool m_bVideoScannerIgnoreErrors;
+    unsigned int m_iVideoScannerScraperJobs; ///< concurrent lookups per scraper while scanning
     int m_iVideoLibraryDateAdded;
 
     std::set<std::string> m_vecTokens;
@@ -345,6 +348,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
+    unsigned int m_cacheDiskSize; ///< size in MB of the on-disk cache keeping fetched ranges across seeks, 0 to disable
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
 
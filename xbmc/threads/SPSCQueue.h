@@ -0,0 +1,131 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/*!
+ * \brief Bounded lock-free queue for exactly one producer and one consumer
+ * thread.
+ *
+ * Push() must only be called by the producer and Pop() only by the consumer,
+ * neither ever blocks. The capacity is rounded up to a power of two. Waking
+ * up the other side, if it is sleeping, is left to the caller.
+ */
+template<typename T>
+class CSPSCQueue
+{
+public:
+  explicit CSPSCQueue(size_t capacity)
+  {
+    size_t size = 2;
+    while (size < capacity)
+      size <<= 1;
+    m_items.resize(size);
+    m_mask = size - 1;
+  }
+
+  CSPSCQueue(const CSPSCQueue&) = delete;
+  CSPSCQueue& operator=(const CSPSCQueue&) = delete;
+
+  /*! \return false if the queue is full, producer only */
+  bool Push(const T& item)
+  {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+      return false;
+    m_items[tail & m_mask] = item;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*! \return false if the queue is empty, consumer only */
+  bool Pop(T& item)
+  {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+      return false;
+    item = m_items[head & m_mask];
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*! \brief snapshot, may be outdated as soon as it returns */
+  size_t Size() const
+  {
+    return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+  }
+
+  bool Empty() const { return Size() == 0; }
+  bool Full() const { return Size() > m_mask; }
+  size_t Capacity() const { return m_mask + 1; }
+
+  /*! \brief drop all items, only while neither side is using the queue */
+  void Reset()
+  {
+    m_head.store(0);
+    m_tail.store(0);
+  }
+
+private:
+  std::vector<T> m_items;
+  size_t m_mask;
+  // keep consumer and producer index on separate cache lines
+  std::atomic<size_t> m_head{0};
+  char m_pad[64 - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> m_tail{0};
+};
+
+/*!
+ * \brief Handshake for waking up the side of a CSPSCQueue that went to sleep
+ * because there was nothing to pop (or no room to push).
+ *
+ * The sleeping side calls BeginWait(), checks the queue once more and only
+ * waits on its event if that still fails, then calls EndWait(). The other
+ * side signals the event after Push()/Pop() if IsWaiting() returns true.
+ * The queue indices and the flag are different atomics, so without the full
+ * fences each side could see the other's store too late and both would
+ * assume the other one is going to act, losing the wakeup until the wait
+ * times out.
+ */
+class CSPSCWakeup
+{
+public:
+  /*! \brief announce the wait, the queue has to be checked again afterwards */
+  void BeginWait()
+  {
+    m_waiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  void EndWait() { m_waiting.store(false, std::memory_order_relaxed); }
+
+  /*! \brief call after modifying the queue, true if the other side needs a signal */
+  bool IsWaiting() const
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return m_waiting.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic_bool m_waiting{false};
+};
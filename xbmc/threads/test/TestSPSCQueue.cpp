@@ -0,0 +1,160 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Event.h"
+#include "threads/SPSCQueue.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+TEST(TestSPSCQueue, Bounds)
+{
+  CSPSCQueue<int> queue(5);
+  EXPECT_EQ(8U, queue.Capacity());
+  EXPECT_TRUE(queue.Empty());
+
+  int item;
+  EXPECT_FALSE(queue.Pop(item));
+  for (int i = 0; i < 8; i++)
+    EXPECT_TRUE(queue.Push(i));
+  EXPECT_TRUE(queue.Full());
+  EXPECT_FALSE(queue.Push(8));
+
+  // wrap around a few times, order is kept
+  for (int i = 0; i < 20; i++)
+  {
+    ASSERT_TRUE(queue.Pop(item));
+    EXPECT_EQ(i, item);
+    EXPECT_TRUE(queue.Push(i + 8));
+  }
+  EXPECT_EQ(8U, queue.Size());
+
+  queue.Reset();
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_FALSE(queue.Pop(item));
+}
+
+TEST(TestSPSCQueue, Threads)
+{
+  const int items = 1000000;
+  CSPSCQueue<int> queue(16);
+
+  std::thread producer([&queue]()
+  {
+    for (int i = 0; i < items; )
+    {
+      if (queue.Push(i))
+        i++;
+      else
+        std::this_thread::yield();
+    }
+  });
+
+  int expected = 0;
+  while (expected < items)
+  {
+    int item;
+    if (queue.Pop(item))
+    {
+      ASSERT_EQ(expected, item);
+      expected++;
+    }
+    else
+      std::this_thread::yield();
+  }
+  producer.join();
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(TestSPSCQueue, WakeupLatency)
+{
+  // the handshake AddData and the audio engine use: each side only sleeps
+  // after announcing it and rechecking the queue, so a lost wakeup shows up
+  // as a wait running into its timeout
+  const int rounds = 5000;
+  const int timeout = 1000;
+  CSPSCQueue<int> ping(4);
+  CSPSCQueue<int> pong(4);
+  CSPSCWakeup pingWakeup;
+  CSPSCWakeup pongWakeup;
+  CEvent pingEvent;
+  CEvent pongEvent;
+
+  auto wait = [timeout](CSPSCQueue<int> &queue, CSPSCWakeup &wakeup, CEvent &event, int &value)
+  {
+    while (!queue.Pop(value))
+    {
+      wakeup.BeginWait();
+      if (!queue.Empty())
+      {
+        wakeup.EndWait();
+        continue;
+      }
+      bool signaled = event.WaitMSec(timeout);
+      wakeup.EndWait();
+      if (!signaled)
+        return false;
+    }
+    return true;
+  };
+
+  std::atomic<int> timeouts(0);
+  std::thread echo([&]()
+  {
+    int value;
+    for (int i = 0; i < rounds; i++)
+    {
+      if (!wait(ping, pingWakeup, pingEvent, value))
+      {
+        timeouts++;
+        return;
+      }
+      pong.Push(value);
+      if (pongWakeup.IsWaiting())
+        pongEvent.Set();
+    }
+  });
+
+  int64_t maxRoundTrip = 0;
+  int value;
+  for (int i = 0; i < rounds && timeouts == 0; i++)
+  {
+    int64_t start = CurrentHostCounter();
+    ping.Push(i);
+    if (pingWakeup.IsWaiting())
+      pingEvent.Set();
+    if (!wait(pong, pongWakeup, pongEvent, value))
+    {
+      timeouts++;
+      break;
+    }
+    maxRoundTrip = std::max(maxRoundTrip, CurrentHostCounter() - start);
+    EXPECT_EQ(i, value);
+  }
+  echo.join();
+
+  EXPECT_EQ(0, timeouts);
+  // a lost wakeup costs a full timeout, a regular one is far below that
+  EXPECT_LT(maxRoundTrip * 1000 / CurrentHostFrequency(), timeout / 2);
+}
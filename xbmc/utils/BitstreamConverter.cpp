@@ -315,6 +315,88 @@ bool CBitstreamParser::CanStartDecode(const uint8_t *buf, int buf_size)
   return rtn;
 }
 
+bool CBitstreamParser::IsClosedGopStart(AVCodecID codec, const uint8_t *buf, int buf_size, const uint8_t *extradata, int extrasize)
+{
+  if (!buf)
+    return false;
+
+  const uint8_t *buf_end = buf + buf_size;
+
+  if (codec == AV_CODEC_ID_MPEG1VIDEO || codec == AV_CODEC_ID_MPEG2VIDEO)
+  {
+    // the gop header precedes the first picture, closed_gop follows the 25 bit time code
+    for (const uint8_t *p = buf; p + 8 <= buf_end; p++)
+    {
+      if (p[0] != 0 || p[1] != 0 || p[2] != 1)
+        continue;
+      if (p[3] == 0xB8)
+        return (p[7] & 0x40) != 0;
+      if (p[3] == 0x00)
+        break;
+    }
+    return false;
+  }
+
+  if (codec != AV_CODEC_ID_H264 && codec != AV_CODEC_ID_HEVC)
+    return true;
+
+  // avcC and hvcC extradata carry the size of the length prefix
+  int length_size = 0;
+  if (extradata)
+  {
+    if (codec == AV_CODEC_ID_H264 && extrasize >= 7 && extradata[0] == 1)
+      length_size = (extradata[4] & 0x3) + 1;
+    else if (codec == AV_CODEC_ID_HEVC && extrasize >= 23 &&
+             (extradata[0] || extradata[1] || extradata[2] > 1))
+      length_size = (extradata[21] & 0x3) + 1;
+  }
+
+  // the first slice decides, parameter sets and sei come before it
+  while (buf < buf_end)
+  {
+    const uint8_t *nal;
+    if (length_size)
+    {
+      if (buf + length_size > buf_end)
+        break;
+      uint32_t nal_size = 0;
+      for (int i = 0; i < length_size; i++)
+        nal_size = (nal_size << 8) | buf[i];
+      nal = buf + length_size;
+      buf = nal + nal_size;
+    }
+    else
+    {
+      nal = avc_find_startcode(buf, buf_end);
+      while (nal < buf_end && !*nal)
+        nal++;
+      nal++;
+      buf = nal;
+    }
+    if (nal >= buf_end)
+      break;
+
+    if (codec == AV_CODEC_ID_H264)
+    {
+      int unit_type = nal[0] & 0x1f;
+      if (unit_type == AVC_NAL_IDR_SLICE)
+        return true;
+      if (unit_type >= AVC_NAL_SLICE && unit_type < AVC_NAL_IDR_SLICE)
+        return false;
+    }
+    else
+    {
+      int unit_type = (nal[0] >> 1) & 0x3f;
+      if (unit_type >= HEVC_NAL_BLA_W_LP && unit_type <= HEVC_NAL_IDR_N_LP)
+        return true;
+      if (unit_type < HEVC_NAL_VPS)
+        return false;
+    }
+  }
+
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////
 CBitstreamConverter::CBitstreamConverter()
@@ -90,6 +90,12 @@ public:
   static bool Open(){ return true; };
   static void Close();
   static bool CanStartDecode(const uint8_t *buf, int buf_size);
+  /*!
+   \brief Check whether a keyframe starts a closed gop, i.e. no picture after it references one before it
+   \param extradata codec extradata, tells whether the h264/hevc units are length prefixed
+   \return true for h264/hevc IDR and BLA pictures and for closed mpeg2 gops, codecs other than these are not inspected and always return true
+   */
+  static bool IsClosedGopStart(AVCodecID codec, const uint8_t *buf, int buf_size, const uint8_t *extradata, int extrasize);
 };
 
 class CBitstreamConverter
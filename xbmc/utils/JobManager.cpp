@@ -23,6 +23,7 @@
 #include <functional>
 #include <stdexcept>
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
@@ -201,8 +202,9 @@ void CJobManager::CancelJobs()
   // clear any pending jobs
   for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), std::mem_fun_ref(&CWorkItem::FreeJob));
-    m_jobQueue[priority].clear();
+    JobQueue &queue = m_lanes[priority].m_queue;
+    for_each(queue.begin(), queue.end(), std::mem_fun_ref(&CWorkItem::FreeJob));
+    queue.clear();
   }
 
   // cancel any callbacks on jobs still processing
@@ -222,6 +224,11 @@ CJobManager::~CJobManager() = default;
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
+  // resolved here so that matching job types under the lock is cheap
+  const char *type = job->GetType();
+  size_t typeHash = *type ? std::hash<std::string>()(type) : 0;
+  unsigned int now = XbmcThreads::SystemClockMillis();
+
   CSingleLock lock(m_section);
 
   if (!m_running)
@@ -234,7 +241,9 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
 
   // create a work item for this job
   CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
+  work.m_queuedAt = now;
+  work.m_type = typeHash;
+  m_lanes[priority].m_queue.push_back(work);
 
   StartWorkers(priority);
   return work.m_id;
@@ -247,11 +256,12 @@ void CJobManager::CancelJob(unsigned int jobID)
   // check whether we have this job in the queue
   for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    JobQueue &queue = m_lanes[priority].m_queue;
+    JobQueue::iterator i = find(queue.begin(), queue.end(), jobID);
+    if (i != queue.end())
     {
       delete i->m_job;
-      m_jobQueue[priority].erase(i);
+      queue.erase(i);
       return;
     }
   }
@@ -280,7 +290,28 @@ void CJobManager::StartWorkers(CJob::PRIORITY priority)
   m_workers.push_back(new CJobWorker(this));
 }
 
-CJob *CJobManager::PopJob()
+CJobManager::JobQueue::iterator CJobManager::SelectJob(CJobLane &lane, const CJobWorker *worker)
+{
+  // how far into the lane we look for a job matching the worker's previous one
+  static const unsigned int affinity_window = 4;
+
+  JobQueue::iterator front = lane.m_queue.begin();
+  if (!worker || !worker->m_lastJobType || lane.m_queue.size() < 2 || front->m_type == worker->m_lastJobType)
+    return front;
+
+  JobQueue::iterator end = lane.m_queue.size() > affinity_window ? front + affinity_window : lane.m_queue.end();
+  for (JobQueue::iterator it = front + 1; it != end; ++it)
+  {
+    if (it->m_type == worker->m_lastJobType)
+    {
+      lane.m_affinityHits++;
+      return it;
+    }
+  }
+  return front;
+}
+
+CJob *CJobManager::PopJob(CJobWorker *worker)
 {
   CSingleLock lock(m_section);
   for (int priority = CJob::PRIORITY_DEDICATED; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
@@ -289,15 +320,25 @@ CJob *CJobManager::PopJob()
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    CJobLane &lane = m_lanes[priority];
+    if (lane.m_queue.size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
     {
       // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
+      JobQueue::iterator it = SelectJob(lane, worker);
+      CWorkItem job = *it;
+      lane.m_queue.erase(it);
+
+      // update the lane statistics
+      unsigned int waited = XbmcThreads::SystemClockMillis() - job.m_queuedAt;
+      lane.m_dispatched++;
+      lane.m_totalWaitMs += waited;
+      lane.m_maxWaitMs = std::max(lane.m_maxWaitMs, waited);
 
       // add to the processing vector
       m_processing.push_back(job);
       job.m_job->m_callback = this;
+      if (worker)
+        worker->m_lastJobType = job.m_type;
       return job.m_job;
     }
   }
@@ -331,6 +372,23 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
   return false;
 }
 
+JobLaneStats CJobManager::GetLaneStats(CJob::PRIORITY priority) const
+{
+  CSingleLock lock(m_section);
+
+  const CJobLane &lane = m_lanes[priority];
+  JobLaneStats stats;
+  stats.queued = lane.m_queue.size();
+  stats.processing = std::count_if(m_processing.begin(), m_processing.end(),
+                                   [priority](const CWorkItem &item) { return item.m_priority == priority; });
+  stats.dispatched = lane.m_dispatched;
+  stats.affinityHits = lane.m_affinityHits;
+  stats.maxWaitMs = lane.m_maxWaitMs;
+  if (lane.m_dispatched)
+    stats.avgWaitMs = static_cast<unsigned int>(lane.m_totalWaitMs / lane.m_dispatched);
+  return stats;
+}
+
 int CJobManager::IsProcessing(const std::string &type) const
 {
   int jobsMatched = 0;
@@ -347,13 +405,13 @@ int CJobManager::IsProcessing(const std::string &type) const
   return jobsMatched;
 }
 
-CJob *CJobManager::GetNextJob(const CJobWorker *worker)
+CJob *CJobManager::GetNextJob(CJobWorker *worker)
 {
   CSingleLock lock(m_section);
   while (m_running)
   {
     // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    CJob *job = PopJob(worker);
     if (job)
       return job;
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
@@ -365,7 +423,7 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
   }
   // ensure no jobs have come in during the period after
   // timeout and before we held the lock
-  CJob *job = PopJob();
+  CJob *job = PopJob(worker);
   if (job)
     return job;
   // have no jobs
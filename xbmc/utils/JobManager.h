@@ -20,6 +20,7 @@
  */
 
 #include <queue>
+#include <stdint.h>
 #include <vector>
 #include <string>
 #include "threads/CriticalSection.h"
@@ -36,7 +37,10 @@ public:
 
   void Process() override;
 private:
+  friend class CJobManager;
+
   CJobManager  *m_jobManager;
+  size_t        m_lastJobType = 0; ///< type hash of the last job processed, used for job affinity
 };
 
 template<typename F>
@@ -188,6 +192,21 @@ private:
   bool m_lifo;
 };
 
+/*!
+ \ingroup jobs
+ \brief Snapshot of the scheduling statistics of a single priority lane.
+ \sa CJobManager::GetLaneStats()
+ */
+struct JobLaneStats
+{
+  unsigned int queued = 0;        ///< number of jobs waiting in the lane
+  unsigned int processing = 0;    ///< number of jobs of this priority being processed
+  unsigned int dispatched = 0;    ///< number of jobs handed to a worker since startup
+  unsigned int affinityHits = 0;  ///< dispatches that skipped queued jobs to match the type of the worker's previous job
+  unsigned int avgWaitMs = 0;     ///< average time a job spent queued before being dispatched
+  unsigned int maxWaitMs = 0;     ///< longest time a job spent queued before being dispatched
+};
+
 /*!
  \ingroup jobs
  \brief Job Manager class for scheduling asynchronous jobs.
@@ -197,6 +216,10 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Each priority level is kept in its own lane. When a worker picks its next job from
+ a lane it prefers a job of the same type as the one it just finished (job affinity),
+ so that e.g. consecutive image caching jobs stay on workers with warm caches.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -210,6 +233,8 @@ class CJobManager
       m_id = id;
       m_callback = callback;
       m_priority = priority;
+      m_queuedAt = 0;
+      m_type = 0;
     }
     bool operator==(unsigned int jobID) const
     {
@@ -232,6 +257,20 @@ class CJobManager
     unsigned int  m_id;
     IJobCallback *m_callback;
     CJob::PRIORITY m_priority;
+    unsigned int  m_queuedAt;
+    size_t        m_type;     ///< hash of the job's type, 0 if it has none
+  };
+
+  typedef std::deque<CWorkItem>    JobQueue;
+
+  class CJobLane
+  {
+  public:
+    JobQueue     m_queue;
+    unsigned int m_dispatched = 0;
+    unsigned int m_affinityHits = 0;
+    uint64_t     m_totalWaitMs = 0;
+    unsigned int m_maxWaitMs = 0;
   };
 
 public:
@@ -319,6 +358,13 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY &priority) const;
 
+  /*!
+   \brief Retrieve the scheduling statistics of a priority lane.
+   \param priority the lane to query
+   \return queue depth, dispatch counters and queueing latency of the lane
+   */
+  JobLaneStats GetLaneStats(CJob::PRIORITY priority) const;
+
 protected:
   friend class CJobWorker;
   friend class CJob;
@@ -329,7 +375,7 @@ protected:
    \param worker a pointer to the current CJobWorker instance requesting a job.
    \sa CJob
    */
-  CJob *GetNextJob(const CJobWorker *worker);
+  CJob *GetNextJob(CJobWorker *worker);
 
   /*!
    \brief Callback from CJobWorker after a job has completed.
@@ -359,9 +405,17 @@ private:
   virtual ~CJobManager();
 
   /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+   \param worker the worker that will process the job, used for job affinity
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopJob(CJobWorker *worker);
+
+  /*! \brief Find the job a worker should pick next from a lane
+   Prefers a job of the same type as the last job processed by the worker, as long
+   as it is close to the front of the lane, so that ordering is mostly preserved.
+   \return an iterator to the job to process
+   */
+  static JobQueue::iterator SelectJob(CJobLane &lane, const CJobWorker *worker);
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
@@ -369,11 +423,10 @@ private:
 
   unsigned int m_jobCounter;
 
-  typedef std::deque<CWorkItem>    JobQueue;
   typedef std::vector<CWorkItem>   Processing;
   typedef std::vector<CJobWorker*> Workers;
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
+  CJobLane   m_lanes[CJob::PRIORITY_DEDICATED + 1];
   bool       m_pauseJobs;
   Processing m_processing;
   Workers    m_workers;
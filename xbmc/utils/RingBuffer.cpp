@@ -208,6 +208,42 @@ bool CRingBuffer::SkipBytes(int skipSize)
   return true;
 }
 
+/* Get the contiguous free space at the write position, 'size' receives its
+ * length. Data written there becomes readable with CommitWrite(), this saves
+ * the copy of WriteData() for a producer able to write in place.
+ */
+char *CRingBuffer::getWriteBuffer(unsigned int &size)
+{
+  CSingleLock lock(m_critSection);
+  size = std::min(m_size - m_writePtr, m_size - m_fillCount);
+  return m_buffer + m_writePtr;
+}
+
+/* Make 'size' bytes written to the area returned by getWriteBuffer() readable */
+bool CRingBuffer::CommitWrite(unsigned int size)
+{
+  CSingleLock lock(m_critSection);
+  if (size > m_size - m_writePtr || size > m_size - m_fillCount)
+  {
+    return false;
+  }
+  m_writePtr += size;
+  if (m_writePtr == m_size)
+    m_writePtr = 0;
+  m_fillCount += size;
+  return true;
+}
+
+/* Get the contiguous data at the read position, 'size' receives its length.
+ * Use SkipBytes() to release the data after it has been consumed.
+ */
+char *CRingBuffer::getReadBuffer(unsigned int &size)
+{
+  CSingleLock lock(m_critSection);
+  size = std::min(m_size - m_readPtr, m_fillCount);
+  return m_buffer + m_readPtr;
+}
+
 /* Append all content from ring buffer 'rBuf' to this ring buffer */
 bool CRingBuffer::Append(CRingBuffer &rBuf)
 {
@@ -40,6 +40,9 @@ public:
   bool WriteData(const char *buf, unsigned int size);
   bool WriteData(CRingBuffer &rBuf, unsigned int size);
   bool SkipBytes(int skipSize);
+  char *getWriteBuffer(unsigned int &size);
+  bool CommitWrite(unsigned int size);
+  char *getReadBuffer(unsigned int &size);
   bool Append(CRingBuffer &rBuf);
   bool Copy(CRingBuffer &rBuf);
   char *getBuffer();
@@ -0,0 +1,64 @@
+/*
+ *      Copyright (C) 2005-2018 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/BitstreamConverter.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestBitstreamParser, H264AnnexB)
+{
+  // sps, pps, idr slice
+  const uint8_t idr[] = { 0, 0, 0, 1, 0x67, 0x64, 0, 0, 1, 0x68, 0xee, 0, 0, 1, 0x65, 0x88 };
+  // aud, non idr slice
+  const uint8_t slice[] = { 0, 0, 0, 1, 0x09, 0xf0, 0, 0, 1, 0x41, 0x9a };
+
+  EXPECT_TRUE(CBitstreamParser::IsClosedGopStart(AV_CODEC_ID_H264, idr, sizeof(idr), nullptr, 0));
+  EXPECT_FALSE(CBitstreamParser::IsClosedGopStart(AV_CODEC_ID_H264, slice, sizeof(slice), nullptr, 0));
+}
+
+TEST(TestBitstreamParser, H264LengthPrefixed)
+{
+  const uint8_t avcC[] = { 1, 0x64, 0, 0x1f, 0xff, 0xe0, 0 };
+  // sei, idr slice, each with a 4 byte length
+  const uint8_t idr[] = { 0, 0, 0, 2, 0x06, 0x05, 0, 0, 0, 2, 0x65, 0x88 };
+  const uint8_t slice[] = { 0, 0, 0, 2, 0x41, 0x9a };
+
+  EXPECT_TRUE(CBitstreamParser::IsClosedGopStart(AV_CODEC_ID_H264, idr, sizeof(idr), avcC, sizeof(avcC)));
+  EXPECT_FALSE(CBitstreamParser::IsClosedGopStart(AV_CODEC_ID_H264, slice, sizeof(slice), avcC, sizeof(avcC)));
+}
+
+TEST(TestBitstreamParser, HevcCraIsOpen)
+{
+  // vps, then a cra or an idr picture
+  const uint8_t cra[] = { 0, 0, 1, 0x40, 0x01, 0, 0, 1, 0x2a, 0x01, 0xaf };
+  const uint8_t idr[] = { 0, 0, 1, 0x40, 0x01, 0, 0, 1, 0x26, 0x01, 0xaf };
+
+  EXPECT_FALSE(CBitstreamParser::IsClosedGopStart(AV_CODEC_ID_HEVC, cra, sizeof(cra), nullptr, 0));
+  EXPECT_TRUE(CBitstreamParser::IsClosedGopStart(AV_CODEC_ID_HEVC, idr, sizeof(idr), nullptr, 0));
+}
+
+TEST(TestBitstreamParser, Mpeg2GopHeader)
+{
+  const uint8_t closed[] = { 0, 0, 1, 0xb8, 0x00, 0x08, 0x00, 0x40, 0, 0, 1, 0x00 };
+  const uint8_t open[] = { 0, 0, 1, 0xb8, 0x00, 0x08, 0x00, 0x00, 0, 0, 1, 0x00 };
+
+  EXPECT_TRUE(CBitstreamParser::IsClosedGopStart(AV_CODEC_ID_MPEG2VIDEO, closed, sizeof(closed), nullptr, 0));
+  EXPECT_FALSE(CBitstreamParser::IsClosedGopStart(AV_CODEC_ID_MPEG2VIDEO, open, sizeof(open), nullptr, 0));
+}
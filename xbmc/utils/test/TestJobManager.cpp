@@ -20,9 +20,13 @@
 
 #include "utils/JobManager.h"
 #include "utils/Job.h"
+#include "threads/SystemClock.h"
 
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <atomic>
+#include <iostream>
+#include <string>
 
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
@@ -183,3 +187,93 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+class SpinCallback : public IJobCallback
+{
+public:
+  void OnJobComplete(unsigned int jobID, bool success, CJob *job) override
+  {
+    m_completed++;
+  }
+
+  std::atomic<unsigned int> m_completed{0};
+  std::atomic<unsigned int> m_running{0};
+  std::atomic<unsigned int> m_peak{0};
+};
+
+class SpinJob : public CJob
+{
+public:
+  SpinJob(const char *type, SpinCallback &callback) : m_type(type), m_callback(callback) {}
+
+  const char *GetType() const override
+  {
+    return m_type;
+  }
+
+  bool DoWork() override
+  {
+    unsigned int running = ++m_callback.m_running;
+    unsigned int peak = m_callback.m_peak;
+    while (running > peak && !m_callback.m_peak.compare_exchange_weak(peak, running))
+      ;
+
+    // a small amount of cpu bound work, so the benchmark measures scheduling
+    volatile unsigned int sum = 0;
+    for (unsigned int i = 0; i < 20000; i++)
+      sum += i;
+
+    m_callback.m_running--;
+    return true;
+  }
+
+private:
+  const char *m_type;
+  SpinCallback &m_callback;
+};
+}
+
+TEST_F(TestJobManager, LaneStats)
+{
+  JobLaneStats before = CJobManager::GetInstance().GetLaneStats(CJob::PRIORITY_NORMAL);
+
+  JobControlPackage package;
+  BroadcastingJob *job (WaitForJobToStartProcessing(CJob::PRIORITY_NORMAL, package));
+
+  JobLaneStats stats = CJobManager::GetInstance().GetLaneStats(CJob::PRIORITY_NORMAL);
+  EXPECT_EQ(before.dispatched + 1, stats.dispatched);
+  EXPECT_EQ(1u, stats.processing);
+  EXPECT_EQ(0u, stats.queued);
+  EXPECT_GE(stats.maxWaitMs, stats.avgWaitMs);
+
+  job->FinishAndStopBlocking();
+}
+
+TEST_F(TestJobManager, ThroughputScaling)
+{
+  static const unsigned int jobCount = 2000;
+
+  // the lanes differ in how many workers they may use
+  for (int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; priority++)
+  {
+    unsigned int workers = 5 - (CJob::PRIORITY_HIGH - priority);
+    SpinCallback callback;
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    for (unsigned int i = 0; i < jobCount; i++)
+      CJobManager::GetInstance().AddJob(new SpinJob(i % 2 ? kJobTypeCacheImage : "SpinJob", callback),
+                                        &callback, CJob::PRIORITY(priority));
+    while (callback.m_completed < jobCount)
+      Sleep(1);
+    unsigned int elapsed = std::max(1u, XbmcThreads::SystemClockMillis() - start);
+
+    unsigned int throughput = jobCount * 1000 / elapsed;
+    std::string name = "JobsPerSecondWith" + std::to_string(workers) + "Workers";
+    RecordProperty(name, static_cast<int>(throughput));
+    std::cout << workers << " workers: " << throughput << " jobs/s, " << callback.m_peak << " at once" << std::endl;
+
+    EXPECT_EQ(jobCount, callback.m_completed);
+    EXPECT_LE(callback.m_peak, workers);
+  }
+}
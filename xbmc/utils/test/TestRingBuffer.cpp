@@ -43,3 +43,37 @@ TEST(TestRingBuffer, General)
   EXPECT_TRUE(a.ReadData(data, 5));
   EXPECT_STREQ("01234", data);
 }
+
+TEST(TestRingBuffer, InPlace)
+{
+  CRingBuffer a;
+  unsigned int size;
+
+  EXPECT_TRUE(a.Create(10));
+  EXPECT_TRUE(a.WriteData("0123456", 7));
+  EXPECT_TRUE(a.SkipBytes(5));
+
+  // the free space wraps, only the part up to the end is contiguous
+  char *write = a.getWriteBuffer(size);
+  EXPECT_EQ((unsigned int)3, size);
+  memcpy(write, "789", 3);
+  EXPECT_FALSE(a.CommitWrite(4));
+  EXPECT_TRUE(a.CommitWrite(3));
+  write = a.getWriteBuffer(size);
+  EXPECT_EQ((unsigned int)5, size);
+  memcpy(write, "ab", 2);
+  EXPECT_TRUE(a.CommitWrite(2));
+  EXPECT_EQ((unsigned int)7, a.getMaxReadSize());
+
+  char *read = a.getReadBuffer(size);
+  EXPECT_EQ((unsigned int)5, size);
+  EXPECT_EQ(0, memcmp(read, "56789", 5));
+  EXPECT_TRUE(a.SkipBytes(5));
+  read = a.getReadBuffer(size);
+  EXPECT_EQ((unsigned int)2, size);
+  EXPECT_EQ(0, memcmp(read, "ab", 2));
+  EXPECT_TRUE(a.SkipBytes(2));
+
+  a.getReadBuffer(size);
+  EXPECT_EQ((unsigned int)0, size);
+}
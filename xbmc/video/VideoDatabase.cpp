@@ -49,6 +49,7 @@
 #include "interfaces/AnnouncementManager.h"
 #include "messaging/helpers/DialogOKHelper.h"
 #include "playlists/SmartPlayList.h"
+#include "playlists/SmartPlaylistIndex.h"
 #include "profiles/ProfilesManager.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/MediaSettings.h"
@@ -515,7 +516,6 @@ void CVideoDatabase::CreateViews()
 //********************************************************************************************************************************
 int CVideoDatabase::GetPathId(const std::string& strPath)
 {
-  std::string strSQL;
   try
   {
     int idPath=-1;
@@ -528,8 +528,7 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL);
+    m_pDS->query("select idPath from path where strPath=?", {dbiplus::field_value(strPath1)});
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
@@ -538,7 +537,7 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "%s unable to getpath (%s)", __FUNCTION__, strSQL.c_str());
+    CLog::Log(LOGERROR, "%s unable to getpath (%s)", __FUNCTION__, strPath.c_str());
   }
   return -1;
 }
@@ -1064,9 +1063,8 @@ int CVideoDatabase::GetFileId(const std::string& strFilenameAndPath)
     int idPath = GetPathId(strPath);
     if (idPath >= 0)
     {
-      std::string strSQL;
-      strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-      m_pDS->query(strSQL);
+      m_pDS->query("select idFile from files where strFileName=? and idPath=?",
+                   {dbiplus::field_value(strFileName), dbiplus::field_value(idPath)});
       if (m_pDS->num_rows() > 0)
       {
         int idFile = m_pDS->fv("files.idFile").get_asInt();
@@ -6776,29 +6774,37 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
-    if (iRowsFound <= 0)
-      return iRowsFound == 0;
+    // Without sorting of the dataset the rows are used in the returned order,
+    // so they can be streamed rather than held in memory all at once. The
+    // per movie details are looked up on m_pDS2, leaving the cursor alone.
+    const bool streamed = sortDescription.sortBy == SortByNone;
 
-    // store the total value of items as a property
-    if (total < iRowsFound)
-      total = iRowsFound;
-    items.SetProperty("total", total);
-    
     DatabaseResults results;
-    results.reserve(iRowsFound);
+    int rows = 0;
+    if (streamed)
+    {
+      if (!m_pDS->query_stream(strSQL))
+        return false;
+      if (m_pDS->eof())
+      {
+        m_pDS->close();
+        return true;
+      }
+    }
+    else
+    {
+      rows = RunQuery(strSQL);
+      if (rows <= 0)
+        return rows == 0;
 
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, m_pDS, results))
-      return false;
+      results.reserve(rows);
+      if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, m_pDS, results))
+        return false;
+      items.Reserve(results.size());
+    }
 
-    // get data from returned rows
-    items.Reserve(results.size());
-    const query_data &data = m_pDS->get_result_set().records;
-    for (const auto &i : results)
+    auto addRecord = [&](const dbiplus::sql_record* const record)
     {
-      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
-
       CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
       if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                   ||
@@ -6814,8 +6820,29 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
         pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
         items.Add(pItem);
       }
+    };
+
+    // get data from returned rows
+    if (streamed)
+    {
+      for (; !m_pDS->eof(); m_pDS->next(), rows++)
+        addRecord(m_pDS->get_sql_record());
+    }
+    else
+    {
+      const query_data &data = m_pDS->get_result_set().records;
+      for (const auto &i : results)
+      {
+        unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
+        addRecord(data.at(targetRow));
+      }
     }
 
+    // store the total value of items as a property
+    if (total < rows)
+      total = rows;
+    items.SetProperty("total", total);
+
     // cleanup
     m_pDS->close();
     return true;
@@ -10014,8 +10041,15 @@ bool CVideoDatabase::GetFilter(CDbUrl &videoUrl, Filter &filter, SortDescription
         // of the path (season and episodeid) appended later
        (xsp.GetType() == "episodes" && itemType == "tvshows"))
     {
-      std::set<std::string> playlists;
-      filter.AppendWhere(xsp.GetWhereClause(*this, playlists));
+      std::string xspWhere;
+      // rules the library index can evaluate are turned into a list of movie ids
+      if (!g_advancedSettings.m_useLibraryIndex || xsp.GetType() != itemType ||
+          !CSmartPlaylistIndex::GetInstance().GetWhereClause(xsp, xspWhere))
+      {
+        std::set<std::string> playlists;
+        xspWhere = xsp.GetWhereClause(*this, playlists);
+      }
+      filter.AppendWhere(xspWhere);
 
       if (xsp.GetLimit() > 0)
         sorting.limitEnd = xsp.GetLimit();
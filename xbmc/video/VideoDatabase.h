@@ -398,6 +398,8 @@ const struct SDbTableOffsets DbMusicVideoOffsets[] =
 
 class CVideoDatabase : public CDatabase
 {
+  friend class CSmartPlaylistIndex;
+
 public:
 
   class CActor    // used for actor retrieval for non-master users
@@ -20,6 +20,9 @@
 
 #include "VideoInfoScanner.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <utility>
 
 #include "ServiceBroker.h"
@@ -45,11 +48,13 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "TextureCache.h"
+#include "threads/Event.h"
 #include "threads/SystemClock.h"
 #include "URL.h"
 #include "Util.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/RegExp.h"
 #include "utils/StringUtils.h"
@@ -67,6 +72,126 @@ using namespace KODI::MESSAGING;
 using KODI::MESSAGING::HELPERS::DialogResponse;
 using KODI::UTILITY::CDigest;
 
+namespace
+{
+/*! \brief An item to look up ahead of adding it to the database
+ */
+struct VideoLookup
+{
+  CFileItemPtr item;
+  ScraperPtr scraper;
+  bool dirNames;
+  bool useLocal;
+  int found = 0; ///< >0 if details were found, <0 on a scraper error, 0 otherwise
+  CVideoInfoTag details;
+};
+
+/*! \brief The lookups sharing a scraper, taken in turn by that scraper's jobs
+ */
+struct VideoLookupQueue
+{
+  std::vector<VideoLookup> lookups;
+  std::atomic<size_t> next{0};
+};
+
+/*! \brief Fetch the details of an item from its nfo file and/or its scraper
+ Mirrors the lookup done by CVideoInfoScanner::RetrieveInfoForMovie(), without
+ touching the database or any progress dialog.
+ */
+void LookupVideo(VideoLookup &lookup, const bool &stop)
+{
+  CInfoScanner::INFO_TYPE result = CInfoScanner::NO_NFO;
+  std::unique_ptr<VIDEO::IVideoInfoTagLoader> loader;
+  if (lookup.useLocal)
+  {
+    loader.reset(VIDEO::CVideoInfoTagLoaderFactory::CreateLoader(*lookup.item, lookup.scraper, lookup.dirNames));
+    if (loader)
+      result = loader->Load(lookup.details, false);
+  }
+  if (result == CInfoScanner::FULL_NFO)
+  {
+    lookup.found = 1;
+    return;
+  }
+
+  CScraperUrl url;
+  if (result == CInfoScanner::URL_NFO || result == CInfoScanner::COMBINED_NFO)
+    url = loader->ScraperUrl();
+
+  CVideoInfoDownloader downloader(lookup.scraper);
+  if (url.m_url.empty())
+  {
+    std::string title = lookup.item->GetMovieName(lookup.dirNames);
+    int year = -1; // hint that movie title was not found
+    if (result == CInfoScanner::TITLE_NFO)
+    {
+      title = lookup.details.GetTitle();
+      year = lookup.details.GetYear();
+    }
+    MOVIELIST movielist;
+    if (stop)
+      return;
+    int returncode = downloader.FindMovie(title, year, movielist);
+    if (returncode <= 0 || movielist.empty())
+    {
+      lookup.found = returncode < 0 ? -1 : 0;
+      return;
+    }
+    url = movielist[0];
+  }
+
+  CVideoInfoTag details;
+  if (stop || !downloader.GetDetails(url, details))
+    return;
+  if (result == CInfoScanner::COMBINED_NFO || result == CInfoScanner::OVERRIDE_NFO)
+    loader->Load(details, true);
+  lookup.details = details;
+  lookup.found = 1;
+}
+
+class CVideoLookupJob : public CJob
+{
+public:
+  CVideoLookupJob(VideoLookupQueue &queue, unsigned int index, const bool &stop, std::atomic<unsigned int> &remaining, CEvent &done)
+    : m_queue(queue), m_stop(stop), m_remaining(remaining), m_done(done)
+  {
+    m_cacheFolder = StringUtils::Format("job%u", index);
+  }
+
+  ~CVideoLookupJob() override
+  {
+    if (--m_remaining == 0)
+      m_done.Set();
+  }
+
+  bool DoWork() override
+  {
+    size_t i;
+    bool cleared = false;
+    while (!m_stop && (i = m_queue.next++) < m_queue.lookups.size())
+    {
+      // the jobs of a scraper must not share its cached files
+      VideoLookup &lookup = m_queue.lookups[i];
+      lookup.scraper->SetCacheFolder(m_cacheFolder);
+      if (!cleared)
+      {
+        lookup.scraper->ClearCache();
+        cleared = true;
+      }
+      LookupVideo(lookup, m_stop);
+    }
+    return true;
+  }
+
+private:
+  VideoLookupQueue &m_queue;
+  const bool &m_stop;
+  std::atomic<unsigned int> &m_remaining;
+  CEvent &m_done;
+  std::string m_cacheFolder;
+};
+}
+
 namespace VIDEO
 {
 
@@ -113,6 +238,11 @@ namespace VIDEO
       m_database.Open();
 
       m_bCanInterrupt = true;
+      m_prefetched.clear();
+      m_enumerateStage = StageStats();
+      m_lookupStage = StageStats();
+      m_databaseStage = StageStats();
+      WatchPaths(m_pathsToScan);
 
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Starting scan ..");
       ANNOUNCEMENT::CAnnouncementManager::GetInstance().Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanStarted");
@@ -148,6 +278,8 @@ namespace VIDEO
         }
         else if (!DoScan(directory))
           bCancelled = true;
+        else
+          MarkScanned(directory);
       }
 
       if (!bCancelled)
@@ -167,6 +299,10 @@ namespace VIDEO
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "VideoInfoScanner: Listed %u folders in %u ms (%.1f/s), looked up %u items ahead in %u ms (%.1f/s), stored %u items in %u ms (%.1f/s)",
+                m_enumerateStage.items, m_enumerateStage.millis, m_enumerateStage.GetRate(),
+                m_lookupStage.items, m_lookupStage.millis, m_lookupStage.GetRate(),
+                m_databaseStage.items, m_databaseStage.millis, m_databaseStage.GetRate());
     }
     catch (...)
     {
@@ -279,17 +415,24 @@ namespace VIDEO
       }
 
       std::string fastHash;
-      if (g_advancedSettings.m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
+      bool unchanged = IsUnchanged(strDirectory) && m_database.GetPathHash(strDirectory, dbHash) && !dbHash.empty();
+      if (!unchanged && g_advancedSettings.m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
         fastHash = GetFastHash(strDirectory, regexps);
 
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
+      if (unchanged)
+      { // no change was seen below the folder since it was scanned - no need to process anything
+        hash = dbHash;
+      }
+      else if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
       { // fast hashes match - no need to process anything
         hash = fastHash;
       }
       else
       { // need to fetch the folder
+        unsigned int tick = XbmcThreads::SystemClockMillis();
         CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions());
         items.Stack();
+        m_enumerateStage.Add(1, XbmcThreads::SystemClockMillis() - tick);
 
         // check whether to re-use previously computed fast hash
         if (!CanFastHash(items, regexps) || fastHash.empty())
@@ -326,7 +469,9 @@ namespace VIDEO
 
       if (foundDirectly && !settings.parent_name_root)
       {
+        unsigned int tick = XbmcThreads::SystemClockMillis();
         CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions());
+        m_enumerateStage.Add(1, XbmcThreads::SystemClockMillis() - tick);
         items.SetPath(strDirectory);
         GetPathHash(items, hash);
         bSkip = true;
@@ -347,6 +492,9 @@ namespace VIDEO
 
     if (!bSkip)
     {
+      MarkChanged(strDirectory);
+      if (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS)
+        PrefetchVideoInfo({ PrefetchFolder{ &items, settings.parent_name_root } }, true);
       if (RetrieveVideoInfo(items, settings.parent_name_root, content))
       {
         if (!m_bStop && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
@@ -372,6 +520,7 @@ namespace VIDEO
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    int prefetchedFolders = 0;
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -383,6 +532,11 @@ namespace VIDEO
       // do not recurse for tv shows - we have already looked recursively for episodes
       if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() && settings.recurse > 0 && content != CONTENT_TVSHOWS)
       {
+        // most libraries keep every movie in a folder of its own, so the
+        // lookups of the next subfolders are run together
+        if (i >= prefetchedFolders)
+          prefetchedFolders = PrefetchSubfolders(items, i);
+
         if (!DoScan(pItem->GetPath()))
         {
           m_bStop = true;
@@ -497,6 +651,177 @@ namespace VIDEO
     return FoundSomeInfo;
   }
 
+  int CVideoInfoScanner::PrefetchSubfolders(const CFileItemList& items, int start)
+  {
+    // enough folders to keep the jobs busy, few enough to not hold back
+    // the database updates of the first ones for long
+    const size_t maxFolders = 4 * g_advancedSettings.m_iVideoScannerScraperJobs;
+
+    std::vector<std::unique_ptr<CFileItemList>> listings;
+    std::vector<PrefetchFolder> folders;
+    int i = start;
+    for (; i < items.Size() && folders.size() < maxFolders && !m_bStop; ++i)
+    {
+      const CFileItemPtr &pItem = items[i];
+      if (!pItem->m_bIsFolder || pItem->IsParentFolder() || pItem->IsPlayList())
+        continue;
+
+      const std::string &path = pItem->GetPath();
+      if (IsExcluded(path, g_advancedSettings.m_moviesExcludeFromScanRegExps) || IsUnchanged(path))
+        continue;
+
+      SScanSettings settings;
+      ScraperPtr info = m_database.GetScraperForPath(path, settings);
+      if (!info || (info->Content() != CONTENT_MOVIES && info->Content() != CONTENT_MUSICVIDEOS) ||
+          (!m_scanAll && settings.noupdate))
+        continue;
+
+      // same hash checks as DoScan(), folders it will skip need no listing
+      std::string dbHash, fastHash;
+      m_database.GetPathHash(path, dbHash);
+      if (!dbHash.empty() && g_advancedSettings.m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(path))
+      {
+        fastHash = GetFastHash(path, g_advancedSettings.m_moviesExcludeFromScanRegExps);
+        if (!fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
+          continue;
+      }
+
+      // DoScan() lists the folder again, which is cheap next to a scraper lookup
+      unsigned int tick = XbmcThreads::SystemClockMillis();
+      std::unique_ptr<CFileItemList> listing(new CFileItemList);
+      CDirectory::GetDirectory(path, *listing, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions());
+      listing->Stack();
+      m_enumerateStage.Add(1, XbmcThreads::SystemClockMillis() - tick);
+
+      std::string hash;
+      if (!CanFastHash(*listing, g_advancedSettings.m_moviesExcludeFromScanRegExps) || fastHash.empty())
+        GetPathHash(*listing, hash);
+      else
+        hash = fastHash;
+      if (hash.empty() || StringUtils::EqualsNoCase(hash, dbHash))
+        continue;
+
+      folders.push_back(PrefetchFolder{ listing.get(), settings.parent_name_root });
+      listings.push_back(std::move(listing));
+    }
+
+    PrefetchVideoInfo(folders, true);
+    return i;
+  }
+
+  void CVideoInfoScanner::PrefetchVideoInfo(const std::vector<PrefetchFolder>& folders, bool useLocal)
+  {
+    std::map<std::string, VideoLookupQueue> queues;
+    for (const auto &folder : folders)
+    {
+      const CFileItemList &items = *folder.items;
+      for (int i = 0; i < items.Size(); ++i)
+      {
+        const CFileItemPtr &pItem = items[i];
+        if (pItem->m_bIsFolder || !pItem->IsVideo() || pItem->IsNFO() ||
+           (pItem->IsPlayList() && !URIUtils::HasExtension(pItem->GetPath(), ".strm")))
+          continue;
+
+        if (IsExcluded(pItem->GetPath(), g_advancedSettings.m_moviesExcludeFromScanRegExps))
+          continue;
+
+        // already looked up along with the subfolders of the parent folder
+        if (m_prefetched.find(pItem->GetPath()) != m_prefetched.end())
+          continue;
+
+        ScraperPtr scraper = m_database.GetScraperForPath(items.GetPath());
+        if (!scraper)
+          continue;
+
+        if (scraper->Content() == CONTENT_MOVIES)
+        {
+          if (m_database.HasMovieInfo(pItem->GetPath()))
+            continue;
+        }
+        else if (scraper->Content() == CONTENT_MUSICVIDEOS)
+        {
+          if (m_database.HasMusicVideoInfo(pItem->GetPath()))
+            continue;
+        }
+        else
+          continue;
+
+        VideoLookup lookup;
+        lookup.item = pItem;
+        lookup.scraper = scraper;
+        lookup.dirNames = folder.dirNames;
+        lookup.useLocal = useLocal;
+        queues[scraper->ID()].lookups.push_back(std::move(lookup));
+      }
+    }
+
+    unsigned int count = 0;
+    unsigned int jobs = 0;
+    for (const auto &queue : queues)
+    {
+      count += queue.second.lookups.size();
+      jobs += std::min<size_t>(g_advancedSettings.m_iVideoScannerScraperJobs, queue.second.lookups.size());
+    }
+    if (count < 2 || jobs < 2)
+      return;
+
+    unsigned int tick = XbmcThreads::SystemClockMillis();
+    std::atomic<unsigned int> remaining(jobs);
+    CEvent done;
+    for (auto &queue : queues)
+    {
+      size_t queueJobs = std::min<size_t>(g_advancedSettings.m_iVideoScannerScraperJobs, queue.second.lookups.size());
+      for (size_t i = 0; i < queueJobs; i++)
+      {
+        CVideoLookupJob *job = new CVideoLookupJob(queue.second, i, m_bStop, remaining, done);
+        if (!CJobManager::GetInstance().AddJob(job, nullptr, CJob::PRIORITY_NORMAL))
+        {
+          // job manager is shutting down, do the work ourselves
+          job->DoWork();
+          delete job;
+        }
+      }
+    }
+    // the jobs reference our stack, so wait for them even if we are stopped
+    done.Wait();
+    m_lookupStage.Add(count, XbmcThreads::SystemClockMillis() - tick);
+
+    for (auto &queue : queues)
+    {
+      for (auto &lookup : queue.second.lookups)
+      {
+        PrefetchedInfo &info = m_prefetched[lookup.item->GetPath()];
+        info.found = lookup.found;
+        info.details = lookup.details;
+      }
+    }
+    CLog::Log(LOGDEBUG, "VideoInfoScanner: Looked up %u items of %u folders in %u ms with %u jobs",
+              count, static_cast<unsigned int>(folders.size()), XbmcThreads::SystemClockMillis() - tick, jobs);
+  }
+
+  CInfoScanner::INFO_RET CVideoInfoScanner::AddPrefetchedVideo(CFileItem *pItem, const CONTENT_TYPE &content, bool bDirNames, bool useLocal)
+  {
+    std::map<std::string, PrefetchedInfo>::iterator prefetched = m_prefetched.find(pItem->GetPath());
+    if (prefetched == m_prefetched.end())
+      return INFO_NOT_FOUND;
+
+    PrefetchedInfo info = std::move(prefetched->second);
+    m_prefetched.erase(prefetched);
+    if (info.found == 0)
+      return INFO_NOT_FOUND;
+
+    if (info.found < 0)
+    { // scraper reported an error, which was already shown to the user
+      m_bStop = true;
+      return INFO_CANCELLED;
+    }
+
+    *pItem->GetVideoInfoTag() = info.details;
+    if (AddVideo(pItem, content, bDirNames, useLocal) < 0)
+      return INFO_ERROR;
+    return INFO_ADDED;
+  }
+
   CInfoScanner::INFO_RET
   CVideoInfoScanner::RetrieveInfoForTvShow(CFileItem *pItem,
                                            bool bDirNames,
@@ -632,6 +957,10 @@ namespace VIDEO
     if (m_handle)
       m_handle->SetText(pItem->GetMovieName(bDirNames));
 
+    INFO_RET prefetched = AddPrefetchedVideo(pItem, info2->Content(), bDirNames, useLocal);
+    if (prefetched != INFO_NOT_FOUND)
+      return prefetched;
+
     CInfoScanner::INFO_TYPE result = CInfoScanner::NO_NFO;
     CScraperUrl scrUrl;
     // handle .nfo files
@@ -711,6 +1040,10 @@ namespace VIDEO
     if (m_handle)
       m_handle->SetText(pItem->GetMovieName(bDirNames));
 
+    INFO_RET prefetched = AddPrefetchedVideo(pItem, info2->Content(), bDirNames, useLocal);
+    if (prefetched != INFO_NOT_FOUND)
+      return prefetched;
+
     CInfoScanner::INFO_TYPE result = CInfoScanner::NO_NFO;
     CScraperUrl scrUrl;
     // handle .nfo files
@@ -846,6 +1179,8 @@ namespace VIDEO
         if (item->HasProperty("hash"))
           hash = item->GetProperty("hash").asString();
       }
+      else if (IsUnchanged(item->GetPath()) && m_database.GetPathHash(item->GetPath(), dbHash))
+        hash = dbHash; // no change was seen below the show since it was scanned
       else if (g_advancedSettings.m_bVideoLibraryUseFastHash)
         hash = GetRecursiveFastHash(item->GetPath(), regexps);
 
@@ -885,6 +1220,7 @@ namespace VIDEO
         return false;
       }
 
+      MarkChanged(item->GetPath());
       if (dbHash.empty())
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Scanning dir '%s' as not in the database", CURL::GetRedacted(item->GetPath()).c_str());
       else
@@ -1277,6 +1613,8 @@ namespace VIDEO
     if (!libraryImport)
       GetArtwork(pItem, content, videoFolder, useLocal && !pItem->IsPlugin(), showInfo ? showInfo->m_strPath : "");
 
+    unsigned int tick = XbmcThreads::SystemClockMillis();
+
     // ensure the art map isn't completely empty by specifying an empty thumb
     std::map<std::string, std::string> art = pItem->GetArt();
     if (art.empty())
@@ -1387,6 +1725,7 @@ namespace VIDEO
     }
 
     m_database.Close();
+    m_databaseStage.Add(1, XbmcThreads::SystemClockMillis() - tick);
 
     CFileItemPtr itemCopy = CFileItemPtr(new CFileItem(*pItem));
     CVariant data;
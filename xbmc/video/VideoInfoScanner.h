@@ -19,6 +19,7 @@
  *
  */
 
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -122,6 +123,37 @@ namespace VIDEO
     INFO_RET RetrieveInfoForMusicVideo(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForEpisodes(CFileItem *item, long showID, const ADDON::ScraperPtr &scraper, bool useLocal, CGUIDialogProgress *progress = NULL);
 
+    /*! \brief A folder listing whose items are looked up ahead
+     */
+    struct PrefetchFolder
+    {
+      const CFileItemList *items;
+      bool dirNames; ///< whether folder or file names are used for lookups
+    };
+
+    /*! \brief Look up the details of the movies or music videos of some folders ahead of adding them.
+     The nfo files and scrapers of several items are queried concurrently, with at most
+     <videoscanner><scraperjobs> lookups in flight per scraper, each using its own scraper
+     cache folder. Items that could not be looked up are retried by RetrieveVideoInfo() the
+     usual way.
+     \param folders the folder listings.
+     \param useLocal whether local data (.nfo files) should be used.
+     */
+    void PrefetchVideoInfo(const std::vector<PrefetchFolder>& folders, bool useLocal);
+
+    /*! \brief Look up the items of the next few movie or music video subfolders of a folder ahead of scanning them.
+     \param items the folder listing.
+     \param start the index of the first subfolder to look at.
+     \return the index of the first item that was not looked at.
+     */
+    int PrefetchSubfolders(const CFileItemList& items, int start);
+
+    /*! \brief Add an item to the database using the details found by PrefetchVideoInfo().
+     \return INFO_NOT_FOUND if no details were looked up ahead for the item, otherwise
+     INFO_ADDED, INFO_ERROR or INFO_CANCELLED if the scraper reported an error.
+     */
+    INFO_RET AddPrefetchedVideo(CFileItem *pItem, const CONTENT_TYPE &content, bool bDirNames, bool useLocal);
+
     /*! \brief Update the progress bar with the heading and line and check for cancellation
      \param progress CGUIDialogProgress bar
      \param heading string id of heading
@@ -243,6 +275,16 @@ namespace VIDEO
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+
+    struct PrefetchedInfo
+    {
+      int found;             ///< >0 if details were found, <0 on a scraper error
+      CVideoInfoTag details;
+    };
+    std::map<std::string, PrefetchedInfo> m_prefetched; ///< details looked up ahead, by path
+    StageStats m_enumerateStage; ///< folders listed
+    StageStats m_lookupStage;    ///< items looked up ahead
+    StageStats m_databaseStage;  ///< items stored
   };
 }
 
@@ -32,6 +32,7 @@
 #include "Application.h"
 #include "VideoSyncDRM.h"
 
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
 #include "cores/RetroPlayer/process/X11/RPProcessInfoX11.h"
 #include "cores/RetroPlayer/rendering/VideoRenderers/RPRendererOpenGL.h"
 #include "cores/VideoPlayer/DVDCodecs/DVDFactoryCodec.h"
@@ -66,6 +67,10 @@ CWinSystemX11GLContext::CWinSystemX11GLContext()
   {
     X11::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "NULL"))
+  {
+    CAESinkNULL::Register();
+  }
   else
   {
     if (!X11::PulseAudioRegister())
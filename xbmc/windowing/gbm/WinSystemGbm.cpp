@@ -26,6 +26,7 @@
 #include <string.h>
 
 #include "OptionalsReg.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
 #include "guilib/GraphicContext.h"
 #include "powermanagement/linux/LinuxPowerSyscall.h"
 #include "settings/DisplaySettings.h"
@@ -57,6 +58,10 @@ CWinSystemGbm::CWinSystemGbm() :
   {
     GBM::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "NULL"))
+  {
+    CAESinkNULL::Register();
+  }
   else
   {
     if (!GBM::PulseAudioRegister())
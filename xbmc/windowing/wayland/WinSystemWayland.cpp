@@ -27,6 +27,7 @@
 
 #include "Application.h"
 #include "Connection.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
 #include "cores/RetroPlayer/process/wayland/RPProcessInfoWayland.h"
 #include "cores/VideoPlayer/Process/wayland/ProcessInfoWayland.h"
 #include "guilib/DispResource.h"
@@ -162,6 +163,10 @@ CWinSystemWayland::CWinSystemWayland()
   {
     ::WAYLAND::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "NULL"))
+  {
+    CAESinkNULL::Register();
+  }
   else
   {
     if (!::WAYLAND::PulseAudioRegister())
@@ -32,6 +32,7 @@
 #include "guilib/GUITextLayout.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/GUITexture.h"
 #include "GUIInfoManager.h"
 #include "ServiceBroker.h"
 #include "utils/Variant.h"
@@ -122,6 +123,10 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
                                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(),
                                 strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
 #endif
+    // without batching every quad is drawn on its own, so the quad count is
+    // the number of draw calls the same frame takes unbatched
+    const CGUISpriteBatch::Stats &batch = CGUITexture::GetBatchStats();
+    info += StringUtils::Format("\nGUI: %u quads in %u draw calls (%.2f ms)", batch.quads, batch.drawCalls, batch.submitTime);
   }
 
   // render the skin debug info
@@ -148,6 +153,8 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
       point.y *= g_graphicsContext.GetGUIScaleY();
       g_graphicsContext.SetRenderingResolution(g_graphicsContext.GetResInfo(), false);
     }
+    info += StringUtils::Format("Conditions: %u of %u evaluated\n", g_infoManager.GetInfoBoolEvaluations(),
+                                static_cast<unsigned int>(g_infoManager.GetInfoBoolCount()));
     info += StringUtils::Format("Mouse: (%d,%d)  ", static_cast<int>(point.x), static_cast<int>(point.y));
     if (window)
     {